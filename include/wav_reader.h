@@ -0,0 +1,30 @@
+#ifndef WAV_READER_H
+#define WAV_READER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Rendered-WAV playback for the visualiser (src/wav_reader.c). The step and
+ * event accessors read the seg_sidecar next to the WAV; event types are
+ * event_type_t from src/c/include/event_queue.h. */
+
+bool load_wav_file(const char *filename);
+void cleanup_audio_data(void);
+void print_audio_info(void);
+
+float get_audio_rms_for_frame(int frame);
+float get_audio_time_for_frame(int frame);
+float get_audio_duration(void);
+float get_audio_bpm(void);
+float get_max_rms(void);
+bool is_audio_finished(int frame);
+uint32_t get_audio_seed(uint32_t fallback);
+
+int get_audio_step(void);
+int get_audio_step_events(int step, int type);
+
+void start_audio_playback(void);
+void stop_audio_playback(void);
+float get_playback_position(void);
+
+#endif
@@ -4,36 +4,31 @@
 
 // -----------------------------------------------------------------------------
 // void delay_process_block(delay_t *d, float *L, float *R, uint32_t n, float feedback)
-//    x0 = delay_t* { float *buf; uint32_t size; uint32_t idx; }
+//    x0 = delay_t* { float *buf; uint32_t size; uint32_t idx; uint32_t layout; }
 //    x1 = L buffer
 //    x2 = R buffer
 //    w3 = n samples
 //    s0 = feedback amount
+// Run-split and planar paths written on x86-64 without an arm64 assembler:
+// not yet assembled or run (ASSEMBLY_BUILD_STATUS.md).
 // Stereo ping-pong delay: L feeds R, R feeds L
+//
+// The block is split at the ring's wrap point; each run is element-wise (no
+// slot is revisited within `size` frames), so it is processed four frames per
+// iteration with ld2/st2 (interleaved ring) or plain q loads (planar ring,
+// layout != 0: L ring at buf, R ring at buf + size), then a scalar tail.
+// Leaf function using only caller-saved registers: no stack frame.
 // -----------------------------------------------------------------------------
 _delay_process_block:
-    // Prologue – use 512-byte frame; save x27/x28 at offset #480 (512-64) giving
-    // the maximum distance LLDP allows (>=480 <=504) to avoid overlapping caller
-    // memory even in fast execution.
-    stp x29, x30, [sp, #-512]!
-    stp q8,  q9,  [sp, #112]
-    stp q10, q11, [sp, #144]
-    stp q12, q13, [sp, #176]
-    stp q14, q15, [sp, #208]
-    mov x29, sp
-    stp x19, x20, [sp, #16]
-    stp x21, x22, [sp, #32]
-    stp x23, x24, [sp, #48]
-    stp x25, x26, [sp, #64]
-    stp x27, x28, [sp, #480]
-
-    // Load struct members (buf,size,idx) into convenient regs
+    // Load struct members (buf,size,idx,layout) into convenient regs
     ldr x4, [x0]       // buf*
     ldr w5, [x0, #8]   // size
     ldr w6, [x0, #12]  // idx
+    ldr w7, [x0, #16]  // layout
 
-    // Early-out if n==0
+    // Early-out if n==0 or the ring is empty
     cbz w3, Ldone
+    cbz w5, Ldone
 
     // --- PRE-WRAP BUG FIX ----------------------------------------------------
     // Make absolutely sure idx is in range BEFORE first buffer access.
@@ -41,58 +36,104 @@ _delay_process_block:
     csel w6, wzr, w6, hs// if so wrap to 0
     // ------------------------------------------------------------------------
 
-    mov w7, wzr        // loop counter i
-
-Lloop:
-    // Break conditions
-    cmp w7, w3
-    b.hs Lstore_idx     // i >= n → exit loop
+    dup v0.4s, v0.s[0]          // feedback in every lane (s0 unchanged)
+    add x15, x4, w5, uxtw #2    // planar R ring = buf + size
 
-    // Calculate &buf[idx*2]
-    // (each sample is float = 4 bytes, stereo interleaved)
-    // addr = buf + idx*8
-    lsl w8, w6, #3      // w8 = idx*8
-    add x9, x4, x8      // x9 = &buf[idx*2]
+Lrun:
+    // run = min(size - idx, n); n -= run
+    sub w8, w5, w6
+    cmp w8, w3
+    csel w8, w3, w8, hi
+    sub w3, w3, w8
+    lsr w10, w8, #2     // four-frame groups
+    and w11, w8, #3     // tail frames
+    cbnz w7, Lplanar
 
-    // Load delayed samples
+    // ---- interleaved: x9 = &buf[idx*2] ----
+    add x9, x4, w6, uxtw #3
+    add w6, w6, w8      // idx += run
+    cbz w10, Li_tail
+Li_vec:
+    ld2 {v1.4s, v2.4s}, [x9]        // v1 = yl, v2 = yr
+    ldr q3, [x1]                    // dry L
+    ldr q4, [x2]                    // dry R
+    mov v5.16b, v3.16b
+    fmla v5.4s, v2.4s, v0.4s        // L + yr*feedback
+    mov v6.16b, v4.16b
+    fmla v6.4s, v1.4s, v0.4s        // R + yl*feedback
+    st2 {v5.4s, v6.4s}, [x9], #32
+    fadd v3.4s, v3.4s, v1.4s        // L = dryL + yl
+    fadd v4.4s, v4.4s, v2.4s        // R = dryR + yr
+    str q3, [x1], #16
+    str q4, [x2], #16
+    subs w10, w10, #1
+    b.ne Li_vec
+Li_tail:
+    cbz w11, Lnext
+Li_one:
     ldp s1, s2, [x9]    // s1 = yl, s2 = yr
-
-    // Load input samples (post-increment L/R ptrs)
-    ldr s3, [x1]        // L[i]
-    ldr s4, [x2]        // R[i]
-
-    // buf[idx*2]   = L + yr*feedback
+    ldr s3, [x1]
+    ldr s4, [x2]
     fmadd s5, s2, s0, s3
-    // buf[idx*2+1] = R + yl*feedback
     fmadd s6, s1, s0, s4
-    stp  s5, s6, [x9]
+    stp s5, s6, [x9], #8
+    fadd s3, s3, s1
+    fadd s4, s4, s2
+    str s3, [x1], #4
+    str s4, [x2], #4
+    subs w11, w11, #1
+    b.ne Li_one
+    b Lnext
 
-    // Add delayed signal to dry samples
-    fadd s3, s3, s1     // L[i] = dryL + yl
-    fadd s4, s4, s2     // R[i] = dryR + yr
-    str  s3, [x1], #4   // write & advance L*
-    str  s4, [x2], #4   // write & advance R*
+    // ---- planar: x9 = &bufL[idx], x12 = &bufR[idx] ----
+Lplanar:
+    add x9, x4, w6, uxtw #2
+    add x12, x15, w6, uxtw #2
+    add w6, w6, w8      // idx += run
+    cbz w10, Lp_tail
+Lp_vec:
+    ldr q1, [x9]                    // yl
+    ldr q2, [x12]                   // yr
+    ldr q3, [x1]
+    ldr q4, [x2]
+    mov v5.16b, v3.16b
+    fmla v5.4s, v2.4s, v0.4s
+    mov v6.16b, v4.16b
+    fmla v6.4s, v1.4s, v0.4s
+    str q5, [x9], #16
+    str q6, [x12], #16
+    fadd v3.4s, v3.4s, v1.4s
+    fadd v4.4s, v4.4s, v2.4s
+    str q3, [x1], #16
+    str q4, [x2], #16
+    subs w10, w10, #1
+    b.ne Lp_vec
+Lp_tail:
+    cbz w11, Lnext
+Lp_one:
+    ldr s1, [x9]
+    ldr s2, [x12]
+    ldr s3, [x1]
+    ldr s4, [x2]
+    fmadd s5, s2, s0, s3
+    fmadd s6, s1, s0, s4
+    str s5, [x9], #4
+    str s6, [x12], #4
+    fadd s3, s3, s1
+    fadd s4, s4, s2
+    str s3, [x1], #4
+    str s4, [x2], #4
+    subs w11, w11, #1
+    b.ne Lp_one
 
-    // Increment and wrap idx
-    add w6, w6, #1
+Lnext:
+    // Wrap idx at the end of the ring and continue with the rest of the block
     cmp w6, w5
     csel w6, wzr, w6, hs
+    cbnz w3, Lrun
 
-    // Next sample
-    add w7, w7, #1
-    b    Lloop
-
-Lstore_idx:
     // Store updated idx back to struct
     str w6, [x0, #12]
 
 Ldone:
-    // Epilogue – mirror prologue order
-    ldp x27, x28, [sp, #480]
-    ldp q14, q15, [sp, #208]
-    ldp q12, q13, [sp, #176]
-    ldp q10, q11, [sp, #144]
-    ldp q8,  q9,  [sp, #112]
-    ldp x29, x30, [sp]
-    add sp, sp, #512
-    ret
\ No newline at end of file
+    ret
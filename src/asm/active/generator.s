@@ -2,12 +2,16 @@
 	.align 2
 	.globl _generator_mix_buffers_asm
 
-// Assembly stubs – we override only generator_process; keep C generator_init
-	.globl _generator_process
+// Field offsets last updated on x86-64 without an arm64 assembler: not yet
+// assembled or run (ASSEMBLY_BUILD_STATUS.md).
+// Assembly stubs – we override only the per-block body of generator_process;
+// keep C generator_init and the chunking generator_process wrapper
+	.globl _generator_render_block_asm
 	// (no _generator_init symbol here; C version remains)
 
-_generator_process:
-	// Args: x0 = g, x1 = L, x2 = R, w3 = num_frames
+_generator_render_block_asm:
+	// Args: x0 = g, x1 = L, x2 = R, w3 = num_frames (<= GEN_MAX_BLOCK),
+	//       x4 = scratch arena (generator_scratch(g), 64-byte aligned, 4*GEN_MAX_BLOCK floats)
 
 	// Prologue – save frame pointer & callee-saved regs (x19-x22)
 	stp x29, x30, [sp, #-128]!   // reserve 128-byte fixed frame (was 96)
@@ -32,16 +36,10 @@ _generator_process:
 	mov x21, x3            // x21 = num_frames (32-bit valid)
 
 	// ---------------------------------------------------------------------
-	// Allocate contiguous scratch block on heap instead of stack
-	// scratch_size = (num_frames * 16 + 15) & ~15      // 16-byte alignment
-	lsl x22, x21, #4       // x22 = num_frames * 16  (bytes for 4 buffers)
-	add x22, x22, #15
-	bic x22, x22, #15      // align to 16 bytes
-
-	// malloc(scratch_size)
-	mov x0, x22
-	bl _malloc
-	mov x25, x0            // x25 = Ld base (scratch start)
+	// Scratch sub-mix buffers live in the generator's preallocated arena
+	// (no allocation on the audio thread).  The C wrapper guarantees
+	// num_frames <= GEN_MAX_BLOCK so four buffers always fit.
+	mov x25, x4            // x25 = Ld base (scratch start)
 
 	// bytes_per_buffer = num_frames * 4
 	lsl x5, x21, #2        // x5 = bytes per buffer
@@ -71,9 +69,8 @@ _generator_process:
 
 	// Register assignments:
 	//   x24 = g (generator*) – set now
-	// Use x10 as pointer to timing/event fields (base = g + 4352)
-	add x10, x24, #0x1000    // x10 = g + 4096
-	add x10, x10, #0x128     // +296 => g + 4392 (event_idx)
+	// Use x10 as pointer to timing/event fields
+	add x10, x24, #0xd8      // x10 = g + 216 (event_idx, checked in generator.c)
 
 	ldr w9, [x24, #12]      // w9 = step_samples (offset 12 bytes)
 	ldr w8, [x10, #8]       // w8 = pos_in_step (event base + 8)
@@ -116,8 +113,7 @@ _generator_process:
 
 .Lgp_trigger_skip:
 	// Recompute event/state base pointer after external calls may clobber x10
-	add x10, x24, #0x1000
-	add x10, x10, #0x128    // x10 = &g->event_idx
+	add x10, x24, #0xd8    // x10 = &g->event_idx
 	ldr w9, [x24, #12]
 
 	// Reload constant step_samples in case caller-saved w9 was clobbered
@@ -169,8 +165,7 @@ _generator_process:
 	ldp x21, x22, [sp, #96]     // restore w21, x22 (sp unchanged)
 
 	// Recompute event/state base pointer after _generator_process_voices (x10 may be clobbered)
-	add x10, x24, #0x1000
-	add x10, x10, #0x128    // x10 = &g->event_idx
+	add x10, x24, #0xd8    // x10 = &g->event_idx
 
 	// Restore w11 from x22 after helper
 	mov w11, w22               // restore frames_to_process
@@ -286,8 +281,7 @@ _generator_process:
 	// Advance counters
 	add w8, w8, w11              // pos_in_step += frames_to_process
     // write back updated pos_in_step to struct
-    add x10, x24, #0x1000
-    add x10, x10, #0x128   // correct base for event/state block (g + 4392)
+    add x10, x24, #0xd8   // x10 = &g->event_idx
     str w8, [x10, #8]
 	sub w21, w21, w11            // frames_rem  -= frames_to_process
 	add w23, w23, w11            // frames_done += frames_to_process
@@ -299,8 +293,7 @@ _generator_process:
 	// Boundary reached – reset pos_in_step and advance step
 	mov w8, wzr
 	// Recompute event/state base pointer again (x10 may be clobbered by helpers)
-	add x10, x24, #0x1000
-	add x10, x10, #0x128   // x10 = &g->event_idx
+	add x10, x24, #0xd8   // x10 = &g->event_idx
 	str w8, [x10, #8]       // write back pos_in_step = 0 to generator struct
 	ldr w12, [x10, #4]        // w12 = step (event base + 4)
 	add w12, w12, #1
@@ -315,9 +308,7 @@ _generator_process:
 	// Store updated pos_in_step back
 	str w8, [x10, #8]
 
-	// Deallocate scratch (free)
-	mov x0, x25
-	bl _free
+	// Scratch arena is owned by the generator – nothing to release
 
 	// TEMP BYPASS delay & limiter for debug RMS (define DEBUG_SKIP_POST_DSP)
 	#ifdef DEBUG_SKIP_POST_DSP
@@ -333,9 +324,8 @@ _generator_process:
 	// Prepare arguments for delay_process_block
 	// x24 = g (preserved), x19 = L buffer, x20 = R buffer, w23 = total num_frames
 
-	// x0 = &g->delay  (offset 4408 bytes)
-	add x0, x24, #4096        // base offset
-	add x0, x0, #312          // 4096 + 312 = 4408
+	// x0 = &g->delay  (offset 232 bytes, checked in generator.c)
+	add x0, x24, #232
 	mov x1, x19               // L
 	mov x2, x20               // R
 	mov w3, w23               // n = num_frames
@@ -347,9 +337,8 @@ _generator_process:
 
     #ifndef SKIP_LIMITER
     // Prepare arguments for limiter_process
-    // x0 = &g->limiter (offset 4424 bytes)
-    add x0, x24, #4096        // base offset
-    add x0, x0, #328          // 4096 + 328 = 4424
+    // x0 = &g->limiter (offset 256 bytes, checked in generator.c)
+    add x0, x24, #256
     mov x1, x19               // L
     mov x2, x20               // R
     mov w3, w23               // n = num_frames
@@ -359,7 +348,7 @@ _generator_process:
 	// Existing epilogue label below handles register restore and return
 
 .Lgp_epilogue:
-	// Early-exit path: deallocate scratch skipped (not allocated)
+	// Shared exit path
 	ldp x27, x28, [x29, #80]
 	ldp x25, x26, [x29, #64]
 	ldp x23, x24, [x29, #48]
@@ -703,6 +692,8 @@ _generator_rotate_pattern_asm:
  *                                  uint32_t step_samples);
  *
  * Converts the event queue building loop from C to assembly for ultimate performance.
+ * The queue must already be set up with eq_init(); run eq_build_index()
+ * afterwards.  Events past q->capacity are dropped (no realloc here).
  * This is the final orchestration step - building the complete musical timeline.
  *
  * Event generation rules:
@@ -728,8 +719,8 @@ _generator_build_events_asm:
 	stp x25, x26, [sp, #48]
 	stp x27, x28, [sp, #64]
 	
-	// Initialize event queue: q->count = 0
-	str wzr, [x0, #4096]        // q->count = 0 (events array is 4096 bytes)
+	// Initialize event queue: q->count = 0 (caller has run eq_init)
+	str wzr, [x0, #8]           // q->count = 0
 	
 	// Register assignments for loop
 	mov x19, x0                 // x19 = q (event queue)
@@ -868,26 +859,29 @@ _generator_build_events_asm:
  */
 	.globl _generator_eq_push_helper_asm
 _generator_eq_push_helper_asm:
-	// Load current count
-	ldr w12, [x19, #4096]       // w12 = q->count
+	// Load current count and capacity
+	ldr w12, [x19, #8]          // w12 = q->count
+	ldr w13, [x19, #12]         // w13 = q->capacity
 	
-	// Check if count < MAX_EVENTS (512)
-	cmp w12, #512
-	b.ge .Leq_push_ret          // Skip if queue full
+	// Check if count < capacity (the C eq_push grows the array; this one drops)
+	cmp w12, w13
+	b.hs .Leq_push_ret          // Skip if queue full
 	
 	// Calculate event address: &q->events[count]
-	mov w13, #8                 // sizeof(event_t) = 8 bytes
-	mul w14, w12, w13           // w14 = count * sizeof(event_t)
-	add x15, x19, w14, uxtw     // x15 = &q->events[count]
+	ldr x15, [x19]              // x15 = q->events
+	add w14, w12, w12, lsl #1   // w14 = count * 3
+	add x15, x15, w14, uxtw #2  // x15 = &q->events[count] (sizeof(event_t) = 12)
 	
-	// Store event: {time, type, aux, padding}
+	// Store event: {time, type, aux, variant, freq}
 	str w6, [x15]               // event.time = time
 	strb w10, [x15, #4]         // event.type = type
 	strb w11, [x15, #5]         // event.aux = aux
+	strb wzr, [x15, #6]         // event.variant = 0 (resolved later in C)
+	str  wzr, [x15, #8]         // event.freq = 0
 	
 	// Increment count
 	add w12, w12, #1
-	str w12, [x19, #4096]       // q->count++
+	str w12, [x19, #8]          // q->count++
 	
 .Leq_push_ret:
 	ret
@@ -3,9 +3,10 @@
 #include <string.h>
 #include <math.h>
 #include "../include/visual_types.h"
+#include "../include/wav_reader.h"
+#include "event_queue.h"
 
 #define MAX_BASS_HITS 16
-#define STEPS_PER_BEAT 4
 
 // Bass hit shape types (matching Python reference)
 typedef enum {
@@ -246,11 +247,16 @@ static void draw_ascii_square(uint32_t *pixels, int cx, int cy, int size, float
 void update_bass_hits(float elapsed_ms, float step_sec, float base_hue, uint32_t seed) {
     if (!bass_hits_initialized) return;
     
-    // Calculate current step for bass hit timing
-    int current_step = (int)(elapsed_ms / 1000.0f / step_sec) % 32;
+    // Calculate current step for bass hit timing (playback position with a
+    // sidecar, else the clock)
+    int current_step = get_audio_step();
+    if (current_step < 0) current_step = (int)(elapsed_ms / 1000.0f / step_sec) % 32;
     
-    // Spawn bass hit every 8 beats (2 bars) - matching Python: current_step % (STEPS_PER_BEAT*8) == 0
-    if (current_step % (STEPS_PER_BEAT * 8) == 0 && current_step != last_bass_step) {
+    // Spawn bass hit on the sidecar's FM bass notes, else every 8 beats (2 bars)
+    // - matching Python: current_step % (STEPS_PER_BEAT*8) == 0
+    int bass_events = get_audio_step_events(current_step, EVT_FM_BASS);
+    bool bass_step = bass_events >= 0 ? bass_events > 0 : current_step % (int)(STEPS_PER_BEAT * 8) == 0;
+    if (bass_step && current_step != last_bass_step) {
         last_bass_step = current_step;
         spawn_bass_hit(base_hue, seed + current_step);
     }
@@ -0,0 +1,21 @@
+#ifndef AUDIO_BACKEND_H
+#define AUDIO_BACKEND_H
+
+#include "coreaudio.h"
+
+/* One output backend behind coreaudio.h.  src/audio.c forwards the public
+ * calls to the selected table; each backend file defines its own, and the
+ * Makefile compiles audio.c with AUDIO_HAVE_COREAUDIO / AUDIO_HAVE_SDL for
+ * the ones it links.  get_stats may be NULL (no timing to report). */
+typedef struct {
+    int  (*init)(uint32_t sr, uint32_t buffer_size, audio_callback_t callback, void *user_data);
+    void (*start)(void);
+    void (*stop)(void);
+    int  (*get_stats)(audio_stats_t *stats);
+} audio_backend_ops_t;
+
+extern const audio_backend_ops_t audio_backend_coreaudio;   /* src/coreaudio.c */
+extern const audio_backend_ops_t audio_backend_sdl;         /* src/audio_sdl.c */
+extern const audio_backend_ops_t audio_backend_null;        /* src/audio_null.c */
+
+#endif /* AUDIO_BACKEND_H */
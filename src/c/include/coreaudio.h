@@ -13,6 +13,57 @@
  */
 typedef void (*audio_callback_t)(float* buffer, uint32_t num_frames, void* user_data);
 
+/*
+ * Output backends (audio_backend.h).  audio_init opens the one picked with
+ * audio_select, else the one named by NDB_AUDIO (coreaudio|sdl|null), else
+ * the first built in: CoreAudio on macOS, SDL2 audio elsewhere, then null.
+ * The null backend has no device: a thread calls the callback on a clock
+ * of its own, paced to the sample rate or as fast as it can, optionally
+ * writes what it gets to a float WAV, and records timing (audio_get_stats).
+ */
+typedef enum {
+    AUDIO_BACKEND_COREAUDIO = 0,
+    AUDIO_BACKEND_SDL,
+    AUDIO_BACKEND_NULL,
+    AUDIO_BACKEND_COUNT
+} audio_backend_id_t;
+
+/* Picks the backend for the next audio_init; -1 if it is not built in. */
+int audio_select(audio_backend_id_t id);
+int audio_backend_available(audio_backend_id_t id);
+audio_backend_id_t audio_backend(void);   /* the one in use or next to open */
+const char *audio_backend_name(audio_backend_id_t id);
+audio_backend_id_t audio_backend_from_name(const char *name);   /* COUNT if unknown */
+
+/*
+ * Null backend options, read at audio_init.  sink_path: WAV file to write
+ * the output to, NULL for none (default NDB_AUDIO_SINK).  paced: 1 sleeps
+ * until each buffer is due like a device would; 0 calls back-to-back, the
+ * clock advancing one buffer per call, to measure headroom quickly.
+ */
+void audio_null_configure(const char *sink_path, int paced);
+
+/*
+ * Callback timing from the null backend.  Buffer k is due to start at
+ * k * period on its clock and must be finished by (k + 1) * period, when
+ * the simulated device needs it.  Jitter is how late a callback started;
+ * a miss is a callback finishing past its deadline (an underrun on a
+ * device), after which the clock restarts from the late finish.
+ */
+typedef struct {
+    uint64_t callbacks;
+    uint64_t frames;
+    uint64_t misses;
+    double period_us;        /* buffer length at the sample rate */
+    double jitter_mean_us;
+    double jitter_max_us;
+    double callback_mean_us;
+    double callback_max_us;
+} audio_stats_t;
+
+/* 0 and the stats so far for the null backend, -1 for a device backend. */
+int audio_get_stats(audio_stats_t *stats);
+
 /*
  * Initializes the audio playback system.
  *
@@ -31,4 +82,4 @@ void audio_start(void);
 /* Stops playback and cleans up resources. */
 void audio_stop(void);
 
-#endif /* COREAUDIO_H */ 
\ No newline at end of file
+#endif /* COREAUDIO_H */
@@ -4,19 +4,39 @@
 #include <stdint.h>
 #include <string.h>
 
+/* Ring layout.  Both take size*2 floats of storage: interleaved keeps
+   L/R pairs (buf[idx*2], buf[idx*2+1]), planar keeps the L ring in
+   buf[0..size) and the R ring in buf[size..2*size), which the vector
+   kernels load without deinterleaving. */
+typedef enum {
+    DELAY_INTERLEAVED = 0,
+    DELAY_PLANAR
+} delay_layout_t;
+
+/* delay.s reads buf, size, idx and layout at offsets 0, 8, 12, 16 */
 typedef struct {
-    float32_t *buf;      /* interleaved stereo buffer, length = size*2 */
+    float32_t *buf;      /* stereo buffer, length = size*2 */
     uint32_t size;   /* delay in samples */
     uint32_t idx;    /* write/read index */
+    delay_layout_t layout;
 } delay_t;
 
-static inline void delay_init(delay_t *d, float32_t *storage, uint32_t size)
+static inline void delay_init_layout(delay_t *d, float32_t *storage, uint32_t size, delay_layout_t layout)
 {
-    d->buf = storage; d->size = size; d->idx = 0;
+    d->buf = storage; d->size = size; d->idx = 0; d->layout = layout;
     memset(d->buf, 0, sizeof(float32_t)*size*2);
 }
 
-/* Process block in-place (L and R arrays). */
+static inline void delay_init(delay_t *d, float32_t *storage, uint32_t size)
+{
+    delay_init_layout(d, storage, size, DELAY_INTERLEAVED);
+}
+
+/* Process block in-place (L and R arrays).  Ping-pong: L feeds the R ring
+   and R the L ring.  A slot is read and rewritten once per pass and not
+   revisited for `size` frames, so each run up to the wrap point is
+   element-wise; the kernels split the block there and process each run
+   with straight-line (vector) loads and stores. */
 void delay_process_block(delay_t *d, float32_t *L, float32_t *R, uint32_t n, float32_t feedback);
 
 #endif /* DELAY_H */ 
\ No newline at end of file
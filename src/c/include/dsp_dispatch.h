@@ -0,0 +1,108 @@
+#ifndef DSP_DISPATCH_H
+#define DSP_DISPATCH_H
+
+#include <stdint.h>
+#include "kick.h"
+#include "snare.h"
+#include "hat.h"
+#include "melody.h"
+#include "fm_voice.h"
+#include "fm_bank.h"
+#include "delay.h"
+#include "limiter.h"
+#include "osc.h"
+#include "wavetable.h"
+#include "resampler.h"
+#include "pcm.h"
+#include "rand.h"
+
+/* Runtime kernel selection.
+ *
+ * x86-64 builds link every voice/effect kernel once per instruction-set
+ * level and route the public entry points (kick_process, kick_skip,
+ * delay_process_block, osc_sine_block, noise_block, ...) through `g_dsp`.  dsp_dispatch_init()
+ * picks the widest level the CPU supports; the NDB_DSP environment variable
+ * (scalar|sse41|avx2|avx512) or dsp_dispatch_select() overrides it for
+ * A/B runs.  Until one of them runs, `g_dsp` holds the scalar kernels.
+ *
+ * arm64 builds link the hand-written NEON assembly (USE_ASM=1) directly and
+ * do not build this file, so there is no NEON level. */
+
+typedef enum {
+    DSP_LEVEL_SCALAR = 0,
+    DSP_LEVEL_SSE41,
+    DSP_LEVEL_AVX2,
+    DSP_LEVEL_AVX512,
+    DSP_LEVEL_COUNT
+} dsp_level_t;
+
+typedef struct {
+    void (*kick_process)(kick_t *k, float32_t *L, float32_t *R, uint32_t n);
+    void (*snare_process)(snare_t *s, float32_t *L, float32_t *R, uint32_t n);
+    void (*hat_process)(hat_t *h, float32_t *L, float32_t *R, uint32_t n);
+    void (*melody_process)(melody_t *m, float32_t *L, float32_t *R, uint32_t n);
+    void (*fm_voice_process)(fm_voice_t *v, float32_t *L, float32_t *R, uint32_t n);
+    /* State-only twins of the voice kernels (generator seeking/fast-forward) */
+    void (*kick_skip)(kick_t *k, uint32_t n);
+    void (*snare_skip)(snare_t *s, uint32_t n);
+    void (*hat_skip)(hat_t *h, uint32_t n);
+    void (*melody_skip)(melody_t *m, uint32_t n);
+    void (*fm_voice_skip)(fm_voice_t *v, uint32_t n);
+    /* Incremental-phasor FM (DSP_FM_PHASOR), src/fm_phasor_x86.c */
+    void (*fm_voice_phasor_process)(fm_voice_t *v, float32_t *L, float32_t *R, uint32_t n);
+    void (*fm_voice_phasor_skip)(fm_voice_t *v, uint32_t n);
+    void (*fm_bank_process)(fm_bank_t *b, float32_t *L, float32_t *R, uint32_t n);
+    void (*delay_process_block)(delay_t *d, float32_t *L, float32_t *R, uint32_t n, float32_t feedback);
+    void (*limiter_process)(limiter_t *l, float32_t *L, float32_t *R, uint32_t n);
+    void (*limiter_tp_process)(limiter_t *l, float32_t *L, float32_t *R, uint32_t n);
+    void (*osc_sine_block)(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float32_t sr);
+    void (*osc_saw_block)(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float32_t sr);
+    void (*osc_square_block)(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float32_t sr);
+    void (*osc_triangle_block)(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float32_t sr);
+    void (*noise_block)(rng_t *rng, float *out, uint32_t n);
+    void (*wavetable_block)(const float32_t *tab, uint32_t *phase, uint32_t inc, float32_t *out, uint32_t n);
+    uint32_t (*resampler_run)(resampler_t *r, float32_t *outL, float32_t *outR, uint32_t max);
+    void (*pcm_convert)(pcm_conv_t *c, const float *L, const float *R, uint32_t n, void *out);
+} dsp_kernels_t;
+
+extern dsp_kernels_t g_dsp;
+
+/* Detect the CPU and fill g_dsp (honours NDB_DSP).  Idempotent; call once
+ * from the main thread before any render threads start. */
+void dsp_dispatch_init(void);
+
+/* Force a level.  Returns 0 on success, -1 if it is not built in or the CPU
+ * lacks it (g_dsp is left unchanged). */
+int dsp_dispatch_select(dsp_level_t level);
+
+/* Widest level both compiled in and supported by this CPU. */
+dsp_level_t dsp_detect_level(void);
+int dsp_level_available(dsp_level_t level);
+dsp_level_t dsp_current_level(void);
+
+const char *dsp_level_name(dsp_level_t level);
+/* Parse a level name; returns DSP_LEVEL_COUNT if unknown. */
+dsp_level_t dsp_level_from_name(const char *name);
+
+/* FM voice model behind fm_voice_process/fm_voice_skip.
+ *
+ * DSP_FM_ARM is the shipping sound: rational envelope and Taylor sines,
+ * matching fm_voice.s.  DSP_FM_PHASOR is the exponential-envelope voice of
+ * attic/fm_voice_full.c rendered by the incremental-phasor kernel, which
+ * has no per-sample transcendental calls; the generator renders its FM
+ * pools in that model as fm_bank lanes.  The NDB_FM environment variable
+ * (arm|phasor) or dsp_fm_select() picks one; the choice holds across
+ * dsp_dispatch_select(). */
+typedef enum {
+    DSP_FM_ARM = 0,
+    DSP_FM_PHASOR,
+    DSP_FM_COUNT
+} dsp_fm_model_t;
+
+int dsp_fm_select(dsp_fm_model_t model);
+dsp_fm_model_t dsp_fm_current(void);
+const char *dsp_fm_name(dsp_fm_model_t model);
+/* Parse a model name; returns DSP_FM_COUNT if unknown. */
+dsp_fm_model_t dsp_fm_from_name(const char *name);
+
+#endif /* DSP_DISPATCH_H */
@@ -1,7 +1,9 @@
 #ifndef ENV_H
 #define ENV_H
 
+#include <stddef.h>
 #include <stdint.h>
+#include <math.h>
 
 /* Generate exponential decay envelope into `out[n]`.
  * Formula: exp(-rate * t) where t in seconds.
@@ -15,4 +17,45 @@ static inline float32_t env_exp_decay(float32_t t, float32_t decay_rate)
     return expf(-decay_rate * t);
 }
 
-#endif /* ENV_H */ 
\ No newline at end of file
+/* Per-sample factor of the same envelope, for voices that step it as a
+ * recurrence (env *= coef) instead of evaluating it. */
+static inline float32_t env_exp_coef(float32_t decay_rate, float32_t sr)
+{
+    return expf(-decay_rate / sr);
+}
+
+/* Shared envelope tables.
+ *
+ * Voices trigger with a handful of decay constants (the presets, the
+ * simple voice's 6.0), so rather than evaluating their envelope per sample
+ * they read it from a table holding env(pos / sr) for every pos, built the
+ * first time any voice asks for that (shape, decay, sr) and shared by all
+ * of them afterwards.  Entries hold exactly what the per-sample formula
+ * gives, so a voice reading a table renders bit-identically to one
+ * evaluating it.  Tables are built a power of two long and serve every
+ * length up to their own, so the few note lengths a tempo gives share one.
+ *
+ * env_table_get returns NULL for lengths over ENV_TABLE_MAX_LEN or once
+ * ENV_TABLE_SLOTS tables exist; the voice then falls back to stepping its
+ * envelope as a recurrence.  Lookups are lock-free and safe from any
+ * thread; the build takes a lock and runs once per table, so warm the
+ * tables before realtime use (generator_init does for its own voices).
+ * Tables live until env_table_clear. */
+typedef enum {
+    ENV_SHAPE_EXP = 0,     /* exp(-decay·t)     (simple voice) */
+    ENV_SHAPE_RATIONAL     /* 1 / (1 + decay·t) (fm_voice)     */
+} env_shape_t;
+
+#define ENV_TABLE_SLOTS   32
+#define ENV_TABLE_MAX_LEN (1u << 18)   /* ~5.9 s at 44.1 kHz, 1 MiB; a power of two */
+
+/* 64-byte aligned table of at least len entries, or NULL. */
+const float32_t *env_table_get(env_shape_t shape, float32_t decay, float32_t sr, uint32_t len);
+
+/* Bytes held by the tables built so far. */
+size_t env_table_bytes(void);
+
+/* Free every table.  No voice may still be holding one. */
+void env_table_clear(void);
+
+#endif /* ENV_H */
@@ -2,6 +2,7 @@
 #define EVENT_QUEUE_H
 
 #include <stdint.h>
+#include "music_time.h"
 
 /* Event types for the segment composer */
 typedef enum {
@@ -18,20 +19,42 @@ typedef struct {
     uint32_t time;   /* sample index at which to trigger */
     uint8_t  type;   /* event_type_t */
     uint8_t  aux;    /* optional small parameter (e.g. preset/freq index) */
+    /* Random choices resolved once at init (generator_resolve_events), so
+       firing an event never touches the RNG and any event can be replayed
+       on its own. */
+    uint8_t  variant;  /* FM bass preset */
+    float32_t freq;    /* note frequency (melody, mid, bass) */
 } event_t;
 
-#define MAX_EVENTS 512  /* adjust if needed */
+#define EQ_INITIAL_CAPACITY 512  /* grows by doubling past this */
 
+/* Events sorted by time, plus a CSR-style index: the events that fire at
+ * the start of step s are events[step_start[s] .. step_start[s+1]).  Fill
+ * with eq_push() in time order (ties keep push order, which is the order
+ * they fire and draw from the RNG), then eq_build_index().  The event
+ * array lives on the heap; release it with eq_free(). */
 typedef struct {
-    event_t events[MAX_EVENTS];
+    event_t *events;
     uint32_t count;
+    uint32_t capacity;
+    uint32_t step_samples;
+    uint32_t step_start[TOTAL_STEPS + 1];
 } event_queue_t;
 
-static inline void eq_init(event_queue_t *q){ q->count = 0; }
-static inline void eq_push(event_queue_t *q, uint32_t time, uint8_t type, uint8_t aux){
-    if(q->count < MAX_EVENTS){
-        q->events[q->count++] = (event_t){time, type, aux};
-    }
+/* Returns 0, or -1 if the event array could not be allocated. */
+int  eq_init(event_queue_t *q, uint32_t step_samples);
+void eq_free(event_queue_t *q);
+/* Append an event; returns 0, or -1 if the queue could not grow. */
+int  eq_push(event_queue_t *q, uint32_t time, uint8_t type, uint8_t aux);
+/* Sort (stable) by time if needed and rebuild step_start. */
+void eq_build_index(event_queue_t *q);
+
+/* O(1) seek: index of the first event at or after the start of `step`. */
+static inline uint32_t eq_step_begin(const event_queue_t *q, uint32_t step){
+    return q->step_start[step < TOTAL_STEPS ? step : TOTAL_STEPS];
+}
+static inline uint32_t eq_step_end(const event_queue_t *q, uint32_t step){
+    return q->step_start[step < TOTAL_STEPS ? step + 1 : TOTAL_STEPS];
 }
 
-#endif /* EVENT_QUEUE_H */ 
\ No newline at end of file
+#endif /* EVENT_QUEUE_H */
@@ -0,0 +1,505 @@
+// fast_math_x86.h – SSE2 / AVX2 helpers shared by the x86-64 voice kernels
+// (src/*_x86.c).  Mirrors fast_math_neon.h: everything is static inline so
+// each kernel compiles to straight-line vector code with no calls.
+//
+// Vector width follows the compiler's target flags for the translation unit:
+//   -mavx512f         → 16 lanes (__m512)
+//   -mavx2 -mfma      → 8 lanes (__m256)
+//   -msse4.1 / SSE2   → 4 lanes (__m128, SSE2 is part of the base ISA)
+//   -DX86_SIMD_SCALAR → 1 lane  (plain C loop, used as the speed baseline)
+//
+// The Makefile compiles every kernel once per level with
+// -DX86_KERNEL_SUFFIX=_<level>; X86_KFN() appends that suffix so all
+// variants link into one binary and dsp_dispatch.c picks one at startup.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define X86_CAT_(a, b) a##b
+#define X86_CAT(a, b)  X86_CAT_(a, b)
+#ifdef X86_KERNEL_SUFFIX
+#define X86_KFN(name) X86_CAT(name, X86_KERNEL_SUFFIX)
+#else
+#define X86_KFN(name) name
+#endif
+
+#if defined(__AVX512F__) && !defined(X86_SIMD_SCALAR)
+#define X86_SIMD_WIDTH 16
+#elif defined(__AVX2__) && !defined(X86_SIMD_SCALAR)
+#define X86_SIMD_WIDTH 8
+#elif defined(__SSE2__) && !defined(X86_SIMD_SCALAR)
+#define X86_SIMD_WIDTH 4
+#else
+#define X86_SIMD_WIDTH 1
+#endif
+
+#if X86_SIMD_WIDTH > 1
+#include <immintrin.h>
+#endif
+
+#define X86_TAU 6.2831853071795864769f
+#define X86_PI  3.14159265358979323846f
+
+/* SplitMix64 constants (see rand.h) */
+#define SM64_GAMMA 0x9E3779B97F4A7C15ULL
+#define SM64_MUL1  0xBF58476D1CE4E5B9ULL
+#define SM64_MUL2  0x94D049BB133111EBULL
+
+/* Geometric ramp {x*c, x*c^2, ..., x*c^W} – per-lane start of a
+ * multiplicative envelope (env *= coef applied before each sample). */
+static inline void x86_geom_ramp(float *out, float x, float c, int w)
+{
+    for (int j = 0; j < w; ++j) { x *= c; out[j] = x; }
+}
+
+#if X86_SIMD_WIDTH == 4
+/* ------------------------------------------------------------------ SSE2 */
+typedef __m128  vf_t;
+#define VF_SET1(x)      _mm_set1_ps(x)
+#define VF_LOAD(p)      _mm_loadu_ps(p)
+#define VF_STORE(p, v)  _mm_storeu_ps((p), (v))
+#define VF_ADD(a, b)    _mm_add_ps((a), (b))
+#define VF_SUB(a, b)    _mm_sub_ps((a), (b))
+#define VF_MUL(a, b)    _mm_mul_ps((a), (b))
+#define VF_DIV(a, b)    _mm_div_ps((a), (b))
+#define VF_MIN(a, b)    _mm_min_ps((a), (b))
+#define VF_MAX(a, b)    _mm_max_ps((a), (b))
+#define VF_GT(a, b)     _mm_cmpgt_ps((a), (b))
+#define VF_GE(a, b)     _mm_cmpge_ps((a), (b))
+#define VF_LT(a, b)     _mm_cmplt_ps((a), (b))
+#define VF_AND(a, b)    _mm_and_ps((a), (b))
+#define VF_MASK(m)      _mm_movemask_ps(m)
+/* int32 lanes (wrapping Q32 phase counters) and round-to-nearest */
+typedef __m128i vi_t;
+#define VI_SET1(x)      _mm_set1_epi32((int)(x))
+#define VI_LOAD(p)      _mm_loadu_si128((const __m128i *)(p))
+#define VI_STORE(p, v)  _mm_storeu_si128((__m128i *)(p), (v))
+#define VI_ADD(a, b)    _mm_add_epi32((a), (b))
+#define VI_TO_F(a)      _mm_cvtepi32_ps(a)
+#define VI_SRL(a, n)    _mm_srli_epi32((a), (n))
+#define VI_AND(a, b)    _mm_and_si128((a), (b))
+#define VF_ROUND(x)     _mm_cvtepi32_ps(_mm_cvtps_epi32(x))
+static inline vf_t vf_ramp(void) { return _mm_setr_ps(0.f, 1.f, 2.f, 3.f); }
+static inline float vf_hsum(vf_t v)
+{
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(v, _mm_shuffle_ps(v, v, 1)));
+}
+static inline float vf_last(vf_t v) { return _mm_cvtss_f32(_mm_shuffle_ps(v, v, 0xFF)); }
+static inline float vf_lane(vf_t v, int j) { float t[4]; _mm_storeu_ps(t, v); return t[j]; }
+static inline vf_t vf_abs(vf_t v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+/* p[idx[j]] per lane (no gather instruction before AVX2) */
+static inline vf_t vf_gather(const float *p, vi_t idx)
+{
+    return _mm_setr_ps(p[_mm_cvtsi128_si32(idx)], p[_mm_extract_epi32(idx, 1)],
+                       p[_mm_extract_epi32(idx, 2)], p[_mm_extract_epi32(idx, 3)]);
+}
+static inline vf_t vf_select(vf_t m, vf_t a, vf_t b)
+{
+#ifdef __SSE4_1__
+    return _mm_blendv_ps(b, a, m);
+#else
+    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+#endif
+}
+
+/* Low 64 bits of a*b for two u64 lanes; b_hi = b >> 32 precomputed. */
+static inline __m128i x86_mul64(__m128i a, __m128i b, __m128i b_hi)
+{
+    __m128i lo    = _mm_mul_epu32(a, b);
+    __m128i cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b),
+                                  _mm_mul_epu32(a, b_hi));
+    return _mm_add_epi64(lo, _mm_slli_epi64(cross, 32));
+}
+
+static inline __m128i x86_splitmix_mix(__m128i z)
+{
+    const __m128i m1 = _mm_set1_epi64x((long long)SM64_MUL1);
+    const __m128i m1h = _mm_set1_epi64x((long long)(SM64_MUL1 >> 32));
+    const __m128i m2 = _mm_set1_epi64x((long long)SM64_MUL2);
+    const __m128i m2h = _mm_set1_epi64x((long long)(SM64_MUL2 >> 32));
+    z = x86_mul64(_mm_xor_si128(z, _mm_srli_epi64(z, 30)), m1, m1h);
+    z = x86_mul64(_mm_xor_si128(z, _mm_srli_epi64(z, 27)), m2, m2h);
+    return _mm_xor_si128(z, _mm_srli_epi64(z, 31));
+}
+
+/* Four consecutive rng_float_mono() draws from `state` (advanced by 4).
+ * SplitMix64 is counter based, so draw k only needs state + k*GAMMA. */
+static inline vf_t x86_noise4(uint64_t *state)
+{
+    const uint64_t s = *state;
+    __m128i z0 = _mm_set_epi64x((long long)(s + 2 * SM64_GAMMA), (long long)(s + 1 * SM64_GAMMA));
+    __m128i z1 = _mm_set_epi64x((long long)(s + 4 * SM64_GAMMA), (long long)(s + 3 * SM64_GAMMA));
+    *state = s + 4 * SM64_GAMMA;
+    z0 = x86_splitmix_mix(z0);
+    z1 = x86_splitmix_mix(z1);
+    /* gather the low 32 bits of each 64-bit result */
+    __m128i lo = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(z0), _mm_castsi128_ps(z1),
+                                                 _MM_SHUFFLE(2, 0, 2, 0)));
+    vf_t f = _mm_cvtepi32_ps(_mm_srli_epi32(lo, 8));
+    f = _mm_mul_ps(f, _mm_set1_ps(1.0f / 16777216.0f));
+    return _mm_sub_ps(_mm_mul_ps(f, _mm_set1_ps(2.0f)), _mm_set1_ps(1.0f));
+}
+#define X86_NOISE(state) x86_noise4(state)
+
+static inline __m128i x86_mullo32(__m128i a, __m128i b)
+{
+#ifdef __SSE4_1__
+    return _mm_mullo_epi32(a, b);
+#else
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+
+/* rng_hash32 on four u32 lanes */
+static inline __m128i x86_hash32(__m128i x)
+{
+    x = x86_mullo32(_mm_xor_si128(x, _mm_srli_epi32(x, 16)), _mm_set1_epi32(0x7FEB352D));
+    x = x86_mullo32(_mm_xor_si128(x, _mm_srli_epi32(x, 15)), _mm_set1_epi32((int)0x846CA68BU));
+    return _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+}
+
+/* Four consecutive rng_wide_float_mono() draws from `state` (advanced by
+ * 4): 64-bit adds for the Weyl states, then only 32-bit lane work. */
+static inline vf_t x86_noise_wide4(uint64_t *state)
+{
+    const uint64_t s = *state;
+    __m128i z0 = _mm_set_epi64x((long long)(s + 2 * SM64_GAMMA), (long long)(s + 1 * SM64_GAMMA));
+    __m128i z1 = _mm_set_epi64x((long long)(s + 4 * SM64_GAMMA), (long long)(s + 3 * SM64_GAMMA));
+    *state = s + 4 * SM64_GAMMA;
+    z0 = _mm_xor_si128(z0, _mm_srli_epi64(z0, 32));
+    z1 = _mm_xor_si128(z1, _mm_srli_epi64(z1, 32));
+    __m128i x = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(z0), _mm_castsi128_ps(z1),
+                                                _MM_SHUFFLE(2, 0, 2, 0)));
+    vf_t f = _mm_cvtepi32_ps(_mm_srli_epi32(x86_hash32(x), 8));
+    f = _mm_mul_ps(f, _mm_set1_ps(1.0f / 16777216.0f));
+    return _mm_sub_ps(_mm_mul_ps(f, _mm_set1_ps(2.0f)), _mm_set1_ps(1.0f));
+}
+#define X86_NOISE_WIDE(state) x86_noise_wide4(state)
+
+#elif X86_SIMD_WIDTH == 8
+/* ------------------------------------------------------------------ AVX2 */
+typedef __m256  vf_t;
+#define VF_SET1(x)      _mm256_set1_ps(x)
+#define VF_LOAD(p)      _mm256_loadu_ps(p)
+#define VF_STORE(p, v)  _mm256_storeu_ps((p), (v))
+#define VF_ADD(a, b)    _mm256_add_ps((a), (b))
+#define VF_SUB(a, b)    _mm256_sub_ps((a), (b))
+#define VF_MUL(a, b)    _mm256_mul_ps((a), (b))
+#define VF_DIV(a, b)    _mm256_div_ps((a), (b))
+#define VF_MIN(a, b)    _mm256_min_ps((a), (b))
+#define VF_MAX(a, b)    _mm256_max_ps((a), (b))
+#define VF_GT(a, b)     _mm256_cmp_ps((a), (b), _CMP_GT_OQ)
+#define VF_GE(a, b)     _mm256_cmp_ps((a), (b), _CMP_GE_OQ)
+#define VF_LT(a, b)     _mm256_cmp_ps((a), (b), _CMP_LT_OQ)
+#define VF_AND(a, b)    _mm256_and_ps((a), (b))
+#define VF_MASK(m)      _mm256_movemask_ps(m)
+typedef __m256i vi_t;
+#define VI_SET1(x)      _mm256_set1_epi32((int)(x))
+#define VI_LOAD(p)      _mm256_loadu_si256((const __m256i *)(p))
+#define VI_STORE(p, v)  _mm256_storeu_si256((__m256i *)(p), (v))
+#define VI_ADD(a, b)    _mm256_add_epi32((a), (b))
+#define VI_TO_F(a)      _mm256_cvtepi32_ps(a)
+#define VI_SRL(a, n)    _mm256_srli_epi32((a), (n))
+#define VI_AND(a, b)    _mm256_and_si256((a), (b))
+#define VF_ROUND(x)     _mm256_cvtepi32_ps(_mm256_cvtps_epi32(x))
+static inline vf_t vf_ramp(void) { return _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f); }
+static inline float vf_hsum(vf_t v)
+{
+    __m128 x = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+    return _mm_cvtss_f32(_mm_add_ss(x, _mm_shuffle_ps(x, x, 1)));
+}
+static inline float vf_lane(vf_t v, int j) { float t[8]; _mm256_storeu_ps(t, v); return t[j]; }
+static inline float vf_last(vf_t v)
+{
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    return _mm_cvtss_f32(_mm_shuffle_ps(hi, hi, 0xFF));
+}
+static inline vf_t vf_abs(vf_t v) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v); }
+static inline vf_t vf_gather(const float *p, vi_t idx) { return _mm256_i32gather_ps(p, idx, 4); }
+static inline vf_t vf_select(vf_t m, vf_t a, vf_t b) { return _mm256_blendv_ps(b, a, m); }
+
+/* Low 64 bits of a*b for four u64 lanes; b_hi = b >> 32 precomputed. */
+static inline __m256i x86_mul64(__m256i a, __m256i b, __m256i b_hi)
+{
+    __m256i lo    = _mm256_mul_epu32(a, b);
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                     _mm256_mul_epu32(a, b_hi));
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+}
+
+static inline __m256i x86_splitmix_mix(__m256i z)
+{
+    const __m256i m1 = _mm256_set1_epi64x((long long)SM64_MUL1);
+    const __m256i m1h = _mm256_set1_epi64x((long long)(SM64_MUL1 >> 32));
+    const __m256i m2 = _mm256_set1_epi64x((long long)SM64_MUL2);
+    const __m256i m2h = _mm256_set1_epi64x((long long)(SM64_MUL2 >> 32));
+    z = x86_mul64(_mm256_xor_si256(z, _mm256_srli_epi64(z, 30)), m1, m1h);
+    z = x86_mul64(_mm256_xor_si256(z, _mm256_srli_epi64(z, 27)), m2, m2h);
+    return _mm256_xor_si256(z, _mm256_srli_epi64(z, 31));
+}
+
+/* Eight consecutive rng_float_mono() draws from `state` (advanced by 8). */
+static inline vf_t x86_noise8(uint64_t *state)
+{
+    const uint64_t s = *state;
+    const __m256i g  = _mm256_set1_epi64x((long long)SM64_GAMMA);
+    __m256i z0 = _mm256_add_epi64(_mm256_set1_epi64x((long long)s),
+                                  _mm256_setr_epi64x((long long)(1 * SM64_GAMMA), (long long)(2 * SM64_GAMMA),
+                                                     (long long)(3 * SM64_GAMMA), (long long)(4 * SM64_GAMMA)));
+    __m256i z1 = _mm256_add_epi64(z0, _mm256_slli_epi64(g, 2));
+    *state = s + 8 * SM64_GAMMA;
+    z0 = x86_splitmix_mix(z0);
+    z1 = x86_splitmix_mix(z1);
+    /* low 32 bits of each 64-bit lane, restored to draw order */
+    __m256 packed = _mm256_shuffle_ps(_mm256_castsi256_ps(z0), _mm256_castsi256_ps(z1),
+                                      _MM_SHUFFLE(2, 0, 2, 0));
+    __m256i lo = _mm256_castpd_si256(_mm256_permute4x64_pd(_mm256_castps_pd(packed),
+                                                           _MM_SHUFFLE(3, 1, 2, 0)));
+    vf_t f = _mm256_cvtepi32_ps(_mm256_srli_epi32(lo, 8));
+    f = _mm256_mul_ps(f, _mm256_set1_ps(1.0f / 16777216.0f));
+    return _mm256_sub_ps(_mm256_mul_ps(f, _mm256_set1_ps(2.0f)), _mm256_set1_ps(1.0f));
+}
+#define X86_NOISE(state) x86_noise8(state)
+
+/* rng_hash32 on eight u32 lanes */
+static inline __m256i x86_hash32(__m256i x)
+{
+    x = _mm256_mullo_epi32(_mm256_xor_si256(x, _mm256_srli_epi32(x, 16)), _mm256_set1_epi32(0x7FEB352D));
+    x = _mm256_mullo_epi32(_mm256_xor_si256(x, _mm256_srli_epi32(x, 15)), _mm256_set1_epi32((int)0x846CA68BU));
+    return _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+}
+
+/* Eight consecutive rng_wide_float_mono() draws from `state` (advanced by 8). */
+static inline vf_t x86_noise_wide8(uint64_t *state)
+{
+    const uint64_t s = *state;
+    const __m256i g  = _mm256_set1_epi64x((long long)SM64_GAMMA);
+    __m256i z0 = _mm256_add_epi64(_mm256_set1_epi64x((long long)s),
+                                  _mm256_setr_epi64x((long long)(1 * SM64_GAMMA), (long long)(2 * SM64_GAMMA),
+                                                     (long long)(3 * SM64_GAMMA), (long long)(4 * SM64_GAMMA)));
+    __m256i z1 = _mm256_add_epi64(z0, _mm256_slli_epi64(g, 2));
+    *state = s + 8 * SM64_GAMMA;
+    z0 = _mm256_xor_si256(z0, _mm256_srli_epi64(z0, 32));
+    z1 = _mm256_xor_si256(z1, _mm256_srli_epi64(z1, 32));
+    __m256 packed = _mm256_shuffle_ps(_mm256_castsi256_ps(z0), _mm256_castsi256_ps(z1),
+                                      _MM_SHUFFLE(2, 0, 2, 0));
+    __m256i x = _mm256_castpd_si256(_mm256_permute4x64_pd(_mm256_castps_pd(packed),
+                                                          _MM_SHUFFLE(3, 1, 2, 0)));
+    vf_t f = _mm256_cvtepi32_ps(_mm256_srli_epi32(x86_hash32(x), 8));
+    f = _mm256_mul_ps(f, _mm256_set1_ps(1.0f / 16777216.0f));
+    return _mm256_sub_ps(_mm256_mul_ps(f, _mm256_set1_ps(2.0f)), _mm256_set1_ps(1.0f));
+}
+#define X86_NOISE_WIDE(state) x86_noise_wide8(state)
+
+#elif X86_SIMD_WIDTH == 16
+/* --------------------------------------------------------------- AVX-512F
+ * Only AVX-512F is assumed (no DQ/VL), so float logic goes through the
+ * integer unit and compares are expanded from k-masks to lane masks. */
+typedef __m512  vf_t;
+#define VF_SET1(x)      _mm512_set1_ps(x)
+#define VF_LOAD(p)      _mm512_loadu_ps(p)
+#define VF_STORE(p, v)  _mm512_storeu_ps((p), (v))
+#define VF_ADD(a, b)    _mm512_add_ps((a), (b))
+#define VF_SUB(a, b)    _mm512_sub_ps((a), (b))
+#define VF_MUL(a, b)    _mm512_mul_ps((a), (b))
+#define VF_DIV(a, b)    _mm512_div_ps((a), (b))
+#define VF_MIN(a, b)    _mm512_min_ps((a), (b))
+#define VF_MAX(a, b)    _mm512_max_ps((a), (b))
+static inline vf_t vf_from_kmask(__mmask16 m)
+{
+    return _mm512_castsi512_ps(_mm512_maskz_set1_epi32(m, -1));
+}
+static inline __mmask16 vf_to_kmask(vf_t m)
+{
+    return _mm512_cmplt_epi32_mask(_mm512_castps_si512(m), _mm512_setzero_si512());
+}
+#define VF_GT(a, b)     vf_from_kmask(_mm512_cmp_ps_mask((a), (b), _CMP_GT_OQ))
+#define VF_GE(a, b)     vf_from_kmask(_mm512_cmp_ps_mask((a), (b), _CMP_GE_OQ))
+#define VF_LT(a, b)     vf_from_kmask(_mm512_cmp_ps_mask((a), (b), _CMP_LT_OQ))
+#define VF_AND(a, b)    _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)))
+#define VF_MASK(m)      ((int)vf_to_kmask(m))
+typedef __m512i vi_t;
+#define VI_SET1(x)      _mm512_set1_epi32((int)(x))
+#define VI_LOAD(p)      _mm512_loadu_si512((const void *)(p))
+#define VI_STORE(p, v)  _mm512_storeu_si512((void *)(p), (v))
+#define VI_ADD(a, b)    _mm512_add_epi32((a), (b))
+#define VI_TO_F(a)      _mm512_cvtepi32_ps(a)
+#define VI_SRL(a, n)    _mm512_srli_epi32((a), (n))
+#define VI_AND(a, b)    _mm512_and_si512((a), (b))
+#define VF_ROUND(x)     _mm512_cvtepi32_ps(_mm512_cvtps_epi32(x))
+static inline vf_t vf_ramp(void)
+{
+    return _mm512_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f,
+                          8.f, 9.f, 10.f, 11.f, 12.f, 13.f, 14.f, 15.f);
+}
+static inline float vf_lane(vf_t v, int j) { float t[16]; _mm512_storeu_ps(t, v); return t[j]; }
+static inline float vf_last(vf_t v) { return vf_lane(v, 15); }
+static inline float vf_hsum(vf_t v) { return _mm512_reduce_add_ps(v); }
+static inline vf_t vf_abs(vf_t v) { return _mm512_abs_ps(v); }
+static inline vf_t vf_gather(const float *p, vi_t idx) { return _mm512_i32gather_ps(idx, p, 4); }
+static inline vf_t vf_select(vf_t m, vf_t a, vf_t b)
+{
+    return _mm512_mask_blend_ps(vf_to_kmask(m), b, a);
+}
+
+/* Low 64 bits of a*b for eight u64 lanes; b_hi = b >> 32 precomputed. */
+static inline __m512i x86_mul64(__m512i a, __m512i b, __m512i b_hi)
+{
+    __m512i lo    = _mm512_mul_epu32(a, b);
+    __m512i cross = _mm512_add_epi64(_mm512_mul_epu32(_mm512_srli_epi64(a, 32), b),
+                                     _mm512_mul_epu32(a, b_hi));
+    return _mm512_add_epi64(lo, _mm512_slli_epi64(cross, 32));
+}
+
+static inline __m512i x86_splitmix_mix(__m512i z)
+{
+    const __m512i m1 = _mm512_set1_epi64((long long)SM64_MUL1);
+    const __m512i m1h = _mm512_set1_epi64((long long)(SM64_MUL1 >> 32));
+    const __m512i m2 = _mm512_set1_epi64((long long)SM64_MUL2);
+    const __m512i m2h = _mm512_set1_epi64((long long)(SM64_MUL2 >> 32));
+    z = x86_mul64(_mm512_xor_si512(z, _mm512_srli_epi64(z, 30)), m1, m1h);
+    z = x86_mul64(_mm512_xor_si512(z, _mm512_srli_epi64(z, 27)), m2, m2h);
+    return _mm512_xor_si512(z, _mm512_srli_epi64(z, 31));
+}
+
+/* Sixteen consecutive rng_float_mono() draws from `state` (advanced by 16). */
+static inline vf_t x86_noise16(uint64_t *state)
+{
+    const uint64_t s = *state;
+    __m512i z0 = _mm512_add_epi64(_mm512_set1_epi64((long long)s),
+                                  _mm512_setr_epi64((long long)(1 * SM64_GAMMA), (long long)(2 * SM64_GAMMA),
+                                                    (long long)(3 * SM64_GAMMA), (long long)(4 * SM64_GAMMA),
+                                                    (long long)(5 * SM64_GAMMA), (long long)(6 * SM64_GAMMA),
+                                                    (long long)(7 * SM64_GAMMA), (long long)(8 * SM64_GAMMA)));
+    __m512i z1 = _mm512_add_epi64(z0, _mm512_set1_epi64((long long)(8 * SM64_GAMMA)));
+    *state = s + 16 * SM64_GAMMA;
+    /* vpmovqd keeps the low 32 bits of each lane, already in draw order */
+    __m256i lo0 = _mm512_cvtepi64_epi32(x86_splitmix_mix(z0));
+    __m256i lo1 = _mm512_cvtepi64_epi32(x86_splitmix_mix(z1));
+    __m512i lo = _mm512_inserti64x4(_mm512_castsi256_si512(lo0), lo1, 1);
+    vf_t f = _mm512_cvtepi32_ps(_mm512_srli_epi32(lo, 8));
+    f = _mm512_mul_ps(f, _mm512_set1_ps(1.0f / 16777216.0f));
+    return _mm512_sub_ps(_mm512_mul_ps(f, _mm512_set1_ps(2.0f)), _mm512_set1_ps(1.0f));
+}
+#define X86_NOISE(state) x86_noise16(state)
+
+/* rng_hash32 on sixteen u32 lanes */
+static inline __m512i x86_hash32(__m512i x)
+{
+    x = _mm512_mullo_epi32(_mm512_xor_si512(x, _mm512_srli_epi32(x, 16)), _mm512_set1_epi32(0x7FEB352D));
+    x = _mm512_mullo_epi32(_mm512_xor_si512(x, _mm512_srli_epi32(x, 15)), _mm512_set1_epi32((int)0x846CA68BU));
+    return _mm512_xor_si512(x, _mm512_srli_epi32(x, 16));
+}
+
+/* Sixteen consecutive rng_wide_float_mono() draws from `state` (advanced by 16). */
+static inline vf_t x86_noise_wide16(uint64_t *state)
+{
+    const uint64_t s = *state;
+    __m512i z0 = _mm512_add_epi64(_mm512_set1_epi64((long long)s),
+                                  _mm512_setr_epi64((long long)(1 * SM64_GAMMA), (long long)(2 * SM64_GAMMA),
+                                                    (long long)(3 * SM64_GAMMA), (long long)(4 * SM64_GAMMA),
+                                                    (long long)(5 * SM64_GAMMA), (long long)(6 * SM64_GAMMA),
+                                                    (long long)(7 * SM64_GAMMA), (long long)(8 * SM64_GAMMA)));
+    __m512i z1 = _mm512_add_epi64(z0, _mm512_set1_epi64((long long)(8 * SM64_GAMMA)));
+    *state = s + 16 * SM64_GAMMA;
+    __m256i x0 = _mm512_cvtepi64_epi32(_mm512_xor_si512(z0, _mm512_srli_epi64(z0, 32)));
+    __m256i x1 = _mm512_cvtepi64_epi32(_mm512_xor_si512(z1, _mm512_srli_epi64(z1, 32)));
+    __m512i x = _mm512_inserti64x4(_mm512_castsi256_si512(x0), x1, 1);
+    vf_t f = _mm512_cvtepi32_ps(_mm512_srli_epi32(x86_hash32(x), 8));
+    f = _mm512_mul_ps(f, _mm512_set1_ps(1.0f / 16777216.0f));
+    return _mm512_sub_ps(_mm512_mul_ps(f, _mm512_set1_ps(2.0f)), _mm512_set1_ps(1.0f));
+}
+#define X86_NOISE_WIDE(state) x86_noise_wide16(state)
+#endif
+
+#if X86_SIMD_WIDTH > 1
+/* Single-fold wrap into [-π, π] followed by the 5th-order Taylor sine used
+ * by fm_voice.s (x - x³/6 + x⁵/120).  Matches the ARM kernel, not libm. */
+static inline vf_t vf_sin_taylor5(vf_t x)
+{
+    const vf_t pi = VF_SET1(X86_PI), two_pi = VF_SET1(2.0f * X86_PI);
+    x = VF_SUB(x, VF_AND(VF_GT(x, pi), two_pi));
+    x = VF_ADD(x, VF_AND(VF_LT(x, VF_SET1(-X86_PI)), two_pi));
+    vf_t x2 = VF_MUL(x, x);
+    vf_t x3 = VF_MUL(x2, x);
+    vf_t x5 = VF_MUL(VF_MUL(x2, x2), x);
+    return VF_ADD(VF_SUB(x, VF_MUL(x3, VF_SET1(1.0f / 6.0f))),
+                  VF_MUL(x5, VF_SET1(1.0f / 120.0f)));
+}
+
+/* Phase wrap for lane-offset phases known to lie in [0, 2·TAU). */
+static inline vf_t vf_wrap_tau(vf_t p)
+{
+    return VF_SUB(p, VF_AND(VF_GE(p, VF_SET1(X86_TAU)), VF_SET1(X86_TAU)));
+}
+
+/* Accurate sine for phases in [0, TAU): sin(p) = -sin(p - π), folded onto
+ * [-π/2, π/2] and evaluated with a degree-11 odd polynomial (|err| < 1e-6),
+ * close enough to libm sinf for the oscillator blocks. */
+static inline vf_t vf_sin_phase(vf_t p)
+{
+    const vf_t half_pi = VF_SET1(0.5f * X86_PI);
+    vf_t x = VF_SUB(p, VF_SET1(X86_PI));
+    x = vf_select(VF_GT(x, half_pi), VF_SUB(VF_SET1(X86_PI), x), x);
+    x = vf_select(VF_LT(x, VF_SUB(VF_SET1(0.0f), half_pi)), VF_SUB(VF_SET1(-X86_PI), x), x);
+    vf_t x2 = VF_MUL(x, x);
+    vf_t y = VF_SET1(-1.0f / 39916800.0f);
+    y = VF_ADD(VF_MUL(y, x2), VF_SET1(1.0f / 362880.0f));
+    y = VF_ADD(VF_MUL(y, x2), VF_SET1(-1.0f / 5040.0f));
+    y = VF_ADD(VF_MUL(y, x2), VF_SET1(1.0f / 120.0f));
+    y = VF_ADD(VF_MUL(y, x2), VF_SET1(-1.0f / 6.0f));
+    y = VF_ADD(VF_MUL(y, x2), VF_SET1(1.0f));
+    return VF_SUB(VF_SET1(0.0f), VF_MUL(y, x));
+}
+
+/* Accurate sine for any x (|x| < 2^31·TAU): reduced to [-π, π] around the
+ * nearest whole turn, folded onto [-π/2, π/2] and evaluated with the same
+ * degree-11 polynomial as vf_sin_phase. */
+static inline vf_t vf_sin_wrap(vf_t x)
+{
+    const vf_t pi = VF_SET1(X86_PI), half_pi = VF_SET1(0.5f * X86_PI);
+    x = VF_SUB(x, VF_MUL(VF_ROUND(VF_MUL(x, VF_SET1(1.0f / X86_TAU))), VF_SET1(X86_TAU)));
+    x = vf_select(VF_GT(x, half_pi), VF_SUB(pi, x), x);
+    x = vf_select(VF_LT(x, VF_SUB(VF_SET1(0.0f), half_pi)), VF_SUB(VF_SUB(VF_SET1(0.0f), pi), x), x);
+    vf_t x2 = VF_MUL(x, x);
+    vf_t y = VF_SET1(-1.0f / 39916800.0f);
+    y = VF_ADD(VF_MUL(y, x2), VF_SET1(1.0f / 362880.0f));
+    y = VF_ADD(VF_MUL(y, x2), VF_SET1(-1.0f / 5040.0f));
+    y = VF_ADD(VF_MUL(y, x2), VF_SET1(1.0f / 120.0f));
+    y = VF_ADD(VF_MUL(y, x2), VF_SET1(-1.0f / 6.0f));
+    y = VF_ADD(VF_MUL(y, x2), VF_SET1(1.0f));
+    return VF_MUL(y, x);
+}
+#endif
+
+/* Scalar twin of vf_sin_taylor5 for loop tails. */
+static inline float x86_sin_taylor5(float x)
+{
+    if (x > X86_PI) { x -= X86_PI; x -= X86_PI; }
+    if (x < -X86_PI) { x += X86_PI; x += X86_PI; }
+    float x2 = x * x, x3 = x2 * x, x5 = x2 * x2 * x;
+    return x - x3 / 6.0f + x5 / 120.0f;
+}
+
+/* Scalar twin of vf_sin_wrap for loop tails. */
+static inline float x86_sin_wrap(float x)
+{
+    float k = x * (1.0f / X86_TAU);
+    x -= (float)(int32_t)(k + (k >= 0.0f ? 0.5f : -0.5f)) * X86_TAU;
+    if (x > 0.5f * X86_PI) x = X86_PI - x;
+    if (x < -0.5f * X86_PI) x = -X86_PI - x;
+    float x2 = x * x;
+    float y = -1.0f / 39916800.0f;
+    y = y * x2 + 1.0f / 362880.0f;
+    y = y * x2 - 1.0f / 5040.0f;
+    y = y * x2 + 1.0f / 120.0f;
+    y = y * x2 - 1.0f / 6.0f;
+    y = y * x2 + 1.0f;
+    return y * x;
+}
@@ -0,0 +1,139 @@
+#ifndef FM_BANK_H
+#define FM_BANK_H
+
+#include <stdint.h>
+#include <math.h>
+#include "fm_presets.h"
+
+/* Multi-operator FM voice bank.
+ *
+ * Up to FM_BANK_VOICES voices of up to FM_BANK_MAX_OPS operators, stored as
+ * structure-of-arrays so one fm_bank_process call renders every live voice
+ * in a single pass with one SIMD lane per voice.  Each operator is a sine
+ * with its own frequency ratio, level and exponential decay; the algorithm
+ * says which operators phase-modulate which and which are heard.  Voices
+ * of different patches and algorithms share a pass: per lane, the
+ * algorithm is just a modulation matrix and a set of carrier weights.
+ *
+ * A 2-operator patch made by fm_patch_from_params renders the
+ * exponential-envelope voice of the phasor FM model (DSP_FM_PHASOR):
+ * sin(cp + index·env·sin(mp))·env·amp·0.25.  Under that model the
+ * generator renders its mid and bass FM pools as two banks. */
+
+#define FM_BANK_MAX_OPS 6
+#define FM_BANK_VOICES  32   /* a multiple of the widest SIMD width */
+
+/* Operator k can only be modulated by operators j > k, so rendering them
+ * from the highest down sees every modulator's current output. */
+typedef enum {
+    FM_ALGO_PAIR = 0,     /* 1 -> 0 */
+    FM_ALGO_STACK4,       /* 3 -> 2 -> 1 -> 0 */
+    FM_ALGO_TWO_PAIRS,    /* 1 -> 0, 3 -> 2; carriers 0 and 2 */
+    FM_ALGO_BRANCH4,      /* 1, 2, 3 -> 0 */
+    FM_ALGO_STACK6,       /* 5 -> 4 -> 3 -> 2 -> 1 -> 0 */
+    FM_ALGO_THREE_PAIRS,  /* 1 -> 0, 3 -> 2, 5 -> 4; carriers 0, 2, 4 */
+    FM_ALGO_ORGAN6,       /* six carriers, no modulation */
+    FM_ALGO_COUNT
+} fm_algo_t;
+
+typedef struct {
+    float32_t ratio;   /* frequency relative to the note */
+    float32_t level;   /* modulation index (radians) or carrier gain */
+    float32_t decay;   /* env = exp(-decay·t) */
+} fm_op_t;
+
+typedef struct {
+    fm_algo_t algo;
+    fm_op_t op[FM_BANK_MAX_OPS];   /* only the algorithm's operators are used */
+} fm_patch_t;
+
+/* No _Alignas on the arrays: banks live inside the malloc'd generator_t
+ * (gen_voices_t), and the kernels load lanes unaligned. */
+typedef struct {
+    /* Per operator, per voice lane */
+    uint32_t phase[FM_BANK_MAX_OPS][FM_BANK_VOICES];  /* Q32 turns */
+    uint32_t inc[FM_BANK_MAX_OPS][FM_BANK_VOICES];
+    float32_t env[FM_BANK_MAX_OPS][FM_BANK_VOICES];   /* level·exp(-decay·t) */
+    float32_t coef[FM_BANK_MAX_OPS][FM_BANK_VOICES];  /* env step per frame */
+    float32_t level[FM_BANK_MAX_OPS][FM_BANK_VOICES];
+    float32_t decay[FM_BANK_MAX_OPS][FM_BANK_VOICES];
+    float32_t mix[FM_BANK_MAX_OPS][FM_BANK_VOICES];   /* carrier weight, 0 for modulators */
+    float32_t rot_c[FM_BANK_MAX_OPS][FM_BANK_VOICES]; /* cos/sin of one step of inc */
+    float32_t rot_s[FM_BANK_MAX_OPS][FM_BANK_VOICES];
+    /* mod[k][j]: weight of operator j's output in operator k's phase (j > k) */
+    float32_t mod[FM_BANK_MAX_OPS][FM_BANK_MAX_OPS][FM_BANK_VOICES];
+    /* Per voice lane */
+    uint32_t remaining[FM_BANK_VOICES];  /* samples left, 0 = free */
+    uint32_t length[FM_BANK_VOICES];     /* note length in samples */
+    uint8_t ops[FM_BANK_VOICES];
+    uint8_t modby[FM_BANK_VOICES][FM_BANK_MAX_OPS];   /* bits j with mod[k][j] != 0 */
+    uint32_t active;   /* bit per live lane */
+    float32_t sr;
+} fm_bank_t;
+
+void fm_bank_init(fm_bank_t *b, float32_t sr);
+
+/* Start a note on the lowest free lane.  amp scales the carriers (with the
+ * engine's 0.25 FM output scale).  Returns the lane, or -1 if all
+ * FM_BANK_VOICES are busy. */
+int fm_bank_trigger(fm_bank_t *b, const fm_patch_t *p, float32_t freq,
+                    float32_t duration_sec, float32_t amp);
+
+/* Start a note on a given lane, cutting whatever it was playing; the
+ * generator's voice pools pick the lane (slot number = lane).  A note of
+ * no frames or an unknown algorithm leaves the lane free.  Returns lane,
+ * or -1. */
+int fm_bank_trigger_lane(fm_bank_t *b, int lane, const fm_patch_t *p, float32_t freq,
+                         float32_t duration_sec, float32_t amp);
+
+/* Add n frames of every live voice into L/R and retire finished ones. */
+void fm_bank_process(fm_bank_t *b, float32_t *L, float32_t *R, uint32_t n);
+
+/* Advance every live voice n frames without rendering, landing where
+ * fm_bank_process would. */
+void fm_bank_skip(fm_bank_t *b, uint32_t n);
+
+static inline uint32_t fm_bank_active(const fm_bank_t *b)
+{
+    return (uint32_t)__builtin_popcount(b->active);
+}
+
+/* Two-operator patch equivalent to a 2-op preset (carrier + modulator at
+ * `ratio`, index decaying with the carrier). */
+void fm_patch_from_params(fm_patch_t *p, const fm_params_t *params);
+
+/* Multi-operator patches (fm_presets.c) */
+extern const fm_patch_t FM_PATCH_EPIANO;   /* two pairs, bright tine on the second */
+extern const fm_patch_t FM_PATCH_BRASS;    /* 4-operator stack */
+extern const fm_patch_t FM_PATCH_BELL6;    /* three inharmonic pairs */
+extern const fm_patch_t FM_PATCH_ORGAN;    /* six drawbar-style carriers */
+
+/* Bookkeeping shared by the kernels.  env is stepped by coef within a
+ * call and picks up rounding, so each call first re-derives it from the
+ * note's age (like the phasor voice's anchors); a skip then only has to
+ * move the phases and the age on. */
+static inline void fm_bank_anchor(fm_bank_t *b)
+{
+    for (uint32_t live = b->active; live; live &= live - 1) {
+        const int v = __builtin_ctz(live);
+        const float32_t t = (float32_t)(b->length[v] - b->remaining[v]) / b->sr;
+        for (int k = 0; k < b->ops[v]; k++)
+            b->env[k][v] = b->level[k][v] * expf(-b->decay[k][v] * t);
+    }
+}
+
+/* Count n frames off every live voice and free the lanes that ran out. */
+static inline void fm_bank_retire(fm_bank_t *b, uint32_t n)
+{
+    for (uint32_t live = b->active; live; live &= live - 1) {
+        int i = __builtin_ctz(live);
+        if (b->remaining[i] > n) {
+            b->remaining[i] -= n;
+        } else {
+            b->remaining[i] = 0;
+            b->active &= ~(1u << i);
+        }
+    }
+}
+
+#endif /* FM_BANK_H */
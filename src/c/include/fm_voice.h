@@ -18,10 +18,14 @@ typedef struct {
     uint32_t pos;  /* current position */
     float32_t carrier_phase;
     float32_t mod_phase;
+
+    /* 1/(1 + decay·pos/sr) for pos < len (env.h), or NULL to evaluate it */
+    const float32_t *env_tab;
 } fm_voice_t;
 
 void fm_voice_init(fm_voice_t *v, float32_t sr);
 void fm_voice_trigger(fm_voice_t *v, float32_t carrier_freq, float32_t duration_sec, float32_t ratio, float32_t index, float32_t amp, float32_t decay);
 void fm_voice_process(fm_voice_t *v, float32_t *L, float32_t *R, uint32_t n);
+void fm_voice_skip(fm_voice_t *v, uint32_t n);  /* advance without rendering */
 
 #endif /* FM_VOICE_H */ 
\ No newline at end of file
@@ -14,26 +14,116 @@
 #include "hat.h"
 #include "melody.h"
 #include "fm_voice.h"
+#include "fm_bank.h"
 #include "simple_voice.h"
+#include "voice_pool.h"
 #include "delay.h"
 #include "limiter.h"
 #include "event_queue.h"
 
-#define MAX_DELAY_SAMPLES 106000
+/* Longest delay line, in seconds: two beats at the slowest tempo (50 BPM)
+   with room to spare.  The buffer is sized per generator from its rate. */
+#define MAX_DELAY_SEC 2.5f
+
+/* generator_process renders in chunks of at most GEN_MAX_BLOCK frames using
+ * a scratch arena owned by generator_t (four sub-mix buffers: Ld Rd Ls Rs),
+ * so neither the C nor the assembly path allocates or uses the stack for
+ * per-block buffers, whatever num_frames is. */
+#define GEN_MAX_BLOCK 4096
+#define GEN_SCRATCH_ALIGN 64
+
+/* Block scheduler.  Events only fire at step starts, so a block of n
+ * frames needs at most n/step_samples + 2 split points; a plan that would
+ * need more is cut short at the first split it cannot hold and the caller
+ * plans the rest of the block again. */
+#define GEN_MAX_SPLITS 16
+
+/* Parallel rendering (generator_set_threads).  A call to generator_process
+ * is split into one time chunk per thread, each at least GEN_PAR_MIN_CHUNK
+ * frames; calls too short for two such chunks render on the caller's
+ * thread. */
+#define GEN_MAX_THREADS 64
+#define GEN_PAR_MIN_CHUNK 16384
+
+struct gen_par;  /* worker state, private to generator_par.c */
+
+/* Voice-bus parallelism (generator_set_bus_threads).  Within each block
+ * the drum bus, the synth bus and the two FM voices render as separate
+ * jobs on pinned worker threads; mix, delay and limiter stay on the
+ * calling thread.  Blocks shorter than GEN_BUS_MIN_FRAMES cannot pay for
+ * the barrier and render on the calling thread. */
+#define GEN_BUS_MIN_FRAMES 256
+
+enum {
+    GEN_BUS_DRUMS,     /* kick, snare, hat */
+    GEN_BUS_SYNTH,     /* melody, mid simple voice */
+    GEN_BUS_MID_FM,
+    GEN_BUS_BASS_FM,
+    GEN_BUS_COUNT
+};
+
+typedef struct {
+    uint32_t threads;          /* 0 when the mode is off */
+    uint64_t blocks;           /* blocks rendered by the bus jobs */
+    uint64_t serial_blocks;    /* blocks below GEN_BUS_MIN_FRAMES */
+    uint64_t frames;           /* frames in `blocks` */
+    uint64_t bus_ns[GEN_BUS_COUNT];  /* render time per bus job */
+    uint64_t wait_ns;          /* calling thread waiting at the barrier */
+} gen_bus_stats_t;
+
+struct gen_bus;  /* worker pool, private to generator_bus.c */
+struct gen_seek; /* loop-start checkpoints, private to generator.c */
+
+/* Voice pools (generator_set_polyphony).  Every instrument owns up to
+ * GEN_MAX_VOICES voices behind a voice_pool_t; a render touches only the
+ * live ones.  The pools start at one voice each, which renders exactly as
+ * the single voice per instrument did: a new note restarts it. */
+#define GEN_MAX_VOICES VOICE_POOL_MAX
+
+typedef enum {
+    GEN_INST_KICK,
+    GEN_INST_SNARE,
+    GEN_INST_HAT,
+    GEN_INST_MELODY,
+    GEN_INST_MID_FM,
+    GEN_INST_BASS_FM,
+    GEN_INST_MID_SIMPLE,
+    GEN_INST_COUNT
+} gen_inst_t;
+
+typedef struct {
+    voice_pool_t pool[GEN_INST_COUNT];
+    kick_t kick[GEN_MAX_VOICES];
+    snare_t snare[GEN_MAX_VOICES];
+    hat_t hat[GEN_MAX_VOICES];
+    melody_t mel[GEN_MAX_VOICES];
+    fm_voice_t mid_fm[GEN_MAX_VOICES];
+    fm_voice_t bass_fm[GEN_MAX_VOICES];
+    simple_voice_t mid_simple[GEN_MAX_VOICES];
+    /* The FM pools under DSP_FM_PHASOR: lane = pool slot, and mid_fm /
+       bass_fm above go unused */
+    fm_bank_t mid_bank;
+    fm_bank_t bass_bank;
+} gen_voices_t;
+
+typedef struct {
+    uint32_t offset;  /* frame within the block at which the events fire */
+    uint32_t first;   /* first event in g->q */
+    uint32_t count;   /* events sharing this timestamp */
+} gen_split_t;
+
+typedef struct {
+    uint32_t frames;      /* frames covered by the plan (<= requested) */
+    uint32_t num_splits;
+    uint32_t next_event;  /* event_idx once the plan has run */
+    gen_split_t splits[GEN_MAX_SPLITS];
+} gen_plan_t;
 
 typedef struct {
     music_time_t mt;
     music_globals_t music;
     rng_t rng;
 
-    kick_t kick;
-    snare_t snare;
-    hat_t hat;
-    melody_t mel;
-    fm_voice_t mid_fm;
-    fm_voice_t bass_fm;
-    simple_voice_t mid_simple;
-
     event_queue_t q;
     uint32_t event_idx;
     uint32_t step;
@@ -41,17 +131,135 @@ typedef struct {
 
     delay_t delay;
     limiter_t limiter;
-    
-    float32_t delay_buf[MAX_DELAY_SAMPLES * 2];
+
+    float32_t *delay_buf;  /* delay.size * 2 floats, owned by the generator */
 
     /* visual event flags */
     bool saw_hit;      /* set when saw melody triggers */
     bool bass_hit;     /* set when bass triggers */
 
+    uint64_t seed;     /* for re-initialising voices in generator_seek */
+
+    uint32_t threads;       /* render threads, 0/1 = caller only */
+    struct gen_par *par;    /* allocated on first parallel render */
+    struct gen_bus *bus;    /* voice-bus workers, NULL when off */
+    struct gen_seek *seek;  /* allocated on first generator_seek */
+    limiter_mode_t limiter_mode;  /* generator_set_limiter */
+
+    /* Voice state, kept past the effects so generator.s field offsets stay
+       small; generator_par.c copies it along with everything ahead of
+       `delay`. */
+    gen_voices_t voices;
+
+    /* Scratch arena (kept last so generator.s field offsets stay valid).
+       Use generator_scratch() for the aligned base. */
+    float32_t scratch_mem[4 * GEN_MAX_BLOCK + GEN_SCRATCH_ALIGN / sizeof(float32_t)];
+
 } generator_t;
 
-void generator_init(generator_t *g, uint64_t seed);
+/* GEN_SCRATCH_ALIGN-aligned base of the scratch arena.  Derived on use
+   rather than stored so a copied generator_t stays self-contained. */
+static inline float32_t *generator_scratch(generator_t *g)
+{
+    uintptr_t p = (uintptr_t)g->scratch_mem;
+    return (float32_t *)((p + (GEN_SCRATCH_ALIGN - 1)) & ~(uintptr_t)(GEN_SCRATCH_ALIGN - 1));
+}
+
+/* generator_init allocates the event queue and the delay line for a render
+   at `sr` frames per second (clamped to SR_MIN..SR_MAX); generator_free
+   releases them.  Call generator_free before re-initialising a generator
+   for a new seed or rate.  Returns 0, or -1 (reported on stderr) if an
+   allocation failed; the generator then holds nothing to free. */
+int  generator_init(generator_t *g, uint64_t seed, uint32_t sr);
+void generator_free(generator_t *g);
 void generator_process(generator_t *g, float32_t *L, float32_t *R, uint32_t num_frames);
+
+/* Render long generator_process calls on up to `threads` threads (capped
+   at GEN_MAX_THREADS).  The dry voices are pure functions of their trigger
+   history, so each thread fast-forwards a copy of the voice state to its
+   chunk and renders the drum and synth buses there; the delay and limiter
+   then run over the whole call on the caller's thread.  On x86-64 the
+   output is bit-identical to a single-threaded render at every kernel
+   level.  Reset by generator_init. */
+void generator_set_threads(generator_t *g, uint32_t threads);
+
+/* Render each block's voice buses on `threads` threads (the caller plus
+   pinned workers, capped at GEN_BUS_COUNT and the online cores; 0/1
+   turns the mode off).  Meant
+   for realtime callbacks with small blocks; output is bit-identical to the
+   single-threaded render.  Returns -1 (mode off) if the workers cannot be
+   started.  Call after generator_init; generator_free stops the workers. */
+int  generator_set_bus_threads(generator_t *g, uint32_t threads);
+void generator_bus_stats(const generator_t *g, gen_bus_stats_t *out);
+
+/* Give instrument `inst` up to `voices` overlapping voices (clamped to
+   1..GEN_MAX_VOICES), stealing by `steal` once they are all busy.  Call
+   after generator_init; it silences the instrument.  With more than one
+   voice on the mid FM, bass FM or mid simple instrument, the voice-bus
+   render sums those voices before adding them to the synth bus, so it
+   matches the single-threaded render to rounding rather than bit for
+   bit. */
+void generator_set_polyphony(generator_t *g, gen_inst_t inst, uint32_t voices, voice_steal_t steal);
+
+/* Master limiter mode.  LIMITER_SOFT_KNEE (the default) is the sample-peak
+   limiter at -0.1 dBFS; LIMITER_TRUE_PEAK holds true peaks under -1 dBTP
+   with a 2 ms lookahead and delays the output by limiter_latency() frames.
+   Call after generator_init (which resets it) and before rendering. */
+void generator_set_limiter(generator_t *g, limiter_mode_t mode);
+
+/* Add n frames of every live voice of `inst` into L/R (or step them without
+   audio) and retire the voices that end.  generator_process_voices, the
+   bus jobs and generator_fast_forward are built from these. */
+void generator_render_inst(generator_t *g, gen_inst_t inst, float32_t *L, float32_t *R, uint32_t n);
+void generator_skip_inst(generator_t *g, gen_inst_t inst, uint32_t n);
+
+/* Plan the next n frames: one pass over g->q from event_idx, grouping
+   events by timestamp into sample offsets within the block. */
+void generator_schedule(const generator_t *g, uint32_t n, gen_plan_t *plan);
+
+/* Reference renderer: the original step-slicing loop that splits every
+   block at each step boundary (and once more one frame before it).  Kept
+   for A/B runs and bench_scheduler.  generator_process fires events at
+   their exact offsets instead; the two run at the same speed. */
+void generator_process_stepwise(generator_t *g, float32_t *L, float32_t *R, uint32_t num_frames);
+
+void generator_resolve_events(generator_t *g);
+void generator_fire_event(generator_t *g, const event_t *e);
+void generator_warm_envelopes(const generator_t *g);
+
+/* Building blocks shared by the renderers.  generator_render_dry adds the
+   next n frames of the drum (Ld/Rd) and synth (Ls/Rs) buses;
+   generator_fast_forward moves the sequencer and voices n frames on
+   without producing audio; generator_finish_block applies delay, mix and
+   limiter (L/R may alias Ld/Rd); generator_advance moves the sequencer
+   past a plan whose events have fired. */
+void generator_render_dry(generator_t *g, float32_t *Ld, float32_t *Rd,
+                          float32_t *Ls, float32_t *Rs, uint32_t n);
+void generator_fast_forward(generator_t *g, uint32_t n);
+void generator_finish_block(generator_t *g, float32_t *L, float32_t *R, uint32_t num_frames,
+                            float32_t *Ld, float32_t *Rd, float32_t *Ls, float32_t *Rs);
+void generator_advance(generator_t *g, const gen_plan_t *plan);
+int  generator_render_parallel(generator_t *g, float32_t *L, float32_t *R, uint32_t num_frames);
+void generator_par_free(generator_t *g);
+int  generator_render_buses(generator_t *g, float32_t *L, float32_t *R, uint32_t num_frames,
+                            float32_t *scratch);
+void generator_bus_free(generator_t *g);
+
+/* Jump to absolute `frame` (the segment loops) so the next
+   generator_process call continues from there.  Voices are rebuilt by
+   replaying the event queue and stepping only their state recurrences (no
+   audio is rendered for them).  The noise RNGs and oscillator phases carry
+   over from loop to loop, so the replay starts from the voice state at a
+   loop start: the generator keeps one checkpoint per loop start a seek has
+   passed, so a seek costs at most one loop of replay once its loop has
+   been reached, and the first seek past the last checkpoint replays the
+   loops in between (checkpointing each).  Only the delay tail -
+   GEN_SEEK_TAIL_REPEATS passes through the delay line, capped at `frame` -
+   is pre-rolled.  With the scalar kernels the voices land on the exact
+   state of a straight render, so the only difference is the truncated
+   delay tail.  generator_set_polyphony drops the checkpoints. */
+#define GEN_SEEK_TAIL_REPEATS 9  /* 0.45 feedback: 0.45^9 < -60 dB */
+void generator_seek(generator_t *g, uint32_t frame);
 void generator_process_voices(generator_t *g, float32_t *Ld, float32_t *Rd,
                               float32_t *Ls, float32_t *Rs, uint32_t num_frames);
 
@@ -71,6 +279,7 @@ void generator_clear_buffers_asm(float32_t *Ld, float32_t *Rd,
 void generator_rotate_pattern_asm(uint8_t *pattern, uint8_t *tmp, 
                                   uint32_t size, uint32_t rot);
 
+/* q must be eq_init()ed; call eq_build_index() afterwards. */
 void generator_build_events_asm(event_queue_t *q, rng_t *rng, 
                                const uint8_t *kick_pat, const uint8_t *snare_pat, const uint8_t *hat_pat,
                                uint32_t step_samples);
@@ -16,5 +16,6 @@ typedef struct {
 void hat_init(hat_t *h, float32_t sr, uint64_t seed);
 void hat_trigger(hat_t *h);
 void hat_process(hat_t *h, float32_t *L, float32_t *R, uint32_t n);
+void hat_skip(hat_t *h, uint32_t n);  /* advance without rendering */
 
 #endif /* HAT_H */ 
\ No newline at end of file
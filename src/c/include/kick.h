@@ -28,6 +28,8 @@ void kick_trigger(kick_t *k);
 
 /* Render `n` samples, adding into stereo buffers L/R. */
 void kick_process(kick_t *k, float32_t *L, float32_t *R, uint32_t n);
+/* Advance `n` samples without rendering (for seeking) */
+void kick_skip(kick_t *k, uint32_t n);
 
 #ifdef __cplusplus
 }
@@ -3,15 +3,73 @@
 
 #include <stdint.h>
 #include <math.h>
+#include "resampler.h"
 
-/* A simple soft-knee stereo limiter. */
+/* Stereo limiter, in one of two modes picked at init.
+ *
+ * LIMITER_SOFT_KNEE (limiter_init) is the original sample-peak limiter: a
+ * per-sample attack/release follower with a 5 dB soft knee, no latency.
+ *
+ * LIMITER_TRUE_PEAK (limiter_init_mode) looks ahead.  Each input frame's
+ * true peak is estimated from the frame and the four 4x-oversampled points
+ * from it to the next, through the resampler's own 4x bank (resampler_bank,
+ * 96 taps per point) so that it reads what a 4x conversion of the output
+ * would, turned into the gain that would hold it LIMITER_TP_MARGIN_DB under
+ * the ceiling, and the smallest such gain over the next
+ * `lookahead` frames (a monotonic deque) is box-averaged over the same
+ * window.  The gain therefore ramps down across the lookahead and reaches
+ * each peak's gain by the time the peak leaves the delay line; it recovers
+ * with the release time constant.  Output lags input by
+ * limiter_latency() frames.  The estimate, the gain division and the gain
+ * multiply are vectorised; only the deque and the running sum are serial.
+ *
+ * USE_ASM builds on arm64 link limiter.s for limiter_process, which
+ * implements LIMITER_SOFT_KNEE only. */
+
+typedef enum {
+    LIMITER_SOFT_KNEE = 0,
+    LIMITER_TRUE_PEAK,
+    LIMITER_MODE_COUNT
+} limiter_mode_t;
+
+#define LIMITER_TP_PHASES         4      /* oversampling factor */
+#define LIMITER_TP_TAPS           RS_TAPS  /* per oversampled point (resampler_bank at 4x) */
+#define LIMITER_TP_AHEAD          (LIMITER_TP_TAPS / 2)  /* frames the estimate reads past its own */
+#define LIMITER_TP_MIN_LOOKAHEAD  LIMITER_TP_AHEAD
+#define LIMITER_TP_MAX_LOOKAHEAD  1024u  /* power of two (deque ring) */
+#define LIMITER_TP_MAX_DELAY      (LIMITER_TP_MAX_LOOKAHEAD + LIMITER_TP_AHEAD - 1)
+#define LIMITER_TP_CHUNK          256
+
+/* Headroom below the ceiling for what the estimate cannot see: the gain
+   changes within the interpolators' span and float rounding */
+#define LIMITER_TP_MARGIN_DB      0.05f
 
+typedef struct {
+    const float32_t *coef;    /* point p/4 after frame e: coef[p * TAPS + j] x frame e + j - (AHEAD - 1) */
+    uint32_t window;          /* lookahead, frames */
+    uint32_t delay;           /* window + LIMITER_TP_AHEAD - 1 */
+    float32_t ceiling;        /* threshold less LIMITER_TP_MARGIN_DB */
+    float32_t release;        /* per-frame recovery coefficient */
+    float32_t gain;           /* gain of the last output frame */
+    double box;               /* sum of hold[] */
+    uint32_t hold_pos;
+    uint32_t dq_head, dq_count;
+    uint32_t frame;           /* index of the next estimate (wraps) */
+    float32_t hold[LIMITER_TP_MAX_LOOKAHEAD];    /* window minimum per frame, last `window` */
+    float32_t dq_val[LIMITER_TP_MAX_LOOKAHEAD];  /* deque: increasing gains ... */
+    uint32_t dq_idx[LIMITER_TP_MAX_LOOKAHEAD];   /* ... and the frames they belong to */
+    float32_t line[2][LIMITER_TP_MAX_DELAY + LIMITER_TP_CHUNK];  /* delay line, `delay` frames kept */
+} limiter_tp_t;
+
+/* limiter.s reads the first five fields at fixed offsets */
 typedef struct {
     float32_t attack_coeff;
     float32_t release_coeff;
     float32_t envelope;
     float32_t threshold;
     float32_t knee_width;
+    limiter_mode_t mode;
+    limiter_tp_t tp;          /* LIMITER_TRUE_PEAK only */
 } limiter_t;
 
 static inline void limiter_init(limiter_t *l, float32_t sr, float32_t attack_ms, float32_t release_ms, float32_t threshold_db)
@@ -21,8 +79,30 @@ static inline void limiter_init(limiter_t *l, float32_t sr, float32_t attack_ms,
     l->envelope = 0.0f;
     l->threshold = powf(10.0f, threshold_db / 20.0f);
     l->knee_width = 5.0f; // 5dB soft knee
+    l->mode = LIMITER_SOFT_KNEE;
+}
+
+/* limiter_init for either mode.  For LIMITER_TRUE_PEAK attack_ms is the
+   lookahead (clamped to LIMITER_TP_MIN..MAX_LOOKAHEAD frames) and
+   threshold_db the true-peak ceiling. */
+void limiter_init_mode(limiter_t *l, limiter_mode_t mode, float32_t sr, float32_t attack_ms,
+                       float32_t release_ms, float32_t threshold_db);
+
+/* Frames between an input frame and its limited output */
+static inline uint32_t limiter_latency(const limiter_t *l)
+{
+    return l->mode == LIMITER_TRUE_PEAK ? l->tp.delay : 0;
 }
 
 void limiter_process(limiter_t *l, float32_t *L, float32_t *R, uint32_t n);
 
-#endif /* LIMITER_H */ 
\ No newline at end of file
+/* LIMITER_TRUE_PEAK body of limiter_process.  Dispatched on x86-64
+   (src/limiter_tp_x86.c). */
+void limiter_tp_process(limiter_t *l, float32_t *L, float32_t *R, uint32_t n);
+
+/* Serial stage shared by every limiter_tp_process: take the gains frames
+   need (req) and write the smoothed gains of the frames leaving the delay
+   line. */
+void limiter_tp_gains(limiter_tp_t *tp, const float32_t *req, float32_t *gain, uint32_t m);
+
+#endif /* LIMITER_H */
@@ -15,5 +15,6 @@ typedef struct {
 void melody_init(melody_t *m, float32_t sr);
 void melody_trigger(melody_t *m, float32_t freq, float32_t dur_sec);
 void melody_process(melody_t *m, float32_t *L, float32_t *R, uint32_t n);
+void melody_skip(melody_t *m, uint32_t n);  /* advance without rendering */
 
 #endif /* MELODY_H */ 
\ No newline at end of file
@@ -3,9 +3,13 @@
 
 #include <stdint.h>
 
-/* Global musical timing constants for the segment renderer. */
+/* Global musical timing constants for the segment renderer.  The sample
+   rate is a run-time property of each music_time_t; SR_DEFAULT is the
+   rate the tools render at unless told otherwise. */
 
-#define SR 44100u
+#define SR_DEFAULT 44100u
+#define SR_MIN      8000u
+#define SR_MAX    192000u
 #define STEPS_PER_BEAT 4u          /* 16th notes */
 #define BARS_PER_SEG 2u
 #define STEPS_PER_BAR (4u * STEPS_PER_BEAT)
@@ -18,16 +22,18 @@ typedef struct {
     uint32_t step_samples;
     float seg_sec;
     uint32_t seg_frames;
+    uint32_t sr;          /* frames per second */
 } music_time_t;
 
-static inline void music_time_init(music_time_t *t, float bpm)
+static inline void music_time_init(music_time_t *t, float bpm, uint32_t sr)
 {
+    t->sr = sr;
     t->bpm = bpm;
     t->beat_sec = 60.0f / t->bpm;
     t->step_sec = t->beat_sec / (float)STEPS_PER_BEAT;
-    t->step_samples = (uint32_t)(t->step_sec * SR + 0.5f);
+    t->step_samples = (uint32_t)(t->step_sec * (float)sr + 0.5f);
     t->seg_sec = t->step_sec * (float)TOTAL_STEPS;
-    t->seg_frames = (uint32_t)(t->seg_sec * SR + 0.5f);
+    t->seg_frames = (uint32_t)(t->seg_sec * (float)sr + 0.5f);
 }
 
 #endif /* MUSIC_TIME_H */ 
\ No newline at end of file
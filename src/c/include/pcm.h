@@ -0,0 +1,57 @@
+#ifndef PCM_H
+#define PCM_H
+
+#include <stdint.h>
+#include "rand.h"
+
+/* Float to interleaved PCM, the last pass of every render.
+ *
+ * pcm_convert takes the planar L/R float mix and writes interleaved stereo
+ * in one pass: 16- or 24-bit little-endian integers (scaled by 2^(bits-1)-1,
+ * saturated to the format's range and rounded to nearest) or 32-bit float
+ * (copied as is; float files keep overs).  With dither on, the integer
+ * formats add TPDF dither of ±1 LSB before rounding: the sum of two
+ * rng_wide_float_mono() draws, halved, per sample.  Draw k of a converter
+ * comes from a counter (rand.h's Weyl state), and the draws of frame f
+ * depend only on f, so the output is the same whatever the block sizes
+ * and bit-identical at every kernel level.  Dispatched on x86-64
+ * (src/pcm_x86.c). */
+
+typedef enum {
+    PCM_S16 = 0,
+    PCM_S24,
+    PCM_F32,
+    PCM_FORMAT_COUNT
+} pcm_format_t;
+
+/* Frames per dither group: frame 16g + j draws 64g + j and 64g + 16 + j
+   for L, 64g + 32 + j and 64g + 48 + j for R */
+#define PCM_DITHER_GROUP 16
+
+typedef struct {
+    pcm_format_t format;
+    int dither;            /* TPDF on S16/S24 */
+    uint64_t state;        /* dither counter base */
+    uint64_t pos;          /* frames converted so far */
+} pcm_conv_t;
+
+static inline uint32_t pcm_sample_bytes(pcm_format_t f)
+{
+    return f == PCM_S16 ? 2 : f == PCM_S24 ? 3 : 4;
+}
+
+void pcm_conv_init(pcm_conv_t *c, pcm_format_t format, int dither, uint64_t seed);
+
+/* Convert n frames to `out` (n * 2 * pcm_sample_bytes bytes) */
+void pcm_convert(pcm_conv_t *c, const float *L, const float *R, uint32_t n, void *out);
+
+/* Scalar body shared by every pcm_convert: n frames, the first of which is
+   frame `pos` of the stream (for the dither); c->pos is left alone */
+void pcm_convert_frames(const pcm_conv_t *c, uint64_t pos, const float *L, const float *R, uint32_t n,
+                        void *out);
+
+const char *pcm_format_name(pcm_format_t f);
+/* "s16", "s24", "f32"; PCM_FORMAT_COUNT if unknown */
+pcm_format_t pcm_format_from_name(const char *name);
+
+#endif /* PCM_H */
@@ -22,6 +22,12 @@ static inline uint64_t rng_next_u64(rng_t *r)
     return z ^ (z >> 31);
 }
 
+/* Jump ahead n draws: SplitMix64's state is a plain counter. */
+static inline void rng_skip(rng_t *r, uint64_t n)
+{
+    r->state += n * 0x9E3779B97F4A7C15ULL;
+}
+
 static inline uint32_t rng_next_u32(rng_t *r)
 {
     return (uint32_t)rng_next_u64(r);
@@ -38,4 +44,27 @@ static inline float rng_float_mono(rng_t *r)
     return rng_next_float(r) * 2.0f - 1.0f; /* -1..1 */
 }
 
+/* Counter-hash stream behind the PCM dither (pcm.h).  Same Weyl state as
+   rng_next_u64 (so rng_skip still jumps it), but each draw folds the
+   state's two halves and applies a 32-bit integer hash instead of the
+   64-bit finaliser, which SIMD lanes can do with native 32-bit multiplies.
+   A different stream from rng_next_u32 for the same state. */
+static inline uint32_t rng_hash32(uint32_t x)
+{
+    x ^= x >> 16; x *= 0x7FEB352DU;
+    x ^= x >> 15; x *= 0x846CA68BU;
+    return x ^ (x >> 16);
+}
+
+static inline uint32_t rng_next_wide_u32(rng_t *r)
+{
+    uint64_t z = (r->state += 0x9E3779B97F4A7C15ULL);
+    return rng_hash32((uint32_t)z ^ (uint32_t)(z >> 32));
+}
+
+static inline float rng_wide_float_mono(rng_t *r)
+{
+    return (rng_next_wide_u32(r) >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f; /* -1..1 */
+}
+
 #endif /* RAND_H */ 
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Streaming polyphase FIR sample-rate converter (stereo, planar L/R).
+ *
+ * out_rate / in_rate reduces to up / down.  The prototype low-pass is one
+ * Kaiser-windowed sinc, cut just below the lower of the two Nyquists and
+ * split into `up` branches of `taps` coefficients; output k is the inner
+ * product of branch (k·down mod up) with the `taps` input frames ending
+ * at floor(k·down / up) + taps/2.  Banks are built the first time a ratio
+ * is asked for and shared read-only by every converter at that ratio
+ * afterwards, so call resampler_init off the audio thread (or once early
+ * for the ratio a realtime path will use).
+ *
+ * resampler_process takes any number of input frames, carries the filter
+ * history between calls and emits every output frame whose taps it has
+ * seen: output lags input by taps/2 input frames and never more, so the
+ * same converter serves block-by-block realtime callbacks and whole-file
+ * renders.  resampler_flush emits the tail once the input has ended; the
+ * flushed stream holds ceil(frames_in · up / down) frames aligned with the
+ * input (output 0 sits at input time 0).
+ *
+ * Ratios whose reduced `up` exceeds RS_MAX_PHASES, or that decimate by more
+ * than RS_MAX_DOWN, are refused. */
+
+#define RS_TAPS        96      /* taps per branch when upsampling (multiple of 16) */
+#define RS_STOP_DB     100.0   /* prototype stopband attenuation */
+#define RS_MAX_PHASES  1024
+#define RS_MAX_DOWN    4       /* largest in_rate / out_rate */
+#define RS_MAX_TAPS    (RS_TAPS * RS_MAX_DOWN)
+#define RS_CHUNK       1024    /* input frames staged per pass */
+#define RS_BANK_SLOTS  8
+
+typedef struct {
+    const float32_t *bank;  /* up branches of taps, each reversed (oldest tap first) */
+    uint32_t in_rate, out_rate;
+    uint32_t up, down;      /* out_rate / in_rate in lowest terms */
+    uint32_t taps;
+    uint32_t step, frac;    /* down / up and down % up: input advance per output */
+
+    /* Stream state.  buf[c][0 .. fill) holds staged input; the next
+       output's window is buf[c][pos .. pos + taps) through branch `phase`. */
+    float32_t *buf[2];
+    uint32_t cap;           /* taps + RS_CHUNK */
+    uint32_t fill;
+    uint32_t pos;
+    uint32_t phase;
+    uint64_t frames_in, frames_out;
+} resampler_t;
+
+/* 0 on success, -1 for an unsupported ratio or out of memory. */
+int  resampler_init(resampler_t *r, uint32_t in_rate, uint32_t out_rate);
+void resampler_free(resampler_t *r);
+/* The shared filter bank resampler_init would use for this ratio: `up`
+   branches of *taps coefficients, each reversed as in resampler_t.bank, so
+   branch p applied to frames e - taps/2 + 1 .. e + taps/2 gives the point
+   p/up of a frame after e.  NULL for a refused ratio.  Same threading rule
+   as resampler_init. */
+const float32_t *resampler_bank(uint32_t in_rate, uint32_t out_rate, uint32_t *taps);
+
+/* Back to the state resampler_init left (silent history). */
+void resampler_reset(resampler_t *r);
+
+/* Most frames one resampler_process call over n input frames can emit. */
+static inline uint32_t resampler_max_out(const resampler_t *r, uint32_t n)
+{
+    return (uint32_t)((uint64_t)n * r->up / r->down) + 2;
+}
+
+/* Input frames between an input and the output that lands on it. */
+static inline uint32_t resampler_latency(const resampler_t *r)
+{
+    return r->taps / 2;
+}
+
+/* Consume inL/inR[0 .. n) and write the frames now computable to outL/outR
+   (room for resampler_max_out(r, n)).  Returns the number written. */
+uint32_t resampler_process(resampler_t *r, const float32_t *inL, const float32_t *inR, uint32_t n,
+                           float32_t *outL, float32_t *outR);
+
+/* End of input: write the remaining frames (room for
+   resampler_max_out(r, resampler_latency(r))).  Reset before reuse. */
+uint32_t resampler_flush(resampler_t *r, float32_t *outL, float32_t *outR);
+
+/* Inner loop: emit up to max frames from the staged input, advancing pos
+   and phase; returns the count.  Dispatched on x86-64
+   (src/resampler_x86.c). */
+uint32_t resampler_run(resampler_t *r, float32_t *outL, float32_t *outR, uint32_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RESAMPLER_H */
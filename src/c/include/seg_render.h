@@ -0,0 +1,66 @@
+#ifndef SEG_RENDER_H
+#define SEG_RENDER_H
+
+#include <stdint.h>
+#include "generator.h"
+#include "resampler.h"
+#include "wav_writer.h"
+#include "pcm.h"
+#include "seg_sidecar.h"
+
+/* Streaming render of a generator into a WAV file.  generator_process runs
+ * in blocks of at most `block` frames; each block is optionally converted
+ * to the delivery rate, converted by pcm_convert (16-bit PCM unless
+ * seg_render_set_format picks another format or dither) and appended to a
+ * wav_stream_t.  Buffers are sized by the block, not the render, so any
+ * duration runs in the same memory.  The limiter's latency
+ * (limiter_latency) is rendered past the end and dropped from the front,
+ * so the file starts on the first frame.  With seg_render_set_sidecar the
+ * render also writes the visualiser's analysis sidecar (seg_sidecar.h)
+ * next to the WAV, its RMS taken from the blocks as they are written;
+ * without it any sidecar already there is deleted, since it describes an
+ * earlier render. */
+
+#define SEG_RENDER_BLOCK 65536u   /* default frames per generator_process call */
+
+typedef struct {
+    uint32_t block;        /* frames per generator_process call */
+    uint32_t sr, out_sr;   /* render and file rates */
+    float32_t *L, *R;      /* block */
+    float32_t *cL, *cR;    /* converted block (out_sr != sr) */
+    void *pcm;             /* interleaved output block, room for any format */
+    resampler_t rs;
+    pcm_conv_t conv;
+    pcm_format_t format;
+    int dither;            /* TPDF, seeded with dither_seed at every render */
+    uint64_t dither_seed;
+    uint32_t vis_fps;      /* sidecar RMS frames per second; 0: no sidecar */
+    float *rms;            /* per video frame of the last render (grows) */
+    uint32_t rms_count, rms_cap;
+    uint32_t rms_spf, rms_fill;   /* frames per RMS frame, and in the current one */
+    double rms_acc;
+} seg_render_t;
+
+typedef struct {
+    uint32_t frames;       /* rendered frames in the file */
+    uint32_t out_frames;   /* frames written, at out_sr */
+    double sum_sq;         /* sum of L² + R² over the rendered frames */
+} seg_render_stats_t;
+
+/* block 0 picks SEG_RENDER_BLOCK; out_sr 0 writes at sr.  Returns -1 if
+   the buffers cannot be allocated or the rates cannot be converted. */
+int  seg_render_init(seg_render_t *r, uint32_t sr, uint32_t out_sr, uint32_t block);
+void seg_render_free(seg_render_t *r);
+/* File format for the following renders (default PCM_S16, no dither) */
+void seg_render_set_format(seg_render_t *r, pcm_format_t format, int dither, uint64_t dither_seed);
+/* Write a sidecar with RMS at `fps` frames per second next to every
+   following WAV (seg_sidecar_path); 0 turns it off (the default) and
+   removes the stale one a WAV may have */
+void seg_render_set_sidecar(seg_render_t *r, uint32_t fps);
+
+/* Render `frames` frames of g (initialised at r->sr) into `path`.  Returns
+   0, or -1 if the file cannot be written; stats may be NULL. */
+int  seg_render_wav(seg_render_t *r, generator_t *g, uint32_t frames, const char *path,
+                    seg_render_stats_t *stats);
+
+#endif /* SEG_RENDER_H */
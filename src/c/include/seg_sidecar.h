@@ -0,0 +1,91 @@
+#ifndef SEG_SIDECAR_H
+#define SEG_SIDECAR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "event_queue.h"
+
+/* Analysis sidecar: what the visualiser needs to know about a rendered WAV,
+ * written next to it by the renderer (seed_0x1234.wav -> seed_0x1234.vis)
+ * so the player can map it instead of analysing the audio.
+ *
+ * One little-endian file, laid out for mmap (every section 4-byte aligned,
+ * offsets from the start of the file):
+ *   seg_sidecar_header_t
+ *   uint32_t step_start[steps + 1]    events of step s: [step_start[s], step_start[s+1])
+ *   seg_sidecar_event_t events[event_count]   one segment, in time order
+ *   float rms[rms_count]              RMS of L and R per video frame
+ * A sidecar belongs to one render: the player uses it only if the WAV still
+ * has sample_rate and wav_frames, and the renderer deletes it when it
+ * rewrites the WAV without one.
+ * Times count frames of the WAV (sample_rate), from its first frame; the
+ * events describe one segment, which the file repeats every loop_frames.
+ * RMS frame f covers WAV frames [f·spf, (f+1)·spf), spf = sample_rate / fps,
+ * and is taken before conversion to PCM. */
+
+#define SEG_SIDECAR_MAGIC   "NDBV"
+#define SEG_SIDECAR_VERSION 3u
+#define SEG_SIDECAR_EXT     ".vis"
+#define SEG_SIDECAR_FPS     60u     /* RMS frames per second written by the tools */
+
+typedef struct {
+    char magic[4];          /* SEG_SIDECAR_MAGIC */
+    uint32_t version;       /* SEG_SIDECAR_VERSION */
+    uint64_t seed;
+    uint32_t sample_rate;   /* of the WAV */
+    uint32_t fps;           /* RMS frames per second */
+    float bpm;
+    float step_frames;      /* WAV frames per step */
+    uint32_t loop_frames;   /* one segment */
+    uint32_t steps;         /* TOTAL_STEPS */
+    uint32_t event_count;
+    uint32_t rms_count;
+    float rms_max;          /* largest rms[] */
+    uint32_t step_offset;
+    uint32_t event_offset;
+    uint32_t rms_offset;
+    uint32_t wav_frames;    /* frames in the WAV it was written with */
+    uint8_t dsp_level;      /* x86 kernels that rendered it: dsp_level_t + 1; 0 = arm64 assembly */
+    uint8_t fm_model;       /* dsp_fm_model_t */
+    uint16_t reserved;
+} seg_sidecar_header_t;
+
+typedef struct {
+    uint32_t frame;         /* WAV frame the event fires on, within the segment */
+    uint8_t type;           /* event_type_t */
+    uint8_t aux;
+    uint8_t variant;
+    uint8_t pad;
+    float freq;
+} seg_sidecar_event_t;
+
+_Static_assert(sizeof(seg_sidecar_header_t) == 72, "sidecar header layout");
+_Static_assert(sizeof(seg_sidecar_event_t) == 12, "sidecar event layout");
+
+/* A mapped sidecar; the pointers point into the mapping */
+typedef struct {
+    void *map;
+    size_t map_size;
+    const seg_sidecar_header_t *hdr;
+    const uint32_t *step_start;
+    const seg_sidecar_event_t *events;
+    const float *rms;
+} seg_sidecar_t;
+
+/* The sidecar path for a WAV path: its extension replaced (or appended) */
+void seg_sidecar_path(const char *wav_path, char *out, size_t cap);
+
+/* Write a sidecar.  Event times in q count render frames at render_sr and
+   are converted to the WAV's rate (hdr->sample_rate); hdr supplies the
+   scalar fields (bpm, step_frames, loop_frames, seed, fps, wav_frames),
+   the rest are filled in here.  0 on success, -1 (with perror) otherwise. */
+int  seg_sidecar_write(const char *path, const seg_sidecar_header_t *hdr, const event_queue_t *q,
+                       uint32_t render_sr, const float *rms, uint32_t rms_count);
+
+/* Map and validate a sidecar; 0 on success, -1 if it is missing or does
+   not hold together (wrong magic or version, more than TOTAL_STEPS steps,
+   sections out of the file). */
+int  seg_sidecar_map(seg_sidecar_t *s, const char *path);
+void seg_sidecar_unmap(seg_sidecar_t *s);
+
+#endif /* SEG_SIDECAR_H */
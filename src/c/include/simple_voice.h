@@ -2,14 +2,16 @@
 #define SIMPLE_VOICE_H
 
 #include <stdint.h>
-#include "osc.h"
+#include "wavetable.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /* Simple oscillator voice with exponential decay envelope.
-   Supports sine, triangle, square waveforms. */
+   Supports sine, triangle, square waveforms, read band-limited from the
+   shared wavetables (wavetable.h).  The envelope is read from a shared
+   table (env.h) or, when none is available, stepped as env *= coef. */
 
 typedef enum {
     SIMPLE_SINE = 0,
@@ -18,7 +20,8 @@ typedef enum {
 } simple_wave_t;
 
 typedef struct {
-    osc_t osc;
+    uint32_t phase;            /* Q32 turns */
+    uint32_t inc;              /* Q32 turns per sample */
     uint32_t len;
     uint32_t pos;
     float32_t sr;
@@ -26,11 +29,15 @@ typedef struct {
     float32_t amp;
     simple_wave_t wave;
     float32_t freq;
+    const float32_t *env_tab;  /* exp(-decay·pos/sr) for pos < len, or NULL */
+    float32_t env;             /* recurrence mode: current level */
+    float32_t env_coef;        /* recurrence mode: per-sample factor */
 } simple_voice_t;
 
 void simple_voice_init(simple_voice_t *v, float32_t sr);
 void simple_voice_trigger(simple_voice_t *v, float32_t freq, float32_t dur_sec, simple_wave_t wave, float32_t amp, float32_t decay);
 void simple_voice_process(simple_voice_t *v, float32_t *L, float32_t *R, uint32_t n);
+void simple_voice_skip(simple_voice_t *v, uint32_t n);  /* advance without rendering */
 
 #ifdef __cplusplus
 }
@@ -16,5 +16,6 @@ typedef struct {
 void snare_init(snare_t *s, float32_t sr, uint64_t seed);
 void snare_trigger(snare_t *s);
 void snare_process(snare_t *s, float32_t *L, float32_t *R, uint32_t n);
+void snare_skip(snare_t *s, uint32_t n);  /* advance without rendering */
 
 #endif /* SNARE_H */ 
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+/* Binary event trace for the audio path.
+ *
+ * Voice triggers, step events and block boundaries are recorded as fixed
+ * 32-byte records into a lock-free ring instead of going through stdio.
+ * Producers (the render threads) never block or allocate: when the ring is
+ * full the record is dropped and counted.  A writer thread started with
+ * trace_start() drains the ring into a file; bin/trace_dump prints it.
+ *
+ * Tracing is compiled in only with -DNDB_TRACE (make TRACE=1).  Without it
+ * every TRACE_* macro expands to ((void)0) and its arguments are not
+ * evaluated, so release builds carry no trace code at all.  With it, the
+ * macros cost one relaxed atomic load until trace_start() is called. */
+
+typedef enum {
+    TRACE_KICK = 1,     /* p: len, env_coef, y_prev2, k1 */
+    TRACE_SNARE,        /* p: len */
+    TRACE_HAT,          /* p: len, env_coef */
+    TRACE_MELODY,       /* p: freq, dur_sec, len */
+    TRACE_FM,           /* p: carrier_freq, dur_sec, ratio, index */
+    TRACE_SIMPLE,       /* aux: wave, p: freq, dur_sec, amp */
+    TRACE_STEP_EVENT,   /* aux: event type, p: event aux, freq, variant */
+    TRACE_STEP_END,     /* aux: unused, p: event_idx */
+    TRACE_BLOCK,        /* stamped at block end, p: frames, delay size, delay idx */
+} trace_type_t;
+
+typedef struct {
+    uint16_t type;      /* trace_type_t */
+    uint16_t aux;
+    uint32_t step;      /* sequencer step at the time of the record */
+    uint32_t sample;    /* absolute frame within the segment */
+    uint32_t seq;       /* global record number, gaps mark drops */
+    float    p[4];      /* type-specific parameters, see trace_type_t */
+} trace_record_t;
+
+#define TRACE_MAGIC   "NDBTRACE"
+#define TRACE_VERSION 1u
+
+/* File layout: this header followed by `count` trace_record_t. */
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t count;
+    uint64_t dropped;
+} trace_file_header_t;
+
+#ifdef NDB_TRACE
+
+/* Start/stop the drain thread.  path NULL uses $NDB_TRACE_FILE or
+ * "trace.bin".  Returns 0 on success. */
+int  trace_start(const char *path);
+void trace_stop(void);
+
+/* Set the (step, sample) stamp for records emitted by this thread. */
+void trace_cursor(uint32_t step, uint32_t sample);
+void trace_emit(trace_type_t type, uint16_t aux,
+                float p0, float p1, float p2, float p3);
+
+#define TRACE_CURSOR(step, sample)  trace_cursor((step), (sample))
+#define TRACE_EMIT(type, aux, p0, p1, p2, p3) \
+    trace_emit((type), (uint16_t)(aux), (float)(p0), (float)(p1), (float)(p2), (float)(p3))
+
+#else
+
+static inline int  trace_start(const char *path) { (void)path; return -1; }
+static inline void trace_stop(void) {}
+
+#define TRACE_CURSOR(step, sample)            ((void)0)
+#define TRACE_EMIT(type, aux, p0, p1, p2, p3) ((void)0)
+
+#endif /* NDB_TRACE */
+
+#endif /* TRACE_H */
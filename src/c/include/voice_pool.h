@@ -0,0 +1,75 @@
+#ifndef VOICE_POOL_H
+#define VOICE_POOL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Fixed-capacity voice allocator.
+ *
+ * The pool hands out slots of a voice array its owner keeps (kick_t
+ * kick[VOICE_POOL_MAX], ...) and never allocates.  Live voices are listed
+ * densely, oldest first, in live[0..count), so a render loop touches only
+ * them:
+ *
+ *     for(uint32_t i = 0; i < p->count; i++)
+ *         kick_process(&kick[p->live[i]], L, R, n);
+ *     voice_pool_advance(p, n);
+ *
+ * A voice's length is known when it starts, so the pool retires it by its
+ * own frame clock instead of asking the voice.  Which slots are live - and
+ * the order they render and sum in - therefore depends only on the
+ * triggers and the frame count, not on the run sizes the owner advances
+ * in, so skipped, seeked and parallel renders assign voices identically.
+ *
+ * A trigger with every slot busy steals one: the oldest voice, or the one
+ * whose estimated level amp·coef^age is lowest (ties go to the oldest). */
+#define VOICE_POOL_MAX 32
+
+typedef enum {
+    VOICE_STEAL_OLDEST = 0,
+    VOICE_STEAL_QUIETEST
+} voice_steal_t;
+
+typedef struct {
+    uint8_t cap;                        /* slots in use, 1..VOICE_POOL_MAX */
+    uint8_t count;                      /* live voices */
+    uint8_t steal;                      /* voice_steal_t */
+    uint8_t live[VOICE_POOL_MAX];       /* slots of the live voices, oldest first */
+    uint32_t used;                      /* bit per live slot */
+    uint32_t clock;                     /* frames since reset (wraps) */
+    uint32_t steals;                    /* triggers that cut a live voice */
+    /* Per slot */
+    uint32_t start[VOICE_POOL_MAX];     /* clock at trigger */
+    uint32_t end[VOICE_POOL_MAX];       /* clock at which it falls silent */
+    float32_t log_amp[VOICE_POOL_MAX];  /* ln(peak level) */
+    float32_t log_coef[VOICE_POOL_MAX]; /* ln(per-frame level decay) */
+} voice_pool_t;
+
+/* cap is clamped to 1..VOICE_POOL_MAX; a pool of one behaves like a single
+   voice that every trigger restarts. */
+void voice_pool_init(voice_pool_t *p, uint32_t cap, voice_steal_t steal);
+
+/* Silence every voice; capacity and stealing policy are kept. */
+void voice_pool_reset(voice_pool_t *p);
+
+/* Slot for a new voice: the lowest free one, else a stolen one.  The slot
+   is live (newest) from here on; trigger the voice in it, then call
+   voice_pool_start. */
+int voice_pool_alloc(voice_pool_t *p);
+
+/* The voice in `slot` lasts len frames from now, starting at level amp and
+   decaying by about coef per frame (the stealing estimate only). */
+void voice_pool_start(voice_pool_t *p, int slot, uint32_t len,
+                      float32_t amp, float32_t coef);
+
+/* Move the clock n frames on and retire the voices that ended. */
+void voice_pool_advance(voice_pool_t *p, uint32_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VOICE_POOL_H */
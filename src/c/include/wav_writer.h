@@ -2,6 +2,8 @@
 #define WAV_WRITER_H
 
 #include <stdint.h>
+#include <stdio.h>
+#include "pcm.h"
 
 /*
  * Write a little-endian 16-bit PCM WAV file.
@@ -17,4 +19,34 @@ void write_wav(const char *path,
                uint16_t num_channels,
                uint32_t sample_rate);
 
-#endif /* WAV_WRITER_H */ 
\ No newline at end of file
+/*
+ * Streaming writer for files rendered block by block.  wav_stream_open
+ * writes the header with zero sizes, wav_stream_append adds interleaved
+ * frames, and wav_stream_close patches the RIFF and data sizes and closes
+ * the file.  Memory use is independent of the file's length.
+ * wav_stream_open writes 16-bit PCM; wav_stream_open_format any pcm.h
+ * format (24-bit PCM, or 32-bit IEEE float with a fact chunk).  Files with
+ * more than 16 bits or 2 channels use WAVE_FORMAT_EXTENSIBLE.  A RIFF file
+ * holds at most 4 GiB: append refuses frames past that and fails.
+ * Functions return 0 on success, -1 on error (reported with perror, and
+ * sticky: close then fails too, leaving a file with the sizes of what was
+ * written).
+ */
+typedef struct {
+    FILE *f;
+    uint16_t num_channels;
+    uint16_t block_align;   /* bytes per frame */
+    uint32_t frames;        /* appended so far */
+    uint32_t header_bytes;  /* up to the data chunk's samples */
+    uint32_t fact_offset;   /* of the fact chunk's frame count; 0 if none */
+    int error;
+} wav_stream_t;
+
+int wav_stream_open(wav_stream_t *s, const char *path, uint16_t num_channels, uint32_t sample_rate);
+int wav_stream_open_format(wav_stream_t *s, const char *path, uint16_t num_channels, uint32_t sample_rate,
+                           pcm_format_t format);
+/* `samples`: interleaved frames of the stream's format, block_align bytes each */
+int wav_stream_append(wav_stream_t *s, const void *samples, uint32_t frames);
+int wav_stream_close(wav_stream_t *s);
+
+#endif /* WAV_WRITER_H */
@@ -0,0 +1,91 @@
+#ifndef WAVETABLE_H
+#define WAVETABLE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Band-limited wavetables.
+ *
+ * Each shape is stored as a mip-map of single-cycle tables, one per
+ * octave: level k is the Fourier series of the ideal waveform cut at
+ * WT_MAX_HARMONICS >> k harmonics.  A voice picks the level whose top
+ * harmonic stays below Nyquist for its pitch (wavetable_for, once per
+ * block) and reads it with linear interpolation, so saw/square/triangle
+ * come out alias-free without oversampling.  The sine table is the
+ * single-harmonic level every shape ends in.
+ *
+ * The tables are built once by wavetable_init (thread-safe, idempotent;
+ * generator_init calls it) and are read-only afterwards, shared by every
+ * voice and thread.
+ *
+ * Phases are Q32 turns (2^32 = one cycle), so a phase advanced n frames
+ * in one step or in n single steps lands on the same value, whatever the
+ * block sizes. */
+
+typedef enum {
+    WT_SINE = 0,
+    WT_SAW,        /* rising, -1 -> 1 */
+    WT_SQUARE,     /* +1 for the first half cycle */
+    WT_TRIANGLE,   /* 1 at phase 0, -1 at half cycle */
+    WT_SHAPE_COUNT
+} wt_shape_t;
+
+#define WT_LEN_LOG2      11
+#define WT_LEN           (1u << WT_LEN_LOG2)   /* samples per cycle */
+#define WT_STRIDE        (WT_LEN + 16)         /* guard point, keeps levels 64-byte aligned */
+#define WT_LEVELS        10
+#define WT_MAX_HARMONICS (1u << (WT_LEVELS - 1))  /* level 0; 4x below the table's Nyquist */
+
+void wavetable_init(void);
+
+/* Table (WT_LEN + 1 entries, the last repeating the first) for `shape` at
+   a phase increment of inc Q32 turns per sample. */
+const float32_t *wavetable_for(wt_shape_t shape, uint32_t inc);
+
+/* Q32 increment for freq at sample rate sr (freq below sr / 2). */
+static inline uint32_t wavetable_inc(float32_t freq, float32_t sr)
+{
+    return (uint32_t)((double)freq / (double)sr * 4294967296.0 + 0.5);
+}
+
+/* Write n samples of `tab` read from *phase on, stepping inc per sample,
+   and leave *phase after the last one.  Dispatched on x86-64
+   (src/wavetable_x86.c). */
+void wavetable_block(const float32_t *tab, uint32_t *phase, uint32_t inc, float32_t *out, uint32_t n);
+
+#define WT_FRAC_BITS (32 - WT_LEN_LOG2)
+
+/* Portable wavetable_block; the SIMD kernels match it bit for bit. */
+static inline void wavetable_block_ref(const float32_t *tab, uint32_t *phase, uint32_t inc,
+                                       float32_t *out, uint32_t n)
+{
+    const float32_t scale = 1.0f / (float32_t)(1u << WT_FRAC_BITS);
+    uint32_t ph = *phase;
+    for(uint32_t i = 0; i < n; i++, ph += inc){
+        const uint32_t j = ph >> WT_FRAC_BITS;
+        const float32_t f = (float32_t)(ph & ((1u << WT_FRAC_BITS) - 1)) * scale;
+        out[i] = tab[j] + f * (tab[j + 1] - tab[j]);
+    }
+    *phase = ph;
+}
+
+/* osc_t phases are radians in [0, TAU) */
+static inline uint32_t wavetable_phase_from_rad(float32_t rad)
+{
+    return (uint32_t)(uint64_t)((double)rad * (4294967296.0 / 6.28318530717958647692));
+}
+
+static inline float32_t wavetable_phase_to_rad(uint32_t phase)
+{
+    float32_t rad = (float32_t)((double)phase * (6.28318530717958647692 / 4294967296.0));
+    return rad < 6.28318530717958647692f ? rad : 0.0f;  /* rounded up to TAU */
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WAVETABLE_H */
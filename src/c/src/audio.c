@@ -0,0 +1,87 @@
+#include "audio_backend.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Backend selection and the public coreaudio.h entry points, forwarded to
+ * the chosen table.  Backends not compiled in have a NULL slot. */
+
+static const audio_backend_ops_t *const k_backends[AUDIO_BACKEND_COUNT] = {
+#ifdef AUDIO_HAVE_COREAUDIO
+    [AUDIO_BACKEND_COREAUDIO] = &audio_backend_coreaudio,
+#endif
+#ifdef AUDIO_HAVE_SDL
+    [AUDIO_BACKEND_SDL] = &audio_backend_sdl,
+#endif
+    [AUDIO_BACKEND_NULL] = &audio_backend_null,
+};
+
+static const char *const k_names[AUDIO_BACKEND_COUNT] = { "coreaudio", "sdl", "null" };
+
+static audio_backend_id_t s_backend = AUDIO_BACKEND_COUNT;   /* not chosen yet */
+static const audio_backend_ops_t *s_open;                    /* between init and stop */
+
+int audio_backend_available(audio_backend_id_t id)
+{
+    return id < AUDIO_BACKEND_COUNT && k_backends[id] != NULL;
+}
+
+const char *audio_backend_name(audio_backend_id_t id)
+{
+    return id < AUDIO_BACKEND_COUNT ? k_names[id] : "unknown";
+}
+
+audio_backend_id_t audio_backend_from_name(const char *name)
+{
+    for (int i = 0; i < AUDIO_BACKEND_COUNT; i++)
+        if (name && strcmp(name, k_names[i]) == 0) return (audio_backend_id_t)i;
+    return AUDIO_BACKEND_COUNT;
+}
+
+int audio_select(audio_backend_id_t id)
+{
+    if (!audio_backend_available(id)) return -1;
+    s_backend = id;
+    return 0;
+}
+
+audio_backend_id_t audio_backend(void)
+{
+    if (s_backend != AUDIO_BACKEND_COUNT) return s_backend;
+    audio_backend_id_t id = AUDIO_BACKEND_NULL;
+    for (int i = 0; i < AUDIO_BACKEND_COUNT; i++)
+        if (k_backends[i]) { id = (audio_backend_id_t)i; break; }
+    const char *env = getenv("NDB_AUDIO");
+    if (env && *env) {
+        audio_backend_id_t want = audio_backend_from_name(env);
+        if (audio_backend_available(want)) id = want;
+        else fprintf(stderr, "NDB_AUDIO=%s not available in this build, using %s\n", env, k_names[id]);
+    }
+    s_backend = id;
+    return id;
+}
+
+int audio_init(uint32_t sr, uint32_t buffer_size, audio_callback_t callback, void* user_data)
+{
+    const audio_backend_ops_t *b = k_backends[audio_backend()];
+    if (b->init(sr, buffer_size, callback, user_data) != 0) return 1;
+    s_open = b;
+    return 0;
+}
+
+void audio_start(void)
+{
+    if (s_open) s_open->start();
+}
+
+void audio_stop(void)
+{
+    if (s_open) s_open->stop();
+    s_open = NULL;
+}
+
+int audio_get_stats(audio_stats_t *stats)
+{
+    const audio_backend_ops_t *b = k_backends[audio_backend()];
+    return b->get_stats ? b->get_stats(stats) : -1;
+}
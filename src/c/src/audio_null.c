@@ -0,0 +1,171 @@
+// Null audio backend: no device, a thread that stands in for one.
+//
+// The thread asks the callback for one buffer at a time on a clock of its
+// own.  Paced, it sleeps until each buffer is due (k periods after start),
+// so the callback runs on the same schedule a device would impose and the
+// stats show how late the thread woke (jitter) and how often a callback
+// finished after the buffer was needed (a miss, i.e. an underrun).  After a
+// miss the schedule restarts from the late finish rather than bursting to
+// catch up, as a device resuming after an underrun would.  Unpaced, buffers
+// are requested back to back and each one's deadline is a period after it
+// started, so the run takes only as long as the rendering and the stats
+// measure headroom directly.  Either way the output can be written to a
+// float WAV (the sink); the write follows the timed callback, so a slow
+// disk shows up as jitter in paced runs.
+#define _POSIX_C_SOURCE 200809L
+#include "audio_backend.h"
+#include "wav_writer.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    audio_callback_t user_callback;
+    void *user_data;
+    uint32_t sr;
+    uint32_t frames;
+    float *buf;
+    int paced;
+    const char *sink_path;
+    wav_stream_t sink;
+    int have_sink;
+
+    pthread_t thread;
+    int thread_started;
+    _Atomic int running;
+
+    pthread_mutex_t lock;         /* guards stats and the sums below */
+    audio_stats_t stats;
+    double jitter_sum_us, callback_sum_us;
+} null_audio_state_t;
+
+static null_audio_state_t g_null = { .paced = 1, .lock = PTHREAD_MUTEX_INITIALIZER };
+static int g_null_configured;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_until(uint64_t t)
+{
+    for (uint64_t now = now_ns(); now < t; now = now_ns()) {
+        const uint64_t d = t - now;
+        struct timespec ts = { (time_t)(d / 1000000000ull), (long)(d % 1000000000ull) };
+        nanosleep(&ts, NULL);
+    }
+}
+
+static void *null_audio_main(void *arg)
+{
+    null_audio_state_t *s = (null_audio_state_t *)arg;
+    const uint64_t period = (uint64_t)s->frames * 1000000000ull / s->sr;
+    uint64_t due = now_ns();   /* when the current buffer should start */
+
+    while (atomic_load_explicit(&s->running, memory_order_acquire)) {
+        if (s->paced) sleep_until(due);
+        const uint64_t start = now_ns();
+        if (!s->paced) due = start;
+        s->user_callback(s->buf, s->frames, s->user_data);
+        const uint64_t end = now_ns();
+
+        const uint64_t deadline = due + period;
+        const int miss = end > deadline;
+        const double jitter_us = start > due ? (start - due) / 1e3 : 0.0;
+        const double callback_us = (end - start) / 1e3;
+        pthread_mutex_lock(&s->lock);
+        audio_stats_t *st = &s->stats;
+        st->callbacks++;
+        st->frames += s->frames;
+        st->misses += miss;
+        s->jitter_sum_us += jitter_us;
+        s->callback_sum_us += callback_us;
+        if (jitter_us > st->jitter_max_us) st->jitter_max_us = jitter_us;
+        if (callback_us > st->callback_max_us) st->callback_max_us = callback_us;
+        pthread_mutex_unlock(&s->lock);
+
+        if (s->have_sink) wav_stream_append(&s->sink, s->buf, s->frames);
+        due = miss ? end : deadline;
+    }
+    return NULL;
+}
+
+void audio_null_configure(const char *sink_path, int paced)
+{
+    g_null.sink_path = sink_path;
+    g_null.paced = paced;
+    g_null_configured = 1;
+}
+
+static int null_audio_init(uint32_t sr, uint32_t buffer_size, audio_callback_t callback, void *user_data)
+{
+    if (sr == 0 || buffer_size == 0 || !callback) return 1;
+    g_null.user_callback = callback;
+    g_null.user_data = user_data;
+    g_null.sr = sr;
+    g_null.frames = buffer_size;
+    if (!g_null_configured) g_null.sink_path = getenv("NDB_AUDIO_SINK");
+    g_null.buf = calloc((size_t)buffer_size * 2, sizeof(float));
+    if (!g_null.buf) return 1;
+
+    g_null.have_sink = 0;
+    if (g_null.sink_path && *g_null.sink_path) {
+        if (wav_stream_open_format(&g_null.sink, g_null.sink_path, 2, sr, PCM_F32) != 0) {
+            fprintf(stderr, "null audio: cannot write %s\n", g_null.sink_path);
+            free(g_null.buf);
+            g_null.buf = NULL;
+            return 1;
+        }
+        g_null.have_sink = 1;
+    }
+
+    pthread_mutex_lock(&g_null.lock);
+    memset(&g_null.stats, 0, sizeof(g_null.stats));
+    g_null.stats.period_us = buffer_size * 1e6 / sr;
+    g_null.jitter_sum_us = g_null.callback_sum_us = 0.0;
+    pthread_mutex_unlock(&g_null.lock);
+    return 0;
+}
+
+static void null_audio_start(void)
+{
+    if (g_null.thread_started) return;
+    atomic_store_explicit(&g_null.running, 1, memory_order_release);
+    if (pthread_create(&g_null.thread, NULL, null_audio_main, &g_null) != 0) {
+        fprintf(stderr, "null audio: cannot start the clock thread\n");
+        atomic_store(&g_null.running, 0);
+        return;
+    }
+    g_null.thread_started = 1;
+}
+
+static void null_audio_stop(void)
+{
+    atomic_store_explicit(&g_null.running, 0, memory_order_release);
+    if (g_null.thread_started) pthread_join(g_null.thread, NULL);
+    g_null.thread_started = 0;
+    if (g_null.have_sink) wav_stream_close(&g_null.sink);
+    g_null.have_sink = 0;
+    free(g_null.buf);
+    g_null.buf = NULL;
+}
+
+static int null_audio_get_stats(audio_stats_t *stats)
+{
+    pthread_mutex_lock(&g_null.lock);
+    *stats = g_null.stats;
+    if (stats->callbacks) {
+        stats->jitter_mean_us = g_null.jitter_sum_us / stats->callbacks;
+        stats->callback_mean_us = g_null.callback_sum_us / stats->callbacks;
+    }
+    pthread_mutex_unlock(&g_null.lock);
+    return 0;
+}
+
+const audio_backend_ops_t audio_backend_null = { null_audio_init, null_audio_start, null_audio_stop,
+                                                 null_audio_get_stats };
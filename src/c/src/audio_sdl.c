@@ -0,0 +1,69 @@
+#include "audio_backend.h"
+#ifdef float32_t
+#undef float32_t
+#endif
+#include <SDL.h>
+#include <stdio.h>
+
+/* SDL2 audio (PulseAudio, PipeWire, ALSA, ... whichever SDL finds).  The
+ * device is opened for interleaved stereo float at the requested rate and
+ * buffer size; SDL converts if the hardware wants something else, and may
+ * ask for a different number of frames per callback, which is passed on. */
+
+typedef struct {
+    SDL_AudioDeviceID dev;
+    audio_callback_t  user_callback;
+    void             *user_data;
+} sdl_audio_state_t;
+
+static sdl_audio_state_t g_sdl;
+
+static void sdl_audio_callback(void *userdata, Uint8 *stream, int len)
+{
+    sdl_audio_state_t *state = (sdl_audio_state_t *)userdata;
+    const uint32_t frames = (uint32_t)len / (sizeof(float) * 2);
+    if (state->user_callback) state->user_callback((float *)stream, frames, state->user_data);
+    else SDL_memset(stream, 0, (size_t)len);
+}
+
+static int sdl_audio_init(uint32_t sr, uint32_t buffer_size, audio_callback_t callback, void *user_data)
+{
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0) {
+        fprintf(stderr, "SDL audio init failed: %s\n", SDL_GetError());
+        return 1;
+    }
+    g_sdl.user_callback = callback;
+    g_sdl.user_data = user_data;
+
+    SDL_AudioSpec want, have;
+    SDL_zero(want);
+    want.freq = (int)sr;
+    want.format = AUDIO_F32SYS;
+    want.channels = 2;
+    want.samples = (Uint16)buffer_size;
+    want.callback = sdl_audio_callback;
+    want.userdata = &g_sdl;
+    g_sdl.dev = SDL_OpenAudioDevice(NULL, 0, &want, &have, 0);
+    if (g_sdl.dev == 0) {
+        fprintf(stderr, "SDL_OpenAudioDevice failed: %s\n", SDL_GetError());
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return 1;
+    }
+    if (have.samples != want.samples)
+        fprintf(stderr, "SDL audio: %u-frame buffers (asked for %u)\n", have.samples, want.samples);
+    return 0;
+}
+
+static void sdl_audio_start(void)
+{
+    SDL_PauseAudioDevice(g_sdl.dev, 0);
+}
+
+static void sdl_audio_stop(void)
+{
+    if (g_sdl.dev) SDL_CloseAudioDevice(g_sdl.dev);
+    g_sdl.dev = 0;
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+}
+
+const audio_backend_ops_t audio_backend_sdl = { sdl_audio_init, sdl_audio_start, sdl_audio_stop, NULL };
@@ -0,0 +1,174 @@
+// bench_delay – ping-pong delay: the per-frame loop vs the run-split
+// kernels, interleaved and planar rings.
+//
+// FRAMES frames of noise go through a delay of each length in BLOCK-frame
+// calls three ways: with the loop delay_process_block used before the
+// kernels split blocks at the wrap point (one frame per iteration and an
+// index check each; a copy of the old delay.c), and through
+// delay_process_block with an interleaved and with a planar ring.  On
+// x86-64 the kernel rows repeat for every dispatch level; on arm64 USE_ASM
+// builds they time delay.s.  Times are ns per frame, best of REPS.  Short
+// delays split every block into many runs, so they show the cost of the
+// split; long ones the vector body.  The x86 kernels must match the loop
+// exactly (same multiply and add per sample); delay.s fuses them, so it
+// differs by float rounding.
+//
+// Usage: bench_delay [--block=FRAMES]
+#define _POSIX_C_SOURCE 199309L
+#include "delay.h"
+#ifdef DSP_DISPATCH
+#include "dsp_dispatch.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define FRAMES (10 * 44100)
+#define BLOCK 256
+#define REPS 5
+#define FEEDBACK 0.45f
+#define MAX_ERR 1e-5f
+
+static const uint32_t k_sizes[] = { 3, 61, 1000, 5512, 22050 };
+#define N_SIZES (sizeof(k_sizes) / sizeof(k_sizes[0]))
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* delay_process_block as it was: one interleaved frame per iteration */
+static void ref_delay(delay_t *d, float *L, float *R, uint32_t n, float feedback)
+{
+    float *buf = d->buf;
+    uint32_t idx = d->idx;
+    const uint32_t size = d->size;
+    for (uint32_t i = 0; i < n; ++i) {
+        float yl = buf[idx * 2];
+        float yr = buf[idx * 2 + 1];
+        float dryL = L[i];
+        float dryR = R[i];
+        buf[idx * 2]     = dryL + yr * feedback;
+        buf[idx * 2 + 1] = dryR + yl * feedback;
+        L[i] = dryL + yl;
+        R[i] = dryR + yr;
+        idx++;
+        if (idx >= size) idx = 0;
+    }
+    d->idx = idx;
+}
+
+typedef struct {
+    const float *inL, *inR;
+    float *L, *R, *ring;
+    uint32_t block;
+} bench_t;
+
+/* Runs the whole input through one delay; returns the best ns per frame */
+static double run(bench_t *b, uint32_t size, int ref, delay_layout_t layout)
+{
+    double best = 1e30;
+    for (int r = 0; r < REPS; ++r) {
+        delay_t d;
+        delay_init_layout(&d, b->ring, size, layout);
+        memcpy(b->L, b->inL, sizeof(float) * FRAMES);
+        memcpy(b->R, b->inR, sizeof(float) * FRAMES);
+        double t0 = now_ns();
+        for (uint32_t i = 0; i < FRAMES; i += b->block) {
+            uint32_t len = FRAMES - i < b->block ? FRAMES - i : b->block;
+            if (ref) ref_delay(&d, b->L + i, b->R + i, len, FEEDBACK);
+            else delay_process_block(&d, b->L + i, b->R + i, len, FEEDBACK);
+        }
+        double t = (now_ns() - t0) / FRAMES;
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+static float max_err(const bench_t *b, const float *refL, const float *refR)
+{
+    float e = 0.0f;
+    for (uint32_t i = 0; i < FRAMES; ++i)
+        e = fmaxf(e, fmaxf(fabsf(b->L[i] - refL[i]), fabsf(b->R[i] - refR[i])));
+    return e;
+}
+
+/* One row: both layouts at the current kernel level against the loop */
+static int bench_row(const char *name, bench_t *b, const double *ref_ns, float *const refs[N_SIZES][2])
+{
+    int bad = 0;
+    printf("%-16s", name);
+    for (uint32_t s = 0; s < N_SIZES; ++s) {
+        double ns[2];
+        float err = 0.0f;
+        for (int lay = 0; lay < 2; ++lay) {
+            ns[lay] = run(b, k_sizes[s], 0, lay ? DELAY_PLANAR : DELAY_INTERLEAVED);
+            err = fmaxf(err, max_err(b, refs[s][0], refs[s][1]));
+        }
+        bad |= err > MAX_ERR;
+        printf("  %5.2f %5.2f %4.1fx", ns[0], ns[1], ref_ns[s] / ns[1]);
+    }
+    printf("%s\n", bad ? "  MISMATCH" : "");
+    return bad;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t block = BLOCK;
+    for (int i = 1; i < argc; ++i)
+        if (strncmp(argv[i], "--block=", 8) == 0) block = (uint32_t)strtoul(argv[i] + 8, NULL, 0);
+    if (block == 0) return 1;
+
+    float *inL = malloc(sizeof(float) * FRAMES), *inR = malloc(sizeof(float) * FRAMES);
+    bench_t b = { inL, inR, malloc(sizeof(float) * FRAMES), malloc(sizeof(float) * FRAMES),
+                  malloc(sizeof(float) * 2 * k_sizes[N_SIZES - 1]), block };
+    float *refs[N_SIZES][2];
+    for (uint32_t s = 0; s < N_SIZES; ++s)
+        for (int c = 0; c < 2; ++c)
+            if (!(refs[s][c] = malloc(sizeof(float) * FRAMES))) return 1;
+    if (!inL || !inR || !b.L || !b.R || !b.ring) return 1;
+
+    /* Noise in short bursts, so the feedback tail carries through silence */
+    uint32_t x = 0x12345678u;
+    for (uint32_t i = 0; i < FRAMES; ++i) {
+        x = x * 1664525u + 1013904223u;
+        const float v = ((i / 4410) % 4 == 0) ? (float)(int32_t)x * (0.25f / 2147483648.0f) : 0.0f;
+        inL[i] = v;
+        inR[i] = -0.5f * v;
+    }
+
+    double ref_ns[N_SIZES];
+    for (uint32_t s = 0; s < N_SIZES; ++s) {
+        ref_ns[s] = run(&b, k_sizes[s], 1, DELAY_INTERLEAVED);
+        memcpy(refs[s][0], b.L, sizeof(float) * FRAMES);
+        memcpy(refs[s][1], b.R, sizeof(float) * FRAMES);
+    }
+
+    printf("Ping-pong delay: %d frames in %u-frame calls, ns/frame (interleaved, planar,\n"
+           "planar speedup over the per-frame loop), best of %d\n", FRAMES, block, REPS);
+    printf("%-16s", "delay frames");
+    for (uint32_t s = 0; s < N_SIZES; ++s) printf("  %17u", k_sizes[s]);
+    printf("\n%-16s", "per-frame loop");
+    for (uint32_t s = 0; s < N_SIZES; ++s) printf("  %5.2f %11s", ref_ns[s], "");
+    printf("\n");
+
+    int fail = 0;
+#ifdef DSP_DISPATCH
+    for (int lvl = 0; lvl < DSP_LEVEL_COUNT; ++lvl) {
+        if (dsp_dispatch_select((dsp_level_t)lvl) != 0) continue;
+        fail |= bench_row(dsp_level_name((dsp_level_t)lvl), &b, ref_ns, refs);
+    }
+#elif defined(DELAY_ASM)
+    fail |= bench_row("delay.s", &b, ref_ns, refs);
+#else
+    fail |= bench_row("delay.c", &b, ref_ns, refs);
+#endif
+
+    for (uint32_t s = 0; s < N_SIZES; ++s) { free(refs[s][0]); free(refs[s][1]); }
+    free(inL); free(inR); free(b.L); free(b.R); free(b.ring);
+    return fail;
+}
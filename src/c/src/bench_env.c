@@ -0,0 +1,164 @@
+// bench_env – per-voice envelope cost: evaluated per sample vs read from a
+// shared table (env.h) vs stepped as a recurrence.
+//
+// One voice is triggered for FRAMES frames and rendered in BLOCK-frame
+// calls three ways: with the per-sample formula the voice used before the
+// tables (a copy of the old simple_voice_process loop; fm_voice with no
+// table attached), reading the shared table, and - the fallback for a
+// decay or length the cache cannot hold - stepping env *= coef.  Times are
+// TSC cycles per sample, best of REPS.  The table must reproduce the
+// formula exactly for the simple voice and the scalar FM kernel (the SIMD
+// FM lanes computed t = (pos + lane)·(1/sr), a few ulps off pos / sr); the
+// recurrence drifts by float rounding only.
+//
+// Usage: bench_env [--block=FRAMES]
+#include "simple_voice.h"
+#include "fm_voice.h"
+#include "env.h"
+#include "dsp_dispatch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <x86intrin.h>
+
+#define SR_F 44100.0f
+#define BLOCK 64
+#define FRAMES 44100
+#define REPS 20
+#define MAX_REC_ERR 1e-4f   /* recurrence vs formula, full scale 1 */
+
+typedef enum { MODE_FORMULA, MODE_TABLE, MODE_RECURRENCE } run_mode_t;
+
+/* simple_voice_process evaluating expf(-decay·pos/sr) every sample, as it
+   did before the tables */
+static void ref_simple_process(simple_voice_t *v, float *L, float *R, uint32_t n)
+{
+    static const wt_shape_t shape[] = { [SIMPLE_SINE] = WT_SINE, [SIMPLE_TRI] = WT_TRIANGLE,
+                                        [SIMPLE_SQUARE] = WT_SQUARE };
+    if (v->pos >= v->len) return;
+    uint32_t count = v->len - v->pos;
+    if (count > n) count = n;
+    const float *tab = wavetable_for(shape[v->wave], v->inc);
+    float buf[64];
+    for (uint32_t i = 0; i < count; i += 64) {
+        const uint32_t m = count - i < 64 ? count - i : 64;
+        wavetable_block(tab, &v->phase, v->inc, buf, m);
+        for (uint32_t k = 0; k < m; ++k) {
+            float env = env_exp_decay((float)(v->pos + i + k) / v->sr, v->decay);
+            float s = buf[k] * (env * v->amp);
+            L[i + k] += s;
+            R[i + k] += s;
+        }
+    }
+    v->pos += count;
+}
+
+static uint64_t run_simple(simple_wave_t wave, run_mode_t mode, uint32_t block, float *L, float *R)
+{
+    simple_voice_t v;
+    simple_voice_init(&v, SR_F);
+    simple_voice_trigger(&v, 330.0f, (float)FRAMES / SR_F, wave, 0.5f, 6.0f);
+    if (mode == MODE_RECURRENCE) v.env_tab = NULL;
+    memset(L, 0, sizeof(float) * FRAMES);
+    memset(R, 0, sizeof(float) * FRAMES);
+    uint64_t t0 = __rdtsc();
+    for (uint32_t b = 0; b < FRAMES; b += block) {
+        uint32_t len = FRAMES - b < block ? FRAMES - b : block;
+        if (mode == MODE_FORMULA) ref_simple_process(&v, L + b, R + b, len);
+        else simple_voice_process(&v, L + b, R + b, len);
+    }
+    return __rdtsc() - t0;
+}
+
+static uint64_t run_fm(run_mode_t mode, uint32_t block, float *L, float *R)
+{
+    fm_voice_t v;
+    fm_voice_init(&v, SR_F);
+    fm_voice_trigger(&v, 330.0f, (float)FRAMES / SR_F, 3.5f, 4.0f, 0.5f, 6.0f);
+    if (mode != MODE_TABLE) v.env_tab = NULL;
+    memset(L, 0, sizeof(float) * FRAMES);
+    memset(R, 0, sizeof(float) * FRAMES);
+    uint64_t t0 = __rdtsc();
+    for (uint32_t b = 0; b < FRAMES; b += block) {
+        uint32_t len = FRAMES - b < block ? FRAMES - b : block;
+        fm_voice_process(&v, L + b, R + b, len);
+    }
+    return __rdtsc() - t0;
+}
+
+static float max_err(const float *a, const float *b)
+{
+    float e = 0.0f;
+    for (uint32_t i = 0; i < FRAMES; ++i) {
+        float d = fabsf(a[i] - b[i]);
+        if (d > e) e = d;
+    }
+    return e;
+}
+
+typedef struct { int fm; simple_wave_t wave; run_mode_t mode; uint32_t block; float *L, *R; } job_t;
+
+static double best_cps(const job_t *j)
+{
+    uint64_t best = UINT64_MAX;
+    for (int r = 0; r < REPS; ++r) {
+        uint64_t t = j->fm ? run_fm(j->mode, j->block, j->L, j->R)
+                           : run_simple(j->wave, j->mode, j->block, j->L, j->R);
+        if (t < best) best = t;
+    }
+    return (double)best / FRAMES;
+}
+
+/* Times the three modes of one voice; returns nonzero on a mismatch. */
+static int bench_row(const char *name, int fm, simple_wave_t wave, uint32_t block, float *buf[3][2])
+{
+    const run_mode_t modes[3] = { MODE_FORMULA, MODE_TABLE, MODE_RECURRENCE };
+    double cps[3];
+    for (int m = 0; m < 3; ++m) {
+        job_t j = { fm, wave, modes[m], block, buf[m][0], buf[m][1] };
+        cps[m] = best_cps(&j);
+    }
+    float tab_err = max_err(buf[1][0], buf[0][0]);
+    float rec_err = max_err(buf[2][0], buf[0][0]);
+    /* fm_voice has no recurrence mode: "recurrence" is the formula again */
+    int bad = (!fm && tab_err != 0.0f) || rec_err > MAX_REC_ERR;
+    if (fm) printf("%-12s %10.2f %10.2f %10s %7.2fx %10.2g %10s%s\n", name, cps[0], cps[1], "-",
+                   cps[0] / cps[1], tab_err, "-", bad ? "  MISMATCH" : "");
+    else printf("%-12s %10.2f %10.2f %10.2f %7.2fx %10.2g %10.2g%s\n", name, cps[0], cps[1], cps[2],
+                cps[0] / cps[1], tab_err, rec_err, bad ? "  MISMATCH" : "");
+    return bad;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t block = BLOCK;
+    for (int i = 1; i < argc; ++i)
+        if (strncmp(argv[i], "--block=", 8) == 0) block = (uint32_t)strtoul(argv[i] + 8, NULL, 0);
+    if (block == 0) return 1;
+
+    float *buf[3][2];
+    for (int m = 0; m < 3; ++m)
+        for (int c = 0; c < 2; ++c)
+            if (!(buf[m][c] = malloc(sizeof(float) * FRAMES))) return 1;
+    int fail = 0;
+
+    printf("Envelopes: one voice, %d frames in %u-frame calls, TSC cycles/sample, best of %d\n",
+           FRAMES, block, REPS);
+    printf("%-12s %10s %10s %10s %8s %10s %10s\n", "voice", "formula", "table", "recur",
+           "speedup", "tab err", "rec err");
+    fail |= bench_row("simple sine", 0, SIMPLE_SINE, block, buf);
+    fail |= bench_row("simple tri", 0, SIMPLE_TRI, block, buf);
+    fail |= bench_row("simple sq", 0, SIMPLE_SQUARE, block, buf);
+    for (int lvl = 0; lvl < DSP_LEVEL_COUNT; ++lvl) {
+        if (dsp_dispatch_select((dsp_level_t)lvl) != 0) continue;
+        char name[32];
+        snprintf(name, sizeof(name), "fm %s", dsp_level_name((dsp_level_t)lvl));
+        fail |= bench_row(name, 1, SIMPLE_SINE, block, buf);
+    }
+    printf("\n%zu bytes of tables\n", env_table_bytes());
+
+    for (int m = 0; m < 3; ++m) { free(buf[m][0]); free(buf[m][1]); }
+    env_table_clear();
+    return fail;
+}
@@ -0,0 +1,142 @@
+// bench_fm_bank – one SoA FM bank pass vs one fm_voice call per voice.
+//
+// N two-operator voices (the FM presets at spread pitches) are rendered for
+// FRAMES frames in BLOCK-frame calls, once as N fm_voice_t driven by the
+// incremental-phasor kernel and once as an fm_bank_t holding the same N
+// patches, one lane per voice.  Both model the same exponential-envelope
+// voice, so the bank must match the per-voice sum (MIN_SNR_DB); the time
+// per voice-sample shows the per-call and per-voice loop overhead the bank
+// removes.  The last column times N six-operator voices (FM_PATCH_BELL6) in
+// the bank for the cost of a richer patch.  Every kernel level the CPU
+// supports is run.
+//
+// Usage: bench_fm_bank [--block=FRAMES]
+#define _POSIX_C_SOURCE 199309L
+#include "fm_bank.h"
+#include "fm_voice.h"
+#include "fm_presets.h"
+#include "dsp_dispatch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define SR_F 44100.0f
+#define BLOCK 64
+#define FRAMES 44100
+#define REPS 5
+#define MIN_SNR_DB 70.0
+
+static const fm_params_t *const s_presets[] = {
+    &FM_PRESET_BELLS, &FM_PRESET_CALM, &FM_PRESET_QUANTUM, &FM_PRESET_PLUCK,
+    &FM_BASS_DEFAULT, &FM_BASS_QUANTUM, &FM_BASS_PLUCKY,
+};
+#define NUM_PRESETS (sizeof(s_presets) / sizeof(s_presets[0]))
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static float voice_freq(int v) { return 110.0f * powf(2.0f, (float)(v % 24) / 12.0f); }
+static float voice_amp(int v)  { return 1.0f / (1.0f + (float)(v % 5)); }
+
+static double run_voices(int n, uint32_t block, float *L, float *R)
+{
+    fm_voice_t v[FM_BANK_VOICES];
+    for (int i = 0; i < n; ++i) {
+        const fm_params_t *p = s_presets[i % NUM_PRESETS];
+        fm_voice_init(&v[i], SR_F);
+        fm_voice_trigger(&v[i], voice_freq(i), 2.0f, p->ratio, p->index, voice_amp(i), p->decay);
+    }
+    memset(L, 0, sizeof(float) * FRAMES);
+    memset(R, 0, sizeof(float) * FRAMES);
+    double t0 = now_sec();
+    for (uint32_t b = 0; b < FRAMES; b += block) {
+        uint32_t len = FRAMES - b < block ? FRAMES - b : block;
+        for (int i = 0; i < n; ++i) g_dsp.fm_voice_phasor_process(&v[i], L + b, R + b, len);
+    }
+    return now_sec() - t0;
+}
+
+static double run_bank(fm_bank_t *bank, int n, const fm_patch_t *patch, uint32_t block, float *L, float *R)
+{
+    fm_bank_init(bank, SR_F);
+    for (int i = 0; i < n; ++i) {
+        fm_patch_t p2;
+        if (!patch) fm_patch_from_params(&p2, s_presets[i % NUM_PRESETS]);
+        fm_bank_trigger(bank, patch ? patch : &p2, voice_freq(i), 2.0f, voice_amp(i));
+    }
+    memset(L, 0, sizeof(float) * FRAMES);
+    memset(R, 0, sizeof(float) * FRAMES);
+    double t0 = now_sec();
+    for (uint32_t b = 0; b < FRAMES; b += block) {
+        uint32_t len = FRAMES - b < block ? FRAMES - b : block;
+        fm_bank_process(bank, L + b, R + b, len);
+    }
+    return now_sec() - t0;
+}
+
+static double best_of(double (*fn)(void *), void *arg)
+{
+    double best = INFINITY;
+    for (int r = 0; r < REPS; ++r) {
+        double t = fn(arg);
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+typedef struct { int n; uint32_t block; const fm_patch_t *patch; fm_bank_t *bank; float *L, *R; } job_t;
+static double job_voices(void *a) { job_t *j = a; return run_voices(j->n, j->block, j->L, j->R); }
+static double job_bank(void *a)   { job_t *j = a; return run_bank(j->bank, j->n, j->patch, j->block, j->L, j->R); }
+
+int main(int argc, char **argv)
+{
+    uint32_t block = BLOCK;
+    for (int i = 1; i < argc; ++i)
+        if (strncmp(argv[i], "--block=", 8) == 0) block = (uint32_t)strtoul(argv[i] + 8, NULL, 0);
+    if (block == 0) return 1;
+
+    float *L0 = malloc(sizeof(float) * FRAMES), *R0 = malloc(sizeof(float) * FRAMES);
+    float *L1 = malloc(sizeof(float) * FRAMES), *R1 = malloc(sizeof(float) * FRAMES);
+    fm_bank_t *bank = aligned_alloc(64, sizeof(fm_bank_t));
+    if (!L0 || !R0 || !L1 || !R1 || !bank) return 1;
+    static const int counts[] = { 1, 2, 4, 8, 16, 32 };
+    int fail = 0;
+
+    printf("FM bank: %d frames in %u-frame calls, best of %d\n", FRAMES, block, REPS);
+    for (int lvl = 0; lvl < DSP_LEVEL_COUNT; ++lvl) {
+        if (dsp_dispatch_select((dsp_level_t)lvl) != 0) continue;
+        printf("\n[%s]\n%-6s %14s %14s %8s %8s %14s\n", dsp_level_name((dsp_level_t)lvl), "voices",
+               "voices ns/smp", "bank ns/smp", "speedup", "SNR dB", "6-op ns/smp");
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+            const int n = counts[c];
+            const double vs = (double)n * FRAMES;
+            job_t jv = { n, block, NULL, bank, L0, R0 }, jb = { n, block, NULL, bank, L1, R1 };
+            job_t j6 = { n, block, &FM_PATCH_BELL6, bank, L1, R1 };
+            double tv = best_of(job_voices, &jv);
+            double tb = best_of(job_bank, &jb);
+
+            double sig = 0.0, err = 0.0;
+            for (uint32_t i = 0; i < FRAMES; ++i) {
+                double eL = (double)L1[i] - L0[i], eR = (double)R1[i] - R0[i];
+                sig += (double)L0[i] * L0[i] + (double)R0[i] * R0[i];
+                err += eL * eL + eR * eR;
+            }
+            double snr = err > 0.0 ? 10.0 * log10(sig / err) : INFINITY;
+            double t6 = best_of(job_bank, &j6);
+
+            int bad = snr < MIN_SNR_DB;
+            printf("%-6d %14.2f %14.2f %7.2fx %8.1f %14.2f%s\n", n, tv / vs * 1e9, tb / vs * 1e9,
+                   tv / tb, snr, t6 / vs * 1e9, bad ? "  MISMATCH" : "");
+            if (bad) fail = 1;
+        }
+    }
+
+    free(L0); free(R0); free(L1); free(R1); free(bank);
+    return fail;
+}
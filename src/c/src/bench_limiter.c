@@ -0,0 +1,224 @@
+// bench_limiter – soft-knee vs true-peak limiter: cost per frame and how
+// far each lets true peaks past the ceiling.
+//
+// For every seed of the corpus the generator renders SECONDS of its mix with
+// the limiter bypassed (threshold at infinity), and each limiter then runs
+// over that same mix in BLOCK-frame calls, both at a CEIL_DB ceiling.  Cost
+// is wall time per stereo frame, best of REPS.  The output's true peak is
+// measured by converting it to 4x the rate with the polyphase resampler
+// (resampler.h) and taking the largest magnitude; the overshoot is how far
+// that lies above the ceiling.  The soft-knee limiter only watches sample
+// peaks and follows them with an attack, so it overshoots on transients and
+// between samples.  The true-peak limiter estimates with the same 4x bank
+// and keeps LIMITER_TP_MARGIN_DB of headroom for the gain changing under
+// the filter, so it must not overshoot at all: any true peak above the
+// ceiling fails the run (exit 1).  On x86-64 the true-peak row is repeated
+// at every dispatch level; their outputs must agree to float rounding.
+//
+// Usage: bench_limiter [--seeds=N] [--seconds=N] [--block=FRAMES]
+#define _POSIX_C_SOURCE 199309L
+#include "generator.h"
+#include "limiter.h"
+#include "resampler.h"
+#ifdef DSP_DISPATCH
+#include "dsp_dispatch.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define SEEDS 8
+#define SECONDS 20
+#define BLOCK 256
+#define REPS 5
+#define CEIL_DB -1.0f
+#define LOOKAHEAD_MS 2.0f
+#define MAX_LEVEL_ERR 1e-5f   /* true-peak output, any level vs the first */
+
+typedef struct {
+    double ns;          /* best time per frame */
+    float sample_db;    /* largest sample peak, dBFS */
+    float true_db;      /* largest true peak, dBTP */
+    float over_db;      /* largest true peak above the ceiling */
+    uint32_t overs;     /* seeds whose true peak exceeds the ceiling */
+} lim_stats_t;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static float to_db(float x)
+{
+    return 20.0f * log10f(fmaxf(x, 1e-10f));
+}
+
+static void limiter_setup(limiter_t *l, limiter_mode_t mode, uint32_t sr)
+{
+    if (mode == LIMITER_TRUE_PEAK) limiter_init_mode(l, mode, (float32_t)sr, LOOKAHEAD_MS, 50.0f, CEIL_DB);
+    else limiter_init(l, (float32_t)sr, 0.5f, 50.0f, CEIL_DB);
+}
+
+/* Largest |x| of a stereo signal at four times its rate */
+static float true_peak(resampler_t *up, const float *L, const float *R, uint32_t n, float *oL, float *oR)
+{
+    resampler_reset(up);
+    uint32_t m = resampler_process(up, L, R, n, oL, oR);
+    m += resampler_flush(up, oL + m, oR + m);
+    float peak = 0.0f;
+    for (uint32_t i = 0; i < m; ++i) peak = fmaxf(peak, fmaxf(fabsf(oL[i]), fabsf(oR[i])));
+    return peak;
+}
+
+typedef struct {
+    uint32_t sr, frames, block;
+    float *mixL, *mixR;   /* limiter input */
+    float *L, *R;         /* limiter output */
+    float *upL, *upR;     /* 4x output */
+    resampler_t up;
+} bench_t;
+
+/* Limits the mix in b->L/R; returns the best time per frame */
+static double run_limiter(bench_t *b, limiter_mode_t mode)
+{
+    double best = 1e30;
+    for (int r = 0; r < REPS; ++r) {
+        limiter_t l;
+        limiter_setup(&l, mode, b->sr);
+        memcpy(b->L, b->mixL, sizeof(float) * b->frames);
+        memcpy(b->R, b->mixR, sizeof(float) * b->frames);
+        double t0 = now_ns();
+        for (uint32_t i = 0; i < b->frames; i += b->block) {
+            uint32_t len = b->frames - i < b->block ? b->frames - i : b->block;
+            limiter_process(&l, b->L + i, b->R + i, len);
+        }
+        double t = (now_ns() - t0) / b->frames;
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+static void account(bench_t *b, lim_stats_t *s, double ns)
+{
+    float sp = 0.0f;
+    for (uint32_t i = 0; i < b->frames; ++i) sp = fmaxf(sp, fmaxf(fabsf(b->L[i]), fabsf(b->R[i])));
+    const float tp = to_db(true_peak(&b->up, b->L, b->R, b->frames, b->upL, b->upR));
+    s->ns += ns;
+    s->sample_db = fmaxf(s->sample_db, to_db(sp));
+    s->true_db = fmaxf(s->true_db, tp);
+    s->over_db = fmaxf(s->over_db, tp - CEIL_DB);
+    s->overs += tp > CEIL_DB;
+}
+
+static void print_row(const char *name, const lim_stats_t *s, uint32_t seeds, uint32_t latency)
+{
+    printf("%-18s %8.2f %8u %10.2f %10.2f %10.2f %6u/%u\n", name, s->ns / seeds, latency, s->sample_db,
+           s->true_db, fmaxf(s->over_db, 0.0f), s->overs, seeds);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seeds = SEEDS, seconds = SECONDS, block = BLOCK;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--seeds=", 8) == 0) seeds = (uint32_t)strtoul(argv[i] + 8, NULL, 0);
+        else if (strncmp(argv[i], "--seconds=", 10) == 0) seconds = (uint32_t)strtoul(argv[i] + 10, NULL, 0);
+        else if (strncmp(argv[i], "--block=", 8) == 0) block = (uint32_t)strtoul(argv[i] + 8, NULL, 0);
+    }
+    if (seeds == 0 || seconds == 0 || block == 0) return 1;
+
+    bench_t b = { .sr = SR_DEFAULT, .frames = seconds * SR_DEFAULT, .block = block };
+    if (resampler_init(&b.up, b.sr, 4 * b.sr) != 0) return 1;
+    const uint32_t up_cap = resampler_max_out(&b.up, b.frames) + resampler_max_out(&b.up, resampler_latency(&b.up));
+    b.mixL = malloc(sizeof(float) * b.frames);
+    b.mixR = malloc(sizeof(float) * b.frames);
+    b.L = malloc(sizeof(float) * b.frames);
+    b.R = malloc(sizeof(float) * b.frames);
+    b.upL = malloc(sizeof(float) * up_cap);
+    b.upR = malloc(sizeof(float) * up_cap);
+    float *refL = malloc(sizeof(float) * b.frames), *refR = malloc(sizeof(float) * b.frames);
+    if (!b.mixL || !b.mixR || !b.L || !b.R || !b.upL || !b.upR || !refL || !refR) return 1;
+
+#ifdef DSP_DISPATCH
+    enum { LEVELS = DSP_LEVEL_COUNT };
+#else
+    enum { LEVELS = 1 };
+#endif
+    const lim_stats_t empty = { 0.0, -INFINITY, -INFINITY, -INFINITY, 0 };
+    lim_stats_t input = empty, soft = empty, tp[LEVELS];
+    for (int lvl = 0; lvl < LEVELS; ++lvl) tp[lvl] = empty;
+    float level_err[LEVELS] = { 0 };
+    int have_level[LEVELS] = { 0 };
+    uint32_t latency = 0;
+
+    for (uint32_t s = 0; s < seeds; ++s) {
+        generator_t g;
+        if (generator_init(&g, 0x1000 + s, b.sr) != 0) return 1;
+        g.limiter.threshold = INFINITY;   /* soft-knee limiter never engages */
+        generator_process(&g, b.mixL, b.mixR, b.frames);
+        generator_free(&g);
+
+        memcpy(b.L, b.mixL, sizeof(float) * b.frames);
+        memcpy(b.R, b.mixR, sizeof(float) * b.frames);
+        account(&b, &input, 0.0);
+        account(&b, &soft, run_limiter(&b, LIMITER_SOFT_KNEE));
+
+        int first = 1;
+        for (int lvl = 0; lvl < LEVELS; ++lvl) {
+#ifdef DSP_DISPATCH
+            if (dsp_dispatch_select((dsp_level_t)lvl) != 0) continue;
+#endif
+            have_level[lvl] = 1;
+            account(&b, &tp[lvl], run_limiter(&b, LIMITER_TRUE_PEAK));
+            if (first) {
+                memcpy(refL, b.L, sizeof(float) * b.frames);
+                memcpy(refR, b.R, sizeof(float) * b.frames);
+                first = 0;
+            }
+            for (uint32_t i = 0; i < b.frames; ++i)
+                level_err[lvl] = fmaxf(level_err[lvl], fmaxf(fabsf(b.L[i] - refL[i]), fabsf(b.R[i] - refR[i])));
+        }
+#ifdef DSP_DISPATCH
+        dsp_dispatch_select(dsp_detect_level());
+#endif
+    }
+    {
+        limiter_t l;
+        limiter_setup(&l, LIMITER_TRUE_PEAK, b.sr);
+        latency = limiter_latency(&l);
+    }
+
+    printf("Limiters: %u seeds x %u s at %u Hz in %u-frame calls, ceiling %.1f dB, best of %d\n",
+           seeds, seconds, b.sr, block, CEIL_DB, REPS);
+    printf("%-18s %8s %8s %10s %10s %10s %8s\n", "limiter", "ns/frame", "latency", "sample dB",
+           "true dB", "over dB", "overs");
+    print_row("none (input)", &input, seeds, 0);
+    print_row("soft knee", &soft, seeds, 0);
+    int fail = 0;
+    for (int lvl = 0; lvl < LEVELS; ++lvl) {
+        if (!have_level[lvl]) continue;
+        char name[32];
+#ifdef DSP_DISPATCH
+        snprintf(name, sizeof(name), "true peak %s", dsp_level_name((dsp_level_t)lvl));
+#else
+        snprintf(name, sizeof(name), "true peak");
+#endif
+        print_row(name, &tp[lvl], seeds, latency);
+        if (tp[lvl].overs) {
+            printf("  OVERSHOOT: true peak %.4f dB above the ceiling\n", tp[lvl].over_db);
+            fail = 1;
+        }
+        if (level_err[lvl] > MAX_LEVEL_ERR) {
+            printf("  MISMATCH: max |err| %.3g vs the first level\n", level_err[lvl]);
+            fail = 1;
+        }
+    }
+
+    resampler_free(&b.up);
+    free(b.mixL); free(b.mixR); free(b.L); free(b.R); free(b.upL); free(b.upR);
+    free(refL); free(refR);
+    return fail;
+}
@@ -0,0 +1,227 @@
+// bench_parallel – multi-threaded generator_process vs one thread.
+//
+// Renders a long piece (the segment looped for SECONDS) in calls of CALL
+// frames with generator_set_threads() at 1, 2, 4, 8 and 16 threads and
+// reports wall time, realtime factor and speedup over one thread, plus how
+// far each output differs from the single-threaded render.  Workers
+// fast-forward their voice copies with the *_skip twins of the selected
+// kernels, so on x86-64 the output should be bit-identical; where the skips
+// are the portable C recurrences (arm64 NEON builds) a SIMD kernel's phase
+// can drift slightly, so discontinuity flips are counted apart from the SNR
+// as in bench_scheduler.  Thread counts above the host's core count are
+// still run but cannot speed anything up.
+//
+// A second table covers the realtime mode (generator_set_bus_threads):
+// BUS_SECONDS of audio in callback-sized blocks with the voice buses on
+// up to GEN_BUS_COUNT threads, against the same blocks on one thread.  It must
+// be bit-identical; blocks under GEN_BUS_MIN_FRAMES fall back to the
+// calling thread, and the per-bus columns show each job's share of the
+// render time (the longest one bounds the parallel block time).
+//
+// Usage: bench_parallel [seed] [--dsp=<level>] [--seconds=N] [--call=FRAMES]
+#define _POSIX_C_SOURCE 199309L
+#include "generator.h"
+#ifdef DSP_DISPATCH
+#include "dsp_dispatch.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SECONDS 180        /* default piece length */
+#define CALL (10 * SR_DEFAULT)     /* default frames per generator_process call */
+#define REPS 3
+#define FLIP_ERR 0.01      /* |err| above this is a discontinuity flip */
+#define MIN_SNR_DB 50.0
+#define BUS_SECONDS 30
+
+/* Fallback scalar RMS when assembly version not linked */
+#ifndef GENERATOR_RMS_ASM_PRESENT
+float generator_compute_rms_asm(const float *L, const float *R, uint32_t num_frames)
+{
+    double sum = 0.0;
+    for (uint32_t i = 0; i < num_frames; i++)
+        sum += (double)L[i] * L[i] + (double)R[i] * R[i];
+    return (float)sqrt(sum / (double)(2 * num_frames));
+}
+#endif
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Render `frames` in calls of `call` frames on `threads` threads; returns
+   the best elapsed time over REPS runs. */
+static double run(generator_t *g, uint64_t seed, uint32_t threads, uint32_t call,
+                  float *L, float *R, uint32_t frames)
+{
+    double best = INFINITY;
+    for (int r = 0; r < REPS; r++) {
+        if (generator_init(g, seed, SR_DEFAULT) != 0) return NAN;
+        generator_set_threads(g, threads);
+        double t0 = now_sec();
+        for (uint32_t done = 0; done < frames; done += call) {
+            uint32_t n = frames - done < call ? frames - done : call;
+            generator_process(g, L + done, R + done, n);
+        }
+        double t = now_sec() - t0;
+        generator_free(g);
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+/* BUS_SECONDS in `block`-frame calls with the voice buses on `threads`
+   threads; best time over REPS, stats from the last run. */
+static double run_buses(generator_t *g, uint64_t seed, uint32_t threads, uint32_t block,
+                        float *L, float *R, uint32_t frames, gen_bus_stats_t *st)
+{
+    double best = INFINITY;
+    for (int r = 0; r < REPS; r++) {
+        if (generator_init(g, seed, SR_DEFAULT) != 0) return NAN;
+        if (generator_set_bus_threads(g, threads) != 0) {
+            generator_free(g);
+            return NAN;
+        }
+        double t0 = now_sec();
+        for (uint32_t done = 0; done < frames; done += block) {
+            uint32_t n = frames - done < block ? frames - done : block;
+            generator_process(g, L + done, R + done, n);
+        }
+        double t = now_sec() - t0;
+        generator_bus_stats(g, st);
+        generator_free(g);
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+static int bench_buses(generator_t *g, uint64_t seed, float *L0, float *R0, float *L1, float *R1)
+{
+    static const uint32_t blocks[] = { 64, 128, 256, 512, 1024, 4096 };
+    static const char *names[GEN_BUS_COUNT] = { "drums", "synth", "mid fm", "bass fm" };
+    const uint32_t frames = BUS_SECONDS * SR_DEFAULT;
+    int fail = 0;
+
+    /* The pool is capped at the online cores; see what we get. */
+    gen_bus_stats_t probe;
+    if (generator_init(g, seed, SR_DEFAULT) != 0) return 1;
+    generator_set_bus_threads(g, GEN_BUS_COUNT);
+    generator_bus_stats(g, &probe);
+    generator_free(g);
+    const uint32_t threads = probe.threads;
+    if (threads < 2) {
+        printf("\nvoice buses: mode stays off on a single core, nothing to compare\n");
+        return 0;
+    }
+
+    printf("\nvoice buses on %u threads, %u s in callback-sized blocks\n", threads, BUS_SECONDS);
+    printf("%-6s %9s %9s %8s %7s", "block", "1 thr us", "bus us", "speedup", "serial");
+    for (int j = 0; j < GEN_BUS_COUNT; j++) printf(" %8s", names[j]);
+    printf(" %8s %s\n", "wait", "output");
+    for (size_t b = 0; b < sizeof(blocks) / sizeof(blocks[0]); b++) {
+        gen_bus_stats_t st;
+        double t1 = run_buses(g, seed, 1, blocks[b], L0, R0, frames, &st);
+        double tn = run_buses(g, seed, threads, blocks[b], L1, R1, frames, &st);
+        if (isnan(tn)) {
+            printf("%-6u bus workers could not be started\n", blocks[b]);
+            return 1;
+        }
+        int same = memcmp(L0, L1, sizeof(float) * frames) == 0 &&
+                   memcmp(R0, R1, sizeof(float) * frames) == 0;
+        if (!same) fail = 1;
+
+        double calls = (double)((frames + blocks[b] - 1) / blocks[b]);
+        uint64_t total = 0;
+        for (int j = 0; j < GEN_BUS_COUNT; j++) total += st.bus_ns[j];
+        printf("%-6u %9.2f %9.2f %7.2fx %6.0f%%", blocks[b], t1 / calls * 1e6, tn / calls * 1e6,
+               t1 / tn, 100.0 * st.serial_blocks / calls);
+        for (int j = 0; j < GEN_BUS_COUNT; j++)
+            printf(" %7.1f%%", total ? 100.0 * st.bus_ns[j] / total : 0.0);
+        printf(" %7.1f%% %s\n", total ? 100.0 * st.wait_ns / total : 0.0,
+               same ? "identical" : "DIFFERS");
+    }
+    return fail;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t seed = 0x1234;
+    uint32_t seconds = SECONDS, call = CALL;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--dsp=", 6) == 0) {
+#ifdef DSP_DISPATCH
+            dsp_level_t level = dsp_level_from_name(argv[i] + 6);
+            if (level == DSP_LEVEL_COUNT || dsp_dispatch_select(level) != 0) {
+                fprintf(stderr, "Kernel level '%s' not available on this host\n", argv[i] + 6);
+                return 1;
+            }
+#endif
+        } else if (strncmp(argv[i], "--seconds=", 10) == 0) {
+            seconds = (uint32_t)strtoul(argv[i] + 10, NULL, 0);
+        } else if (strncmp(argv[i], "--call=", 7) == 0) {
+            call = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        } else {
+            seed = strtoull(argv[i], NULL, 0);
+        }
+    }
+    if (seconds == 0 || call == 0) return 1;
+
+    const uint32_t frames = seconds * SR_DEFAULT;
+    generator_t *g = malloc(sizeof(generator_t));
+    float *L0 = malloc(sizeof(float) * frames), *R0 = malloc(sizeof(float) * frames);
+    float *L1 = malloc(sizeof(float) * frames), *R1 = malloc(sizeof(float) * frames);
+    if (!g || !L0 || !R0 || !L1 || !R1) return 1;
+
+    static const uint32_t counts[] = { 1, 2, 4, 8, 16 };
+    enum { NCOUNTS = sizeof(counts) / sizeof(counts[0]) };
+    double t[NCOUNTS], max_err[NCOUNTS], snr[NCOUNTS];
+    uint32_t flips[NCOUNTS];
+    int fail = 0;
+
+    for (int c = 0; c < NCOUNTS; c++) {
+        float *L = c == 0 ? L0 : L1, *R = c == 0 ? R0 : R1;
+        t[c] = run(g, seed, counts[c], call, L, R, frames);
+
+        double sig = 0.0, err = 0.0;
+        max_err[c] = 0.0;
+        flips[c] = 0;
+        for (uint32_t i = 0; c > 0 && i < frames; i++) {
+            double eL = fabs((double)L1[i] - L0[i]), eR = fabs((double)R1[i] - R0[i]);
+            if (eL > FLIP_ERR || eR > FLIP_ERR) { flips[c]++; continue; }
+            sig += (double)L0[i] * L0[i] + (double)R0[i] * R0[i];
+            err += eL * eL + eR * eR;
+            if (eL > max_err[c]) max_err[c] = eL;
+            if (eR > max_err[c]) max_err[c] = eR;
+        }
+        snr[c] = err > 0.0 ? 10.0 * log10(sig / err) : INFINITY;
+        if (snr[c] < MIN_SNR_DB || flips[c] > frames / 1000) fail = 1;
+    }
+
+    printf("\nseed 0x%llx, %u s (%u frames) in %u-frame calls, %ld cores online",
+           (unsigned long long)seed, seconds, frames, call, sysconf(_SC_NPROCESSORS_ONLN));
+#ifdef DSP_DISPATCH
+    printf(", %s kernels", dsp_level_name(dsp_current_level()));
+#endif
+    printf("\n%-8s %10s %10s %8s %12s %6s %8s\n", "threads", "time s", "x realtime",
+           "speedup", "max|err|", "flips", "SNR dB");
+    for (int c = 0; c < NCOUNTS; c++) {
+        printf("%-8u %10.3f %10.1f %7.2fx %12.3g %6u %8.1f\n", counts[c], t[c], seconds / t[c],
+               t[0] / t[c], max_err[c], flips[c], snr[c]);
+    }
+    if (fail) printf("MISMATCH: threaded output below %.0f dB SNR or too many flips\n", MIN_SNR_DB);
+
+    if (frames >= BUS_SECONDS * SR_DEFAULT && bench_buses(g, seed, L0, R0, L1, R1)) {
+        printf("MISMATCH: voice-bus output differs from the single-threaded render\n");
+        fail = 1;
+    }
+
+    free(g); free(L0); free(R0); free(L1); free(R1);
+    return fail;
+}
@@ -0,0 +1,168 @@
+// bench_pcm – float to interleaved PCM: the old truncating loop vs
+// pcm_convert for every format, with and without TPDF dither.
+//
+// FRAMES frames of stereo noise, a tenth of it driven past full scale, are
+// converted in BLOCK-frame calls (an odd size by default, so blocks start
+// off the vector grid and exercise the scalar heads and tails).  The first
+// row is the loop segment.c used before pcm.h: (int16_t)(x * 32767), which
+// truncates and wraps overs around to the other rail; its "wraps" column
+// counts the samples that came out with the wrong sign.  Every pcm_convert
+// row must match pcm_convert_frames run over the whole signal in one call
+// byte for byte, which checks block independence and, on x86-64 where the
+// rows repeat for every dispatch level, that the kernels agree.  Times are
+// ns per frame and GB/s of float read plus PCM written, best of REPS; the
+// memcpy row moves the same bytes as the s16 conversion, for scale.
+//
+// Usage: bench_pcm [--block=FRAMES]
+#define _POSIX_C_SOURCE 199309L
+#include "pcm.h"
+#ifdef DSP_DISPATCH
+#include "dsp_dispatch.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FRAMES (30 * 44100)
+#define BLOCK 4099
+#define REPS 5
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+typedef struct {
+    const float *L, *R;
+    uint8_t *out, *ref;
+    uint32_t block;
+} bench_t;
+
+static void print_row(const char *name, double ns, uint32_t out_bytes, const char *note)
+{
+    const double gbs = (8.0 + out_bytes) / ns;   /* bytes per ns = GB/s */
+    printf("%-22s %9.3f %9.2f  %s\n", name, ns, gbs, note);
+}
+
+/* The conversion in segment.c before pcm.h; returns wrapped samples */
+static uint32_t ref_s16(const bench_t *b, int16_t *out)
+{
+    uint32_t wraps = 0;
+    for (uint32_t i = 0; i < FRAMES; ++i) {
+        out[2 * i]     = (int16_t)(b->L[i] * 32767);
+        out[2 * i + 1] = (int16_t)(b->R[i] * 32767);
+    }
+    for (uint32_t i = 0; i < FRAMES; ++i)
+        wraps += (out[2 * i] < 0) != (b->L[i] < 0.0f) || (out[2 * i + 1] < 0) != (b->R[i] < 0.0f);
+    return wraps;
+}
+
+static double run_ref(const bench_t *b, uint32_t *wraps)
+{
+    double best = 1e30;
+    for (int r = 0; r < REPS; ++r) {
+        double t0 = now_ns();
+        *wraps = ref_s16(b, (int16_t *)b->out);
+        double t = (now_ns() - t0) / FRAMES;
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+static double run_memcpy(const bench_t *b)
+{
+    double best = 1e30;
+    for (int r = 0; r < REPS; ++r) {
+        double t0 = now_ns();
+        memcpy(b->out, b->ref, (size_t)FRAMES * 12);   /* 8 in + 4 out per frame */
+        double t = (now_ns() - t0) / FRAMES;
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+static double run_convert(const bench_t *b, pcm_format_t f, int dither)
+{
+    double best = 1e30;
+    for (int r = 0; r < REPS; ++r) {
+        pcm_conv_t c;
+        pcm_conv_init(&c, f, dither, 0x1234);
+        const uint32_t fb = 2 * pcm_sample_bytes(f);
+        double t0 = now_ns();
+        for (uint32_t i = 0; i < FRAMES; i += b->block) {
+            uint32_t len = FRAMES - i < b->block ? FRAMES - i : b->block;
+            pcm_convert(&c, b->L + i, b->R + i, len, b->out + (size_t)i * fb);
+        }
+        double t = (now_ns() - t0) / FRAMES;
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+/* Every format and dither setting at the current kernel level */
+static int bench_rows(const char *level, bench_t *b)
+{
+    int bad = 0;
+    for (int f = 0; f < PCM_FORMAT_COUNT; ++f) {
+        for (int dither = 0; dither < (f == PCM_F32 ? 1 : 2); ++dither) {
+            const uint32_t fb = 2 * pcm_sample_bytes((pcm_format_t)f);
+            pcm_conv_t c;
+            pcm_conv_init(&c, (pcm_format_t)f, dither, 0x1234);
+            pcm_convert_frames(&c, 0, b->L, b->R, FRAMES, b->ref);
+            const double ns = run_convert(b, (pcm_format_t)f, dither);
+            const int ok = memcmp(b->out, b->ref, (size_t)FRAMES * fb) == 0;
+            char name[48];
+            snprintf(name, sizeof(name), "%s %s%s", level, pcm_format_name((pcm_format_t)f), dither ? " tpdf" : "");
+            print_row(name, ns, fb, ok ? "" : "MISMATCH");
+            bad |= !ok;
+        }
+    }
+    return bad;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t block = BLOCK;
+    for (int i = 1; i < argc; ++i)
+        if (strncmp(argv[i], "--block=", 8) == 0) block = (uint32_t)strtoul(argv[i] + 8, NULL, 0);
+    if (block == 0) return 1;
+
+    float *L = malloc(sizeof(float) * FRAMES), *R = malloc(sizeof(float) * FRAMES);
+    bench_t b = { L, R, malloc((size_t)FRAMES * 12), malloc((size_t)FRAMES * 12), block };
+    if (!L || !R || !b.out || !b.ref) return 1;
+
+    /* Noise at -6 dBFS, every tenth 4410-frame stretch at +6 dB */
+    uint32_t x = 0x12345678u;
+    for (uint32_t i = 0; i < FRAMES; ++i) {
+        const float gain = (i / 4410) % 10 == 9 ? 2.0f : 0.5f;
+        x = x * 1664525u + 1013904223u;
+        L[i] = gain * (float)(int32_t)x * (1.0f / 2147483648.0f);
+        x = x * 1664525u + 1013904223u;
+        R[i] = gain * (float)(int32_t)x * (1.0f / 2147483648.0f);
+    }
+
+    printf("PCM conversion: %d stereo frames in %u-frame calls, best of %d\n", FRAMES, block, REPS);
+    printf("%-22s %9s %9s\n", "conversion", "ns/frame", "GB/s");
+    char note[48];
+    uint32_t wraps;
+    const double ref_ns = run_ref(&b, &wraps);
+    snprintf(note, sizeof(note), "%u wraps", wraps);
+    print_row("(int16_t)(x * 32767)", ref_ns, 4, note);
+    print_row("memcpy", run_memcpy(&b), 4, "");
+
+    int fail = 0;
+#ifdef DSP_DISPATCH
+    for (int lvl = 0; lvl < DSP_LEVEL_COUNT; ++lvl) {
+        if (dsp_dispatch_select((dsp_level_t)lvl) != 0) continue;
+        fail |= bench_rows(dsp_level_name((dsp_level_t)lvl), &b);
+    }
+#else
+    fail |= bench_rows("pcm.c", &b);
+#endif
+
+    free(L); free(R); free(b.out); free(b.ref);
+    return fail;
+}
@@ -0,0 +1,104 @@
+// bench_realtime – realtime headroom of the generator through the null
+// audio backend (coreaudio.h), so it runs on a server with no sound card.
+//
+// For each buffer size the generator renders SECONDS of audio for SEED
+// through audio_init / audio_start with the null backend unpaced: buffers
+// are requested back to back, each due a period (its length at the sample
+// rate) after it started.  The table gives the mean and worst callback
+// time, the worst as a share of the period (the headroom is the rest), and
+// the callbacks that ran past their period.  A paced run at BLOCK frames
+// then plays PACED_SECONDS on the backend's real-time clock, as bin/realtime
+// would, and reports the wake-up jitter and deadline misses.  The process
+// exits 2 if any paced callback missed its deadline.
+//
+// Usage: bench_realtime [--seed=S] [--seconds=N] [--paced-seconds=N] [--block=FRAMES]
+#define _POSIX_C_SOURCE 199309L
+#include "coreaudio.h"
+#include "generator.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SEED 0x1234
+#define SECONDS 20
+#define PACED_SECONDS 3
+#define BLOCK 512
+#define MAX_BUFFER 4096
+
+static const uint32_t k_buffers[] = { 64, 128, 256, 512, 1024, 2048 };
+#define N_BUFFERS (sizeof(k_buffers) / sizeof(k_buffers[0]))
+
+static generator_t g_gen;
+static float g_L[MAX_BUFFER], g_R[MAX_BUFFER];
+
+/* The bin/realtime callback: render planar, interleave */
+static void render(float *buffer, uint32_t n, void *user_data)
+{
+    (void)user_data;
+    generator_process(&g_gen, g_L, g_R, n);
+    for (uint32_t i = 0; i < n; ++i) {
+        buffer[i * 2] = g_L[i];
+        buffer[i * 2 + 1] = g_R[i];
+    }
+}
+
+static void sleep_ms(long ms)
+{
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+/* Plays `frames` frames of seed through the null backend; 0 and its stats */
+static int play(uint64_t seed, uint32_t buffer, uint64_t frames, int paced, audio_stats_t *st)
+{
+    if (generator_init(&g_gen, seed, SR_DEFAULT) != 0) return -1;
+    audio_null_configure(NULL, paced);
+    if (audio_init(SR_DEFAULT, buffer, render, NULL) != 0) {
+        generator_free(&g_gen);
+        return -1;
+    }
+    audio_start();
+    do {
+        sleep_ms(paced ? 20 : 1);
+        audio_get_stats(st);
+    } while (st->frames < frames);
+    audio_stop();
+    audio_get_stats(st);
+    generator_free(&g_gen);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t seed = SEED;
+    double seconds = SECONDS, paced_seconds = PACED_SECONDS;
+    uint32_t block = BLOCK;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--seed=", 7) == 0) seed = strtoull(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--seconds=", 10) == 0) seconds = atof(argv[i] + 10);
+        else if (strncmp(argv[i], "--paced-seconds=", 16) == 0) paced_seconds = atof(argv[i] + 16);
+        else if (strncmp(argv[i], "--block=", 8) == 0) block = (uint32_t)strtoul(argv[i] + 8, NULL, 0);
+    }
+    if (seconds <= 0.0 || block == 0 || block > MAX_BUFFER) return 1;
+    if (audio_select(AUDIO_BACKEND_NULL) != 0) return 1;
+
+    printf("Realtime headroom: seed 0x%llx, %.0f s per buffer size at %u Hz, null backend unpaced\n",
+           (unsigned long long)seed, seconds, SR_DEFAULT);
+    printf("%8s %10s %10s %10s %8s %8s\n", "buffer", "period us", "mean us", "max us", "max %", "over");
+    for (uint32_t b = 0; b < N_BUFFERS; ++b) {
+        audio_stats_t st;
+        if (play(seed, k_buffers[b], (uint64_t)(seconds * SR_DEFAULT), 0, &st) != 0) return 1;
+        printf("%8u %10.1f %10.2f %10.2f %7.1f%% %8llu\n", k_buffers[b], st.period_us, st.callback_mean_us,
+               st.callback_max_us, 100.0 * st.callback_max_us / st.period_us, (unsigned long long)st.misses);
+    }
+
+    if (paced_seconds <= 0.0) return 0;
+    audio_stats_t st;
+    if (play(seed, block, (uint64_t)(paced_seconds * SR_DEFAULT), 1, &st) != 0) return 1;
+    printf("\nPaced: %.1f s in %u-frame buffers (%.0f us): %llu callbacks, %llu deadline misses\n",
+           paced_seconds, block, st.period_us, (unsigned long long)st.callbacks, (unsigned long long)st.misses);
+    printf("wake-up jitter mean %.1f us, max %.1f us; callback mean %.1f us, max %.1f us\n",
+           st.jitter_mean_us, st.jitter_max_us, st.callback_mean_us, st.callback_max_us);
+    return st.misses ? 2 : 0;
+}
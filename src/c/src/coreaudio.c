@@ -1,4 +1,4 @@
-#include "coreaudio.h"
+#include "audio_backend.h"
 #include <AudioToolbox/AudioToolbox.h>
 #include <stdio.h>
 
@@ -25,7 +25,7 @@ static void audio_queue_callback(void *inUserData, AudioQueueRef inAQ, AudioQueu
     AudioQueueEnqueueBuffer(state->queue, inBuffer, 0, NULL);
 }
 
-int audio_init(uint32_t sr, uint32_t buffer_size, audio_callback_t callback, void* user_data)
+static int coreaudio_init(uint32_t sr, uint32_t buffer_size, audio_callback_t callback, void* user_data)
 {
     g_audio_state.user_callback = callback;
     g_audio_state.user_data = user_data;
@@ -53,13 +53,15 @@ int audio_init(uint32_t sr, uint32_t buffer_size, audio_callback_t callback, voi
     return 0;
 }
 
-void audio_start(void)
+static void coreaudio_start(void)
 {
     AudioQueueStart(g_audio_state.queue, NULL);
 }
 
-void audio_stop(void)
+static void coreaudio_stop(void)
 {
     AudioQueueStop(g_audio_state.queue, true);
     AudioQueueDispose(g_audio_state.queue, true);
-} 
\ No newline at end of file
+}
+
+const audio_backend_ops_t audio_backend_coreaudio = { coreaudio_init, coreaudio_start, coreaudio_stop, NULL };
@@ -1,33 +1,56 @@
 #include "delay.h"
 
 #ifndef DELAY_ASM
-void delay_process_block(delay_t *d, float32_t *L, float32_t *R, uint32_t n, float32_t feedback)
+static void delay_run_interleaved(float32_t *buf, float32_t *L, float32_t *R, uint32_t n, float32_t feedback)
 {
-    float32_t *buf = d->buf;
-    uint32_t idx = d->idx;
-    const uint32_t size = d->size;
-
     for(uint32_t i=0;i<n;++i){
         // Fetch delayed samples
-        float32_t yl = buf[idx*2];
-        float32_t yr = buf[idx*2+1];
+        float32_t yl = buf[i*2];
+        float32_t yr = buf[i*2+1];
 
         // Cache dry samples before we modify the output buffers
         float32_t dryL = L[i];
         float32_t dryR = R[i];
 
         // Write new values into the delay line (cross-feed with feedback)
-        buf[idx*2]   = dryL + yr * feedback;
-        buf[idx*2+1] = dryR + yl * feedback;
+        buf[i*2]   = dryL + yr * feedback;
+        buf[i*2+1] = dryR + yl * feedback;
 
         // Add delayed signal to the dry signal instead of overwriting it
         L[i] = dryL + yl;
         R[i] = dryR + yr;
+    }
+}
+
+static void delay_run_planar(float32_t *bl, float32_t *br, float32_t *L, float32_t *R, uint32_t n, float32_t feedback)
+{
+    for(uint32_t i=0;i<n;++i){
+        float32_t yl = bl[i], yr = br[i];
+        float32_t dryL = L[i], dryR = R[i];
+        bl[i] = dryL + yr * feedback;
+        br[i] = dryR + yl * feedback;
+        L[i] = dryL + yl;
+        R[i] = dryR + yr;
+    }
+}
+
+void delay_process_block(delay_t *d, float32_t *L, float32_t *R, uint32_t n, float32_t feedback)
+{
+    const uint32_t size = d->size;
+    if(size == 0) return;
+    uint32_t idx = d->idx;
+    if(idx >= size) idx = 0;
 
-        // Advance circular buffer index
-        idx++;
-        if(idx>=size) idx=0;
+    // Runs end at the wrap point, so no index check per sample
+    while(n > 0){
+        uint32_t run = size - idx;
+        if(run > n) run = n;
+        if(d->layout == DELAY_PLANAR) delay_run_planar(d->buf + idx, d->buf + size + idx, L, R, run, feedback);
+        else delay_run_interleaved(d->buf + idx*2, L, R, run, feedback);
+        L += run; R += run; n -= run;
+        idx += run;
+        if(idx >= size) idx = 0;
     }
     d->idx = idx;
 }
-#endif // DELAY_ASM 
\ No newline at end of file
+#endif // DELAY_ASM
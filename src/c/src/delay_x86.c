@@ -0,0 +1,117 @@
+#include "delay.h"
+#include "fast_math_x86.h"
+
+/* x86-64 ping-pong delay.  A slot of the ring is read and rewritten once per
+ * pass, and never revisited before `size` frames have elapsed, so every run
+ * up to the wrap point is element-wise and can be processed W frames at a
+ * time without changing the result.  The interleaved ring needs a shuffle
+ * per load and store; the planar one is plain full-width loads.  The split
+ * is where the speed comes from: the shuffles hide under the four streams
+ * of loads and stores, so planar gains little over interleaved (bench_delay,
+ * bench_kernels delay vs delay_plan). */
+
+static inline void delay_run_scalar(float32_t *buf, float32_t *L, float32_t *R,
+                                    uint32_t n, float32_t feedback)
+{
+    for (uint32_t i = 0; i < n; ++i) {
+        float32_t yl = buf[i * 2];
+        float32_t yr = buf[i * 2 + 1];
+        float32_t dryL = L[i];
+        float32_t dryR = R[i];
+        buf[i * 2]     = dryL + yr * feedback;
+        buf[i * 2 + 1] = dryR + yl * feedback;
+        L[i] = dryL + yl;
+        R[i] = dryR + yr;
+    }
+}
+
+static void delay_run(float32_t *buf, float32_t *L, float32_t *R,
+                      uint32_t n, float32_t feedback)
+{
+    uint32_t i = 0;
+#if X86_SIMD_WIDTH == 4
+    const __m128 fb = _mm_set1_ps(feedback);
+    for (; i + 4 <= n; i += 4) {
+        __m128 b0 = _mm_loadu_ps(buf + i * 2);       /* l0 r0 l1 r1 */
+        __m128 b1 = _mm_loadu_ps(buf + i * 2 + 4);   /* l2 r2 l3 r3 */
+        __m128 yl = _mm_shuffle_ps(b0, b1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 yr = _mm_shuffle_ps(b0, b1, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 dl = _mm_loadu_ps(L + i);
+        __m128 dr = _mm_loadu_ps(R + i);
+        __m128 nl = _mm_add_ps(dl, _mm_mul_ps(yr, fb));
+        __m128 nr = _mm_add_ps(dr, _mm_mul_ps(yl, fb));
+        _mm_storeu_ps(buf + i * 2,     _mm_unpacklo_ps(nl, nr));
+        _mm_storeu_ps(buf + i * 2 + 4, _mm_unpackhi_ps(nl, nr));
+        _mm_storeu_ps(L + i, _mm_add_ps(dl, yl));
+        _mm_storeu_ps(R + i, _mm_add_ps(dr, yr));
+    }
+#elif X86_SIMD_WIDTH >= 8
+    const __m256 fb = _mm256_set1_ps(feedback);
+    for (; i + 8 <= n; i += 8) {
+        __m256 b0 = _mm256_loadu_ps(buf + i * 2);      /* frames 0-3 */
+        __m256 b1 = _mm256_loadu_ps(buf + i * 2 + 8);  /* frames 4-7 */
+        /* per-lane deinterleave leaves 64-bit pairs as {0,1,4,5 | 2,3,6,7} */
+        __m256 yl = _mm256_shuffle_ps(b0, b1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 yr = _mm256_shuffle_ps(b0, b1, _MM_SHUFFLE(3, 1, 3, 1));
+        yl = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(yl), _MM_SHUFFLE(3, 1, 2, 0)));
+        yr = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(yr), _MM_SHUFFLE(3, 1, 2, 0)));
+        __m256 dl = _mm256_loadu_ps(L + i);
+        __m256 dr = _mm256_loadu_ps(R + i);
+        __m256 nl = _mm256_add_ps(dl, _mm256_mul_ps(yr, fb));
+        __m256 nr = _mm256_add_ps(dr, _mm256_mul_ps(yl, fb));
+        nl = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(nl), _MM_SHUFFLE(3, 1, 2, 0)));
+        nr = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(nr), _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_ps(buf + i * 2,     _mm256_unpacklo_ps(nl, nr));
+        _mm256_storeu_ps(buf + i * 2 + 8, _mm256_unpackhi_ps(nl, nr));
+        _mm256_storeu_ps(L + i, _mm256_add_ps(dl, yl));
+        _mm256_storeu_ps(R + i, _mm256_add_ps(dr, yr));
+    }
+#endif
+    delay_run_scalar(buf + i * 2, L + i, R + i, n - i, feedback);
+}
+
+static void delay_run_planar(float32_t *bl, float32_t *br, float32_t *L, float32_t *R,
+                             uint32_t n, float32_t feedback)
+{
+    uint32_t i = 0;
+#if X86_SIMD_WIDTH > 1
+    const vf_t fb = VF_SET1(feedback);
+    for (; i + X86_SIMD_WIDTH <= n; i += X86_SIMD_WIDTH) {
+        const vf_t yl = VF_LOAD(bl + i), yr = VF_LOAD(br + i);
+        const vf_t dl = VF_LOAD(L + i), dr = VF_LOAD(R + i);
+        VF_STORE(bl + i, VF_ADD(dl, VF_MUL(yr, fb)));
+        VF_STORE(br + i, VF_ADD(dr, VF_MUL(yl, fb)));
+        VF_STORE(L + i, VF_ADD(dl, yl));
+        VF_STORE(R + i, VF_ADD(dr, yr));
+    }
+#endif
+    for (; i < n; ++i) {
+        float32_t yl = bl[i], yr = br[i];
+        float32_t dryL = L[i], dryR = R[i];
+        bl[i] = dryL + yr * feedback;
+        br[i] = dryR + yl * feedback;
+        L[i] = dryL + yl;
+        R[i] = dryR + yr;
+    }
+}
+
+void X86_KFN(delay_process_block)(delay_t *d, float32_t *L, float32_t *R, uint32_t n, float32_t feedback)
+{
+    const uint32_t size = d->size;
+    if (size == 0) return;
+    uint32_t idx = d->idx;
+    if (idx >= size) idx = 0; /* same pre-wrap guard as delay.s */
+
+    while (n > 0) {
+        uint32_t run = size - idx;
+        if (run > n) run = n;
+        if (d->layout == DELAY_PLANAR)
+            delay_run_planar(d->buf + idx, d->buf + size + idx, L, R, run, feedback);
+        else
+            delay_run(d->buf + idx * 2, L, R, run, feedback);
+        L += run; R += run; n -= run;
+        idx += run;
+        if (idx >= size) idx = 0;
+    }
+    d->idx = idx;
+}
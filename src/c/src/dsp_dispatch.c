@@ -0,0 +1,228 @@
+#include "dsp_dispatch.h"
+#include "noise.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Kernel variants are built from src/<kernel>_x86.c with X86_KERNEL_SUFFIX set
+ * (see fast_math_x86.h and the Makefile). */
+#define DSP_DECLARE_VARIANT(sfx) \
+    void kick_process##sfx(kick_t *, float32_t *, float32_t *, uint32_t); \
+    void snare_process##sfx(snare_t *, float32_t *, float32_t *, uint32_t); \
+    void hat_process##sfx(hat_t *, float32_t *, float32_t *, uint32_t); \
+    void melody_process##sfx(melody_t *, float32_t *, float32_t *, uint32_t); \
+    void fm_voice_process##sfx(fm_voice_t *, float32_t *, float32_t *, uint32_t); \
+    void kick_skip##sfx(kick_t *, uint32_t); \
+    void snare_skip##sfx(snare_t *, uint32_t); \
+    void hat_skip##sfx(hat_t *, uint32_t); \
+    void melody_skip##sfx(melody_t *, uint32_t); \
+    void fm_voice_skip##sfx(fm_voice_t *, uint32_t); \
+    void fm_voice_phasor_process##sfx(fm_voice_t *, float32_t *, float32_t *, uint32_t); \
+    void fm_voice_phasor_skip##sfx(fm_voice_t *, uint32_t); \
+    void fm_bank_process##sfx(fm_bank_t *, float32_t *, float32_t *, uint32_t); \
+    void delay_process_block##sfx(delay_t *, float32_t *, float32_t *, uint32_t, float32_t); \
+    void limiter_process##sfx(limiter_t *, float32_t *, float32_t *, uint32_t); \
+    void limiter_tp_process##sfx(limiter_t *, float32_t *, float32_t *, uint32_t); \
+    void osc_sine_block##sfx(osc_t *, float32_t *, uint32_t, float32_t, float32_t); \
+    void osc_saw_block##sfx(osc_t *, float32_t *, uint32_t, float32_t, float32_t); \
+    void osc_square_block##sfx(osc_t *, float32_t *, uint32_t, float32_t, float32_t); \
+    void osc_triangle_block##sfx(osc_t *, float32_t *, uint32_t, float32_t, float32_t); \
+    void noise_block##sfx(rng_t *, float *, uint32_t); \
+    void wavetable_block##sfx(const float32_t *, uint32_t *, uint32_t, float32_t *, uint32_t); \
+    uint32_t resampler_run##sfx(resampler_t *, float32_t *, float32_t *, uint32_t); \
+    void pcm_convert##sfx(pcm_conv_t *, const float *, const float *, uint32_t, void *);
+
+#define DSP_VARIANT_TABLE(sfx) { \
+    kick_process##sfx, snare_process##sfx, hat_process##sfx, melody_process##sfx, \
+    fm_voice_process##sfx, kick_skip##sfx, snare_skip##sfx, hat_skip##sfx, \
+    melody_skip##sfx, fm_voice_skip##sfx, fm_voice_phasor_process##sfx, \
+    fm_voice_phasor_skip##sfx, fm_bank_process##sfx, delay_process_block##sfx, \
+    limiter_process##sfx, limiter_tp_process##sfx, osc_sine_block##sfx, osc_saw_block##sfx, \
+    osc_square_block##sfx, osc_triangle_block##sfx, noise_block##sfx, \
+    wavetable_block##sfx, resampler_run##sfx, pcm_convert##sfx }
+
+#if defined(__x86_64__) || defined(_M_X64)
+DSP_DECLARE_VARIANT(_scalar)
+DSP_DECLARE_VARIANT(_sse41)
+DSP_DECLARE_VARIANT(_avx2)
+DSP_DECLARE_VARIANT(_avx512)
+
+static const dsp_kernels_t s_variants[DSP_LEVEL_COUNT] = {
+    [DSP_LEVEL_SCALAR] = DSP_VARIANT_TABLE(_scalar),
+    [DSP_LEVEL_SSE41]  = DSP_VARIANT_TABLE(_sse41),
+    [DSP_LEVEL_AVX2]   = DSP_VARIANT_TABLE(_avx2),
+    [DSP_LEVEL_AVX512] = DSP_VARIANT_TABLE(_avx512),
+};
+dsp_kernels_t g_dsp = DSP_VARIANT_TABLE(_scalar);
+#else
+#error "dsp_dispatch.c is only built for x86-64 hosts (arm64 links the NEON assembly directly)"
+#endif
+
+static const char *s_level_names[DSP_LEVEL_COUNT] = {
+    "scalar", "sse41", "avx2", "avx512"
+};
+
+static const char *s_fm_names[DSP_FM_COUNT] = { "arm", "phasor" };
+
+static dsp_level_t s_level = DSP_LEVEL_SCALAR;
+static int s_initialised = 0;
+static dsp_fm_model_t s_fm = DSP_FM_ARM;
+static int s_fm_chosen = 0;
+
+/* Point the public FM entry points at the selected model's kernels. */
+static void apply_fm_model(void)
+{
+    const dsp_kernels_t *k = &s_variants[s_level];
+    g_dsp.fm_voice_process = s_fm == DSP_FM_PHASOR ? k->fm_voice_phasor_process : k->fm_voice_process;
+    g_dsp.fm_voice_skip    = s_fm == DSP_FM_PHASOR ? k->fm_voice_phasor_skip : k->fm_voice_skip;
+}
+
+const char *dsp_level_name(dsp_level_t level)
+{
+    return (level < DSP_LEVEL_COUNT) ? s_level_names[level] : "unknown";
+}
+
+dsp_level_t dsp_level_from_name(const char *name)
+{
+    for (int l = 0; l < DSP_LEVEL_COUNT; ++l)
+        if (strcmp(name, s_level_names[l]) == 0) return (dsp_level_t)l;
+    return DSP_LEVEL_COUNT;
+}
+
+static int cpu_supports(dsp_level_t level)
+{
+    __builtin_cpu_init();
+    switch (level) {
+    case DSP_LEVEL_SCALAR: return 1;
+    case DSP_LEVEL_SSE41:  return __builtin_cpu_supports("sse4.1");
+    case DSP_LEVEL_AVX2:   return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case DSP_LEVEL_AVX512: return __builtin_cpu_supports("avx512f");
+    default:               return 0;
+    }
+}
+
+int dsp_level_available(dsp_level_t level)
+{
+    return level < DSP_LEVEL_COUNT && s_variants[level].kick_process != NULL && cpu_supports(level);
+}
+
+dsp_level_t dsp_detect_level(void)
+{
+    for (int l = DSP_LEVEL_COUNT - 1; l > DSP_LEVEL_SCALAR; --l)
+        if (dsp_level_available((dsp_level_t)l)) return (dsp_level_t)l;
+    return DSP_LEVEL_SCALAR;
+}
+
+dsp_level_t dsp_current_level(void)
+{
+    return s_level;
+}
+
+int dsp_dispatch_select(dsp_level_t level)
+{
+    if (!dsp_level_available(level)) return -1;
+    g_dsp = s_variants[level];
+    s_level = level;
+    s_initialised = 1;
+    apply_fm_model();
+    return 0;
+}
+
+const char *dsp_fm_name(dsp_fm_model_t model)
+{
+    return (model < DSP_FM_COUNT) ? s_fm_names[model] : "unknown";
+}
+
+dsp_fm_model_t dsp_fm_from_name(const char *name)
+{
+    for (int m = 0; m < DSP_FM_COUNT; ++m)
+        if (strcmp(name, s_fm_names[m]) == 0) return (dsp_fm_model_t)m;
+    return DSP_FM_COUNT;
+}
+
+dsp_fm_model_t dsp_fm_current(void)
+{
+    return s_fm;
+}
+
+int dsp_fm_select(dsp_fm_model_t model)
+{
+    if (model >= DSP_FM_COUNT) return -1;
+    s_fm = model;
+    s_fm_chosen = 1;
+    apply_fm_model();
+    return 0;
+}
+
+void dsp_dispatch_init(void)
+{
+    const char *fm = getenv("NDB_FM");
+    if (!s_fm_chosen && fm && *fm) {
+        if (dsp_fm_select(dsp_fm_from_name(fm)) != 0) {
+            fprintf(stderr, "NDB_FM=%s unknown, using %s\n", fm, dsp_fm_name(s_fm));
+            s_fm_chosen = 1;   /* keep the fallback; don't re-parse on every init */
+        }
+    }
+    if (s_initialised) return;
+    dsp_level_t level = dsp_detect_level();
+    const char *env = getenv("NDB_DSP");
+    if (env && *env) {
+        dsp_level_t want = dsp_level_from_name(env);
+        if (want != DSP_LEVEL_COUNT && dsp_level_available(want)) {
+            level = want;
+        } else {
+            fprintf(stderr, "NDB_DSP=%s not available on this host, using %s\n",
+                    env, dsp_level_name(level));
+        }
+    }
+    dsp_dispatch_select(level);
+}
+
+/* ---- Public entry points: forward to the selected variant ---- */
+void kick_process(kick_t *k, float32_t *L, float32_t *R, uint32_t n)
+{ g_dsp.kick_process(k, L, R, n); }
+void snare_process(snare_t *s, float32_t *L, float32_t *R, uint32_t n)
+{ g_dsp.snare_process(s, L, R, n); }
+void hat_process(hat_t *h, float32_t *L, float32_t *R, uint32_t n)
+{ g_dsp.hat_process(h, L, R, n); }
+void melody_process(melody_t *m, float32_t *L, float32_t *R, uint32_t n)
+{ g_dsp.melody_process(m, L, R, n); }
+void fm_voice_process(fm_voice_t *v, float32_t *L, float32_t *R, uint32_t n)
+{ g_dsp.fm_voice_process(v, L, R, n); }
+void kick_skip(kick_t *k, uint32_t n)
+{ g_dsp.kick_skip(k, n); }
+void snare_skip(snare_t *s, uint32_t n)
+{ g_dsp.snare_skip(s, n); }
+void hat_skip(hat_t *h, uint32_t n)
+{ g_dsp.hat_skip(h, n); }
+void melody_skip(melody_t *m, uint32_t n)
+{ g_dsp.melody_skip(m, n); }
+void fm_voice_skip(fm_voice_t *v, uint32_t n)
+{ g_dsp.fm_voice_skip(v, n); }
+void fm_bank_process(fm_bank_t *b, float32_t *L, float32_t *R, uint32_t n)
+{ g_dsp.fm_bank_process(b, L, R, n); }
+void delay_process_block(delay_t *d, float32_t *L, float32_t *R, uint32_t n, float32_t feedback)
+{ g_dsp.delay_process_block(d, L, R, n, feedback); }
+void limiter_process(limiter_t *l, float32_t *L, float32_t *R, uint32_t n)
+{
+    if(l->mode == LIMITER_TRUE_PEAK) g_dsp.limiter_tp_process(l, L, R, n);
+    else g_dsp.limiter_process(l, L, R, n);
+}
+void limiter_tp_process(limiter_t *l, float32_t *L, float32_t *R, uint32_t n)
+{ g_dsp.limiter_tp_process(l, L, R, n); }
+void osc_sine_block(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float32_t sr)
+{ g_dsp.osc_sine_block(o, out, n, freq, sr); }
+void osc_saw_block(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float32_t sr)
+{ g_dsp.osc_saw_block(o, out, n, freq, sr); }
+void osc_square_block(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float32_t sr)
+{ g_dsp.osc_square_block(o, out, n, freq, sr); }
+void osc_triangle_block(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float32_t sr)
+{ g_dsp.osc_triangle_block(o, out, n, freq, sr); }
+void noise_block(rng_t *rng, float *out, uint32_t n)
+{ g_dsp.noise_block(rng, out, n); }
+void wavetable_block(const float32_t *tab, uint32_t *phase, uint32_t inc, float32_t *out, uint32_t n)
+{ g_dsp.wavetable_block(tab, phase, inc, out, n); }
+uint32_t resampler_run(resampler_t *r, float32_t *outL, float32_t *outR, uint32_t max)
+{ return g_dsp.resampler_run(r, outL, outR, max); }
+void pcm_convert(pcm_conv_t *c, const float *L, const float *R, uint32_t n, void *out)
+{ g_dsp.pcm_convert(c, L, R, n, out); }
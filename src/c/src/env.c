@@ -0,0 +1,97 @@
+#include "env.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ENV_TABLE_MIN_LEN 4096u
+
+void exp_env_block(float *out, uint32_t n, float rate, float sr)
+{
+    for(uint32_t i = 0; i < n; i++)
+        out[i] = env_exp_decay((float32_t)i / sr, rate);
+}
+
+typedef struct {
+    env_shape_t shape;
+    float32_t decay;
+    float32_t sr;
+    uint32_t len;
+    float32_t *tab;
+} env_entry_t;
+
+/* Entries [0, s_count) are immutable once published, so readers scan them
+   without the lock; s_lock only serialises builders. */
+static env_entry_t s_entry[ENV_TABLE_SLOTS];
+static _Atomic uint32_t s_count;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const float32_t *env_find(uint32_t count, env_shape_t shape, float32_t decay,
+                                 float32_t sr, uint32_t len)
+{
+    /* Newest first: a longer rebuild shadows the table it replaced */
+    for(uint32_t i = count; i-- > 0;){
+        const env_entry_t *e = &s_entry[i];
+        if(e->shape == shape && e->decay == decay && e->sr == sr && e->len >= len)
+            return e->tab;
+    }
+    return NULL;
+}
+
+/* The per-sample formulas the voices would otherwise evaluate, written the
+   same way so the tables match them bit for bit. */
+static void env_fill(float32_t *tab, uint32_t len, env_shape_t shape, float32_t decay, float32_t sr)
+{
+    for(uint32_t i = 0; i < len; i++){
+        float32_t t = (float32_t)i / sr;
+        tab[i] = shape == ENV_SHAPE_RATIONAL ? 1.0f / (1.0f + decay * t)
+                                             : env_exp_decay(t, decay);
+    }
+}
+
+const float32_t *env_table_get(env_shape_t shape, float32_t decay, float32_t sr, uint32_t len)
+{
+    if(len == 0) len = 1;
+    if(len > ENV_TABLE_MAX_LEN) return NULL;
+    uint32_t count = atomic_load_explicit(&s_count, memory_order_acquire);
+    const float32_t *tab = env_find(count, shape, decay, sr, len);
+    if(tab) return tab;
+
+    pthread_mutex_lock(&s_lock);
+    count = atomic_load_explicit(&s_count, memory_order_relaxed);
+    tab = env_find(count, shape, decay, sr, len);
+    if(!tab && count < ENV_TABLE_SLOTS){
+        /* Whole powers of two, so note lengths that wander with the tempo
+           share a table or two instead of filling the cache */
+        uint32_t size = ENV_TABLE_MIN_LEN;
+        while(size < len) size <<= 1;
+        float32_t *t = aligned_alloc(64, (size_t)size * sizeof(float32_t));
+        if(t){
+            env_fill(t, size, shape, decay, sr);
+            s_entry[count] = (env_entry_t){ shape, decay, sr, size, t };
+            atomic_store_explicit(&s_count, count + 1, memory_order_release);
+            tab = t;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return tab;
+}
+
+size_t env_table_bytes(void)
+{
+    size_t bytes = 0;
+    uint32_t count = atomic_load_explicit(&s_count, memory_order_acquire);
+    for(uint32_t i = 0; i < count; i++)
+        bytes += (size_t)s_entry[i].len * sizeof(float32_t);
+    return bytes;
+}
+
+void env_table_clear(void)
+{
+    pthread_mutex_lock(&s_lock);
+    uint32_t count = atomic_load_explicit(&s_count, memory_order_relaxed);
+    atomic_store_explicit(&s_count, 0, memory_order_release);
+    for(uint32_t i = 0; i < count; i++) free(s_entry[i].tab);
+    memset(s_entry, 0, sizeof(s_entry));
+    pthread_mutex_unlock(&s_lock);
+}
@@ -1,3 +1,60 @@
 #include "event_queue.h"
-/* All functions are inline in the header. This translation unit exists
-   to satisfy the build system linking rules. */ 
\ No newline at end of file
+#include <stdlib.h>
+#include <string.h>
+
+int eq_init(event_queue_t *q, uint32_t step_samples)
+{
+    q->events = malloc(sizeof(event_t) * EQ_INITIAL_CAPACITY);
+    q->capacity = q->events ? EQ_INITIAL_CAPACITY : 0;
+    q->count = 0;
+    q->step_samples = step_samples ? step_samples : 1;
+    memset(q->step_start, 0, sizeof(q->step_start));
+    return q->events ? 0 : -1;
+}
+
+void eq_free(event_queue_t *q)
+{
+    free(q->events);
+    q->events = NULL;
+    q->count = q->capacity = 0;
+    memset(q->step_start, 0, sizeof(q->step_start));
+}
+
+int eq_push(event_queue_t *q, uint32_t time, uint8_t type, uint8_t aux)
+{
+    if(q->count == q->capacity){
+        uint32_t cap = q->capacity ? q->capacity * 2 : EQ_INITIAL_CAPACITY;
+        event_t *grown = realloc(q->events, sizeof(event_t) * cap);
+        if(!grown) return -1;
+        q->events = grown;
+        q->capacity = cap;
+    }
+    q->events[q->count++] = (event_t){time, type, aux, 0, 0.0f};
+    return 0;
+}
+
+void eq_build_index(event_queue_t *q)
+{
+    /* The builders push step by step, so this is normally one check.
+       Insertion sort keeps same-time events in push order. */
+    for(uint32_t i = 1; i < q->count; i++){
+        event_t e = q->events[i];
+        uint32_t j = i;
+        while(j > 0 && q->events[j - 1].time > e.time){
+            q->events[j] = q->events[j - 1];
+            j--;
+        }
+        q->events[j] = e;
+    }
+
+    /* Counting pass + prefix sum.  Events past the last step are kept in
+       the array but not indexed. */
+    uint32_t counts[TOTAL_STEPS] = {0};
+    for(uint32_t i = 0; i < q->count; i++){
+        uint32_t step = q->events[i].time / q->step_samples;
+        if(step < TOTAL_STEPS) counts[step]++;
+    }
+    q->step_start[0] = 0;
+    for(uint32_t s = 0; s < TOTAL_STEPS; s++)
+        q->step_start[s + 1] = q->step_start[s] + counts[s];
+}
@@ -0,0 +1,116 @@
+#include "fm_bank.h"
+#include <math.h>
+#include <string.h>
+
+#define FM_OUT_SCALE 0.25f
+#define Q32_TURN 4294967296.0
+#define Q32_TO_RAD ((float32_t)(6.283185307179586 / Q32_TURN))
+
+typedef struct {
+    uint8_t ops;
+    uint8_t carriers;                 /* bit per heard operator */
+    uint8_t mods[FM_BANK_MAX_OPS];    /* bits of the operators modulating k */
+} fm_algo_def_t;
+
+static const fm_algo_def_t s_algos[FM_ALGO_COUNT] = {
+    [FM_ALGO_PAIR]        = { 2, 0x01, { 1u << 1 } },
+    [FM_ALGO_STACK4]      = { 4, 0x01, { 1u << 1, 1u << 2, 1u << 3 } },
+    [FM_ALGO_TWO_PAIRS]   = { 4, 0x05, { 1u << 1, 0, 1u << 3 } },
+    [FM_ALGO_BRANCH4]     = { 4, 0x01, { (1u << 1) | (1u << 2) | (1u << 3) } },
+    [FM_ALGO_STACK6]      = { 6, 0x01, { 1u << 1, 1u << 2, 1u << 3, 1u << 4, 1u << 5 } },
+    [FM_ALGO_THREE_PAIRS] = { 6, 0x15, { 1u << 1, 0, 1u << 3, 0, 1u << 5 } },
+    [FM_ALGO_ORGAN6]      = { 6, 0x3F, { 0 } },
+};
+
+void fm_bank_init(fm_bank_t *b, float32_t sr)
+{
+    memset(b, 0, sizeof(*b));
+    b->sr = sr;
+}
+
+void fm_patch_from_params(fm_patch_t *p, const fm_params_t *params)
+{
+    memset(p, 0, sizeof(*p));
+    p->algo = FM_ALGO_PAIR;
+    p->op[0] = (fm_op_t){ 1.0f, 1.0f, params->decay };
+    p->op[1] = (fm_op_t){ params->ratio, params->index, params->decay };
+}
+
+int fm_bank_trigger(fm_bank_t *b, const fm_patch_t *p, float32_t freq,
+                    float32_t duration_sec, float32_t amp)
+{
+    if (b->active == 0xFFFFFFFFu) return -1;
+    return fm_bank_trigger_lane(b, __builtin_ctz(~b->active), p, freq, duration_sec, amp);
+}
+
+int fm_bank_trigger_lane(fm_bank_t *b, int v, const fm_patch_t *p, float32_t freq,
+                         float32_t duration_sec, float32_t amp)
+{
+    const uint32_t len = (uint32_t)(duration_sec * b->sr);
+    b->remaining[v] = 0;
+    b->active &= ~(1u << v);
+    if (len == 0 || p->algo >= FM_ALGO_COUNT) return -1;
+    const fm_algo_def_t *a = &s_algos[p->algo];
+
+    for (int k = 0; k < FM_BANK_MAX_OPS; k++) {
+        const fm_op_t *op = &p->op[k];
+        const int used = k < a->ops;
+        const double turns = (double)freq * op->ratio / b->sr;
+        b->phase[k][v] = 0;
+        b->inc[k][v] = used ? (uint32_t)(uint64_t)((turns - floor(turns)) * Q32_TURN + 0.5) : 0;
+        b->env[k][v] = used ? op->level : 0.0f;
+        b->coef[k][v] = used ? expf(-op->decay / b->sr) : 0.0f;
+        b->level[k][v] = b->env[k][v];
+        b->decay[k][v] = op->decay;
+        b->rot_c[k][v] = cosf((float32_t)(int32_t)b->inc[k][v] * Q32_TO_RAD);
+        b->rot_s[k][v] = sinf((float32_t)(int32_t)b->inc[k][v] * Q32_TO_RAD);
+        b->mix[k][v] = (a->carriers >> k) & 1 ? amp * FM_OUT_SCALE : 0.0f;
+        for (int j = 0; j < FM_BANK_MAX_OPS; j++)
+            b->mod[k][j][v] = (a->mods[k] >> j) & 1 ? 1.0f : 0.0f;
+        b->modby[v][k] = a->mods[k];
+    }
+    b->ops[v] = a->ops;
+    b->remaining[v] = len;
+    b->length[v] = len;
+    b->active |= 1u << v;
+    return v;
+}
+
+void fm_bank_skip(fm_bank_t *b, uint32_t n)
+{
+    for (uint32_t live = b->active; live; live &= live - 1) {
+        const int v = __builtin_ctz(live);
+        const uint32_t run = b->remaining[v] < n ? b->remaining[v] : n;
+        for (int k = 0; k < b->ops[v]; k++)
+            b->phase[k][v] += b->inc[k][v] * run;
+    }
+    fm_bank_retire(b, n);
+}
+
+#ifndef DSP_DISPATCH /* x86: level-matched kernels in src/fm_bank_x86.c */
+/* Portable renderer, one voice at a time. */
+void fm_bank_process(fm_bank_t *b, float32_t *L, float32_t *R, uint32_t n)
+{
+    fm_bank_anchor(b);
+    for (uint32_t live = b->active; live; live &= live - 1) {
+        const int v = __builtin_ctz(live);
+        const int ops = b->ops[v];
+        const uint32_t run = b->remaining[v] < n ? b->remaining[v] : n;
+        for (uint32_t t = 0; t < run; t++) {
+            float32_t out[FM_BANK_MAX_OPS], y = 0.0f;
+            for (int k = ops - 1; k >= 0; k--) {
+                float32_t arg = (float32_t)(int32_t)b->phase[k][v] * Q32_TO_RAD;
+                for (uint32_t m = b->modby[v][k]; m; m &= m - 1)
+                    arg += b->mod[k][__builtin_ctz(m)][v] * out[__builtin_ctz(m)];
+                out[k] = sinf(arg) * b->env[k][v];
+                y += b->mix[k][v] * out[k];
+                b->env[k][v] *= b->coef[k][v];
+                b->phase[k][v] += b->inc[k][v];
+            }
+            L[t] += y;
+            R[t] += y;
+        }
+    }
+    fm_bank_retire(b, n);
+}
+#endif
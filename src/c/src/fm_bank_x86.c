@@ -0,0 +1,221 @@
+#include "fm_bank.h"
+#include "fast_math_x86.h"
+
+/* x86-64 FM bank kernel: voices are lanes.  Each group of X86_SIMD_WIDTH
+ * lanes with a live voice is rendered sample by sample, operators from the
+ * highest down so every modulator's output is ready; the group's lanes are
+ * gated by their remaining length and summed lane-wise over a chunk, with
+ * one horizontal add per frame into the mono output.  Lanes
+ * run as many operators as the group's largest patch, the extra ones
+ * having zero level and weight, and only the modulator pairs some lane of
+ * the group uses are evaluated, their weights held in registers.
+ * Operators nothing in the group modulates are complex rotators rather than
+ * polynomial sines, re-anchored from their exact Q32 phase every chunk.
+ *
+ * A group with few live lanes (the generator's FM pools, mostly) wastes
+ * most of each vector that way, so its voices are rendered one at a time
+ * instead, X86_SIMD_WIDTH consecutive frames per vector as in the phasor
+ * voice kernel. */
+#define Q32_TO_RAD ((float32_t)(6.283185307179586 / 4294967296.0))
+#define FM_BANK_CHUNK 64   /* frames summed per lane before the horizontal add */
+#define FM_BANK_SPARSE(w) ((w) / 2)   /* live lanes a group renders one by one */
+
+#if X86_SIMD_WIDTH > 1
+static inline void bank_group(fm_bank_t *b, uint32_t v0, int ops, const uint8_t *modby,
+                              uint32_t run, vf_t *acc)
+{
+    vi_t ph[FM_BANK_MAX_OPS], inc[FM_BANK_MAX_OPS];
+    vf_t env[FM_BANK_MAX_OPS], coef[FM_BANK_MAX_OPS], mix[FM_BANK_MAX_OPS];
+    vf_t w[FM_BANK_MAX_OPS][FM_BANK_MAX_OPS];
+    vf_t rc[FM_BANK_MAX_OPS], rs[FM_BANK_MAX_OPS], c[FM_BANK_MAX_OPS], s[FM_BANK_MAX_OPS];
+    const vf_t q2r = VF_SET1(Q32_TO_RAD), one = VF_SET1(1.0f);
+    uint32_t rot = 0;   /* operators rendered by rotator */
+    for (int k = 0; k < ops; ++k) {
+        ph[k] = VI_LOAD(&b->phase[k][v0]);
+        inc[k] = VI_LOAD(&b->inc[k][v0]);
+        env[k] = VF_LOAD(&b->env[k][v0]);
+        coef[k] = VF_LOAD(&b->coef[k][v0]);
+        mix[k] = VF_LOAD(&b->mix[k][v0]);
+        for (uint32_t m = modby[k]; m; m &= m - 1)
+            w[k][__builtin_ctz(m)] = VF_LOAD(&b->mod[k][__builtin_ctz(m)][v0]);
+        if (!modby[k]) {
+            const vf_t a = VF_MUL(VI_TO_F(ph[k]), q2r);
+            rot |= 1u << k;
+            rc[k] = VF_LOAD(&b->rot_c[k][v0]);
+            rs[k] = VF_LOAD(&b->rot_s[k][v0]);
+            c[k] = vf_sin_wrap(VF_ADD(a, VF_SET1(0.5f * X86_PI)));
+            s[k] = vf_sin_wrap(a);
+        }
+    }
+    const vf_t rem = VI_TO_F(VI_LOAD(&b->remaining[v0]));
+    vf_t t = VF_SET1(0.0f);
+
+    for (uint32_t i = 0; i < run; ++i) {
+        vf_t out[FM_BANK_MAX_OPS], y = VF_SET1(0.0f);
+        for (int k = ops - 1; k >= 0; --k) {
+            if (rot >> k & 1) {
+                out[k] = VF_MUL(s[k], env[k]);
+                const vf_t cn = VF_SUB(VF_MUL(c[k], rc[k]), VF_MUL(s[k], rs[k]));
+                s[k] = VF_ADD(VF_MUL(s[k], rc[k]), VF_MUL(c[k], rs[k]));
+                c[k] = cn;
+            } else {
+                vf_t arg = VF_MUL(VI_TO_F(ph[k]), q2r);
+                for (uint32_t m = modby[k]; m; m &= m - 1) {
+                    const int j = __builtin_ctz(m);
+                    arg = VF_ADD(arg, VF_MUL(w[k][j], out[j]));
+                }
+                out[k] = VF_MUL(vf_sin_wrap(arg), env[k]);
+            }
+            y = VF_ADD(y, VF_MUL(mix[k], out[k]));
+            env[k] = VF_MUL(env[k], coef[k]);
+            ph[k] = VI_ADD(ph[k], inc[k]);
+        }
+        acc[i] = VF_ADD(acc[i], VF_AND(VF_LT(t, rem), y));
+        t = VF_ADD(t, one);
+    }
+
+    for (int k = 0; k < ops; ++k) {
+        VI_STORE(&b->phase[k][v0], ph[k]);
+        VF_STORE(&b->env[k][v0], env[k]);
+    }
+}
+
+
+/* One voice, frames across the vector.  Every operator is a polynomial
+ * sine of its Q32 phase plus its modulators' outputs for the same frame. */
+static inline void bank_lane(fm_bank_t *b, uint32_t v, uint32_t run, float32_t *L, float32_t *R)
+{
+    enum { W = X86_SIMD_WIDTH };
+    const int ops = b->ops[v];
+    const uint8_t *modby = b->modby[v];
+    uint32_t i = 0;
+
+    if (run >= W) {
+        vi_t ph[FM_BANK_MAX_OPS], incW[FM_BANK_MAX_OPS];
+        vf_t env[FM_BANK_MAX_OPS], coefW[FM_BANK_MAX_OPS], mix[FM_BANK_MAX_OPS];
+        const vf_t q2r = VF_SET1(Q32_TO_RAD);
+        for (int k = 0; k < ops; ++k) {
+            uint32_t q_l[W];
+            float32_t e_l[W], e = b->env[k][v], cw = 1.0f;
+            for (int j = 0; j < W; ++j) {
+                q_l[j] = b->phase[k][v] + (uint32_t)j * b->inc[k][v];
+                e_l[j] = e;
+                e *= b->coef[k][v];
+                cw *= b->coef[k][v];
+            }
+            ph[k] = VI_LOAD(q_l);
+            incW[k] = VI_SET1(b->inc[k][v] * (uint32_t)W);
+            env[k] = VF_LOAD(e_l);
+            coefW[k] = VF_SET1(cw);
+            mix[k] = VF_SET1(b->mix[k][v]);
+        }
+
+        const uint32_t blocks = run / W;
+        for (uint32_t n = 0; n < blocks; ++n, i += W) {
+            vf_t out[FM_BANK_MAX_OPS], y = VF_SET1(0.0f);
+            for (int k = ops - 1; k >= 0; --k) {
+                vf_t arg = VF_MUL(VI_TO_F(ph[k]), q2r);
+                for (uint32_t m = modby[k]; m; m &= m - 1) {
+                    const int j = __builtin_ctz(m);
+                    arg = VF_ADD(arg, VF_MUL(VF_SET1(b->mod[k][j][v]), out[j]));
+                }
+                out[k] = VF_MUL(vf_sin_wrap(arg), env[k]);
+                y = VF_ADD(y, VF_MUL(mix[k], out[k]));
+                env[k] = VF_MUL(env[k], coefW[k]);
+                ph[k] = VI_ADD(ph[k], incW[k]);
+            }
+            VF_STORE(L + i, VF_ADD(VF_LOAD(L + i), y));
+            VF_STORE(R + i, VF_ADD(VF_LOAD(R + i), y));
+        }
+        /* Lane 0 is the next frame */
+        for (int k = 0; k < ops; ++k) {
+            b->phase[k][v] += blocks * W * b->inc[k][v];
+            b->env[k][v] = vf_lane(env[k], 0);
+        }
+    }
+
+    for (; i < run; ++i) {
+        float32_t out[FM_BANK_MAX_OPS], y = 0.0f;
+        for (int k = ops - 1; k >= 0; --k) {
+            float32_t arg = (float32_t)(int32_t)b->phase[k][v] * Q32_TO_RAD;
+            for (uint32_t m = modby[k]; m; m &= m - 1) {
+                const int j = __builtin_ctz(m);
+                arg += b->mod[k][j][v] * out[j];
+            }
+            out[k] = x86_sin_wrap(arg) * b->env[k][v];
+            y += b->mix[k][v] * out[k];
+            b->env[k][v] *= b->coef[k][v];
+            b->phase[k][v] += b->inc[k][v];
+        }
+        L[i] += y;
+        R[i] += y;
+    }
+}
+#endif
+
+void X86_KFN(fm_bank_process)(fm_bank_t *b, float32_t *L, float32_t *R, uint32_t n)
+{
+    fm_bank_anchor(b);
+#if X86_SIMD_WIDTH > 1
+    enum { W = X86_SIMD_WIDTH };
+    vf_t acc[FM_BANK_CHUNK];
+    uint32_t sparse = 0, c;
+    for (uint32_t v0 = 0; v0 < FM_BANK_VOICES; v0 += W) {
+        const uint32_t live = b->active & (((1u << W) - 1) << v0);
+        if (!live || __builtin_popcount(live) > FM_BANK_SPARSE(W)) continue;
+        for (uint32_t m = live; m; m &= m - 1) {
+            const uint32_t v = (uint32_t)__builtin_ctz(m);
+            bank_lane(b, v, b->remaining[v] < n ? b->remaining[v] : n, L, R);
+        }
+        sparse |= live;
+    }
+    for (c = 0; c < n && (b->active & ~sparse); c += FM_BANK_CHUNK) {
+        const uint32_t len = n - c < FM_BANK_CHUNK ? n - c : FM_BANK_CHUNK;
+        for (uint32_t i = 0; i < len; ++i) acc[i] = VF_SET1(0.0f);
+        for (uint32_t v0 = 0; v0 < FM_BANK_VOICES; v0 += W) {
+            uint32_t live = ((b->active & ~sparse) >> v0) & ((1u << W) - 1);
+            if (!live) continue;
+            int ops = 0;
+            uint32_t run = 0;
+            uint8_t modby[FM_BANK_MAX_OPS] = { 0 };
+            for (; live; live &= live - 1) {
+                const uint32_t v = v0 + (uint32_t)__builtin_ctz(live);
+                if (b->ops[v] > ops) ops = b->ops[v];
+                if (b->remaining[v] > run) run = b->remaining[v];
+                for (int k = 0; k < FM_BANK_MAX_OPS; ++k) modby[k] |= b->modby[v][k];
+            }
+            bank_group(b, v0, ops, modby, run < len ? run : len, acc);
+        }
+        for (uint32_t i = 0; i < len; ++i) {
+            const float32_t s = vf_hsum(acc[i]);
+            L[c + i] += s;
+            R[c + i] += s;
+        }
+        fm_bank_retire(b, len);
+    }
+    if (c < n) fm_bank_retire(b, n - c);
+#else
+    for (uint32_t live = b->active; live; live &= live - 1) {
+        const int v = __builtin_ctz(live);
+        const int ops = b->ops[v];
+        const uint32_t run = b->remaining[v] < n ? b->remaining[v] : n;
+        for (uint32_t i = 0; i < run; ++i) {
+            float32_t out[FM_BANK_MAX_OPS], y = 0.0f;
+            for (int k = ops - 1; k >= 0; --k) {
+                float32_t arg = (float32_t)(int32_t)b->phase[k][v] * Q32_TO_RAD;
+                for (uint32_t m = b->modby[v][k]; m; m &= m - 1) {
+                    const int j = __builtin_ctz(m);
+                    arg += b->mod[k][j][v] * out[j];
+                }
+                out[k] = x86_sin_wrap(arg) * b->env[k][v];
+                y += b->mix[k][v] * out[k];
+                b->env[k][v] *= b->coef[k][v];
+                b->phase[k][v] += b->inc[k][v];
+            }
+            L[i] += y;
+            R[i] += y;
+        }
+    }
+    fm_bank_retire(b, n);
+#endif
+}
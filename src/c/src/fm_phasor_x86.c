@@ -0,0 +1,151 @@
+#include "fm_voice.h"
+#include "fast_math_x86.h"
+#include <math.h>
+
+/* Incremental-phasor FM kernel (dsp_fm_select(DSP_FM_PHASOR)).
+ *
+ * Renders the exponential-envelope voice of attic/fm_voice_full.c,
+ * sin(cp + index0·env·sin(mp))·env·amp, at the engine's 0.25 FM output
+ * scale, with no per-sample exp, sin of the modulator or phase wrap:
+ *   - env = exp(-decay·t) advances multiplicatively (env *= exp(-decay/sr)),
+ *     like kick_t.env_coef;
+ *   - both phases are Q32 turn counters, so a lane is one integer add and
+ *     wrapping is the add's overflow;
+ *   - the modulator's sine comes from a complex rotator per lane;
+ *   - only the carrier, whose argument carries the modulation, is a
+ *     polynomial sine.
+ * The envelope and rotators pick up rounding error as they are stepped, so
+ * every FM_ANCHOR frames they are re-derived from the exact position and
+ * Q32 phases.  The phases are stored back into the voice as floats, so a
+ * call boundary costs at most one float ulp of phase. */
+#define FM_OUT_SCALE 0.25f
+#define FM_ANCHOR 256
+#define Q32_TURN 4294967296.0
+#define Q32_TO_RAD ((float32_t)(6.283185307179586 / Q32_TURN))
+
+static inline uint32_t fm_q32_turns(double turns)
+{
+    return (uint32_t)(uint64_t)((turns - floor(turns)) * Q32_TURN + 0.5);
+}
+
+static inline uint32_t fm_q32(float32_t phase)
+{
+    return fm_q32_turns((double)phase * (1.0 / 6.283185307179586));
+}
+
+static inline float32_t fm_phase(uint32_t q)
+{
+    return (float32_t)(q * (6.283185307179586 / Q32_TURN));
+}
+
+/* Signed Q32 angle in radians, [-π, π) */
+static inline float32_t fm_rad(uint32_t q)
+{
+    return (float32_t)(int32_t)q * Q32_TO_RAD;
+}
+
+void X86_KFN(fm_voice_phasor_process)(fm_voice_t *v, float32_t *L, float32_t *R, uint32_t n)
+{
+    if (v->pos >= v->len || n == 0) return;
+
+    uint32_t count = v->len - v->pos;
+    if (count > n) count = n;
+
+    const double turns = (double)v->carrier_freq / (double)v->sr;
+    const uint32_t c_inc = fm_q32_turns(turns);
+    const uint32_t m_inc = fm_q32_turns(turns * (double)v->ratio);
+    const float32_t dm = fm_rad(m_inc);
+    const float32_t rot_c = x86_sin_wrap(dm + 0.5f * X86_PI), rot_s = x86_sin_wrap(dm);
+    const float32_t decay = v->decay, sr = v->sr;
+    const float32_t coef = expf(-decay / sr);
+    const float32_t index0 = v->index0;
+    const float32_t gain = v->amp * FM_OUT_SCALE;
+    uint32_t cq = fm_q32(v->carrier_phase), mq = fm_q32(v->mod_phase);
+    uint32_t pos = v->pos;
+
+#if X86_SIMD_WIDTH > 1
+    enum { W = X86_SIMD_WIDTH };
+    const float32_t dW = fm_rad(m_inc * (uint32_t)W);
+    const vf_t rotW_c = VF_SET1(x86_sin_wrap(dW + 0.5f * X86_PI));
+    const vf_t rotW_s = VF_SET1(x86_sin_wrap(dW));
+    const vf_t coefW = VF_SET1(expf(-decay * (float32_t)W / sr));
+    const vi_t c_incW = VI_SET1(c_inc * (uint32_t)W);
+    const vf_t idx0v = VF_SET1(index0), gainv = VF_SET1(gain), q2r = VF_SET1(Q32_TO_RAD);
+#endif
+
+    for (uint32_t i = 0; i < count; ) {
+        const uint32_t end = count - i > FM_ANCHOR ? i + FM_ANCHOR : count;
+
+        /* Anchor: exact envelope and modulator phase for sample i */
+        float32_t env = expf(-decay * ((float32_t)pos / sr));
+        const float32_t ma = fm_rad(mq);
+        float32_t mc = x86_sin_wrap(ma + 0.5f * X86_PI), ms = x86_sin_wrap(ma);
+
+#if X86_SIMD_WIDTH > 1
+        if (end - i >= W) {
+            float32_t e_l[W], c_l[W], s_l[W];
+            uint32_t q_l[W];
+            for (int j = 0; j < W; ++j) {
+                e_l[j] = env; c_l[j] = mc; s_l[j] = ms; q_l[j] = cq + (uint32_t)j * c_inc;
+                float32_t c = mc * rot_c - ms * rot_s;
+                ms = ms * rot_c + mc * rot_s;
+                mc = c;
+                env *= coef;
+            }
+            vf_t e = VF_LOAD(e_l), c = VF_LOAD(c_l), s = VF_LOAD(s_l);
+            vi_t q = VI_LOAD(q_l);
+
+            const uint32_t blocks = (end - i) / W;
+            for (uint32_t b = 0; b < blocks; ++b, i += W) {
+                vf_t mod = VF_MUL(VF_MUL(idx0v, e), s);
+                vf_t y = vf_sin_wrap(VF_ADD(VF_MUL(VI_TO_F(q), q2r), mod));
+                y = VF_MUL(VF_MUL(y, e), gainv);
+                VF_STORE(L + i, VF_ADD(VF_LOAD(L + i), y));
+                VF_STORE(R + i, VF_ADD(VF_LOAD(R + i), y));
+
+                e = VF_MUL(e, coefW);
+                vf_t cn = VF_SUB(VF_MUL(c, rotW_c), VF_MUL(s, rotW_s));
+                s = VF_ADD(VF_MUL(s, rotW_c), VF_MUL(c, rotW_s));
+                c = cn;
+                q = VI_ADD(q, c_incW);
+            }
+            pos += blocks * W;
+            cq += blocks * W * c_inc;
+            mq += blocks * W * m_inc;
+
+            /* Tail continues from lane 0, which is the next sample */
+            env = vf_lane(e, 0); mc = vf_lane(c, 0); ms = vf_lane(s, 0);
+        }
+#endif
+
+        for (; i < end; ++i, ++pos) {
+            float32_t mod = index0 * env * ms;
+            float32_t y = x86_sin_wrap(fm_rad(cq) + mod) * env * gain;
+            L[i] += y;
+            R[i] += y;
+            env *= coef;
+            float32_t c = mc * rot_c - ms * rot_s;
+            ms = ms * rot_c + mc * rot_s;
+            mc = c;
+            cq += c_inc;
+            mq += m_inc;
+        }
+    }
+
+    v->carrier_phase = fm_phase(cq);
+    v->mod_phase = fm_phase(mq);
+    v->pos = pos;
+}
+
+/* The envelope is a function of pos and the phases are exact counters, so
+ * skipping is closed-form and lands where rendering would. */
+void X86_KFN(fm_voice_phasor_skip)(fm_voice_t *v, uint32_t n)
+{
+    if (v->pos >= v->len) return;
+    uint32_t count = v->len - v->pos;
+    if (count > n) count = n;
+    const double turns = (double)v->carrier_freq / (double)v->sr;
+    v->carrier_phase = fm_phase(fm_q32(v->carrier_phase) + count * fm_q32_turns(turns));
+    v->mod_phase = fm_phase(fm_q32(v->mod_phase) + count * fm_q32_turns(turns * (double)v->ratio));
+    v->pos += count;
+}
@@ -1,4 +1,5 @@
 #include "fm_presets.h"
+#include "fm_bank.h"
 
 const fm_params_t FM_PRESET_BELLS   = {3.5f, 4.0f, 0.0f, 0.15f};  // was 1.0f
 const fm_params_t FM_PRESET_CALM    = {2.0f, 2.5f, 6.0f, 0.25f};
@@ -8,4 +9,16 @@ const fm_params_t FM_PRESET_PLUCK   = {1.0f, 6.0f, 8.0f, 0.25f};
 
 const fm_params_t FM_BASS_DEFAULT = {2.0f, 5.0f, 0.0f, 0.25f};  // was 1.0f
 const fm_params_t FM_BASS_QUANTUM = {1.5f, 8.0f, 8.0f, 0.45f};
-const fm_params_t FM_BASS_PLUCKY  = {3.0f, 2.5f, 14.0f, 0.35f}; 
\ No newline at end of file
+const fm_params_t FM_BASS_PLUCKY  = {3.0f, 2.5f, 14.0f, 0.35f}; 
+
+/* Multi-operator patches for the FM bank: {ratio, level, decay} per operator */
+const fm_patch_t FM_PATCH_EPIANO = { FM_ALGO_TWO_PAIRS, {
+    {1.0f, 1.0f, 3.0f}, {1.0f, 1.8f, 6.0f}, {1.0f, 0.6f, 4.0f}, {14.0f, 0.9f, 30.0f} } };
+const fm_patch_t FM_PATCH_BRASS = { FM_ALGO_STACK4, {
+    {1.0f, 1.0f, 1.5f}, {1.0f, 2.2f, 2.0f}, {2.0f, 1.2f, 3.0f}, {1.0f, 0.8f, 1.0f} } };
+const fm_patch_t FM_PATCH_BELL6 = { FM_ALGO_THREE_PAIRS, {
+    {1.0f, 1.0f, 1.0f}, {3.5f, 2.5f, 2.0f}, {2.0f, 0.5f, 1.5f},
+    {5.19f, 1.5f, 3.0f}, {4.0f, 0.3f, 2.5f}, {7.1f, 1.0f, 4.0f} } };
+const fm_patch_t FM_PATCH_ORGAN = { FM_ALGO_ORGAN6, {
+    {0.5f, 0.5f, 0.5f}, {1.0f, 1.0f, 0.5f}, {2.0f, 0.6f, 0.5f},
+    {3.0f, 0.4f, 0.5f}, {4.0f, 0.3f, 0.5f}, {6.0f, 0.2f, 0.5f} } };
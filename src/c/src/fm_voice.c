@@ -1,5 +1,8 @@
 #include "fm_voice.h"
-#include <stdio.h>
+#include "trace.h"
+#include "env.h"
+
+#define TAU 6.28318530717958647692f
 
 void fm_voice_init(fm_voice_t *v, float32_t sr)
 {
@@ -8,6 +11,7 @@ void fm_voice_init(fm_voice_t *v, float32_t sr)
     v->pos = 0;
     v->carrier_phase = 0.0f;
     v->mod_phase = 0.0f;
+    v->env_tab = NULL;
 }
 
 void fm_voice_trigger(fm_voice_t *v, float32_t carrier_freq, float32_t duration_sec, float32_t ratio, float32_t index, float32_t amp, float32_t decay)
@@ -19,8 +23,29 @@ void fm_voice_trigger(fm_voice_t *v, float32_t carrier_freq, float32_t duration_
     v->decay = decay;
     v->len = (uint32_t)(duration_sec * v->sr);
     v->pos = 0;
-    printf("FM_TRIGGER cf=%.2f dur=%.2f ratio=%.2f idx=%.2f amp=%.2f len=%u\n", carrier_freq, duration_sec, ratio, index, amp, v->len);
+    v->env_tab = env_table_get(ENV_SHAPE_RATIONAL, decay, v->sr, v->len);
+    TRACE_EMIT(TRACE_FM, 0, carrier_freq, duration_sec, ratio, index);
+}
+
+#ifndef DSP_DISPATCH /* x86: level-matched kernels in src/fm_voice_x86.c */
+/* The envelope is a function of pos; only the two phases carry over. */
+void fm_voice_skip(fm_voice_t *v, uint32_t n)
+{
+    if(v->pos >= v->len) return;
+    uint32_t count = v->len - v->pos;
+    if(count > n) count = n;
+    const float32_t c_inc = TAU * v->carrier_freq / v->sr;
+    const float32_t m_inc = c_inc * v->ratio;
+    float32_t cp = v->carrier_phase, mp = v->mod_phase;
+    for(uint32_t i = 0; i < count; i++){
+        cp += c_inc; if(cp >= TAU) cp -= TAU;
+        mp += m_inc; if(mp >= TAU) mp -= TAU;
+    }
+    v->carrier_phase = cp;
+    v->mod_phase = mp;
+    v->pos += count;
 }
+#endif
 
 /* When NO_C_VOICES=1: Only init/trigger stubs - no C processing fallback
  * ASM implementation required for fm_voice_process */
@@ -0,0 +1,106 @@
+#include "fm_voice.h"
+#include "fast_math_x86.h"
+
+/* x86-64 port of src/asm/active/fm_voice.s.  Keeps the ARM kernel's
+ * rational envelope 1/(1 + decay·t), 5th-order Taylor sines, the ±3
+ * modulation clamp, the fixed 0.25 output scale and the ±1 safety clamp so
+ * both architectures render the same seed the same way. */
+#define FM_MOD_CLAMP 3.0f
+#define FM_OUT_SCALE 0.25f
+
+/* render = 0 advances both phases exactly as rendering would without
+ * writing any output (fm_voice_skip). */
+static inline void fm_voice_run(fm_voice_t *v, float32_t *L, float32_t *R, uint32_t n, const int render)
+{
+    if (v->pos >= v->len || n == 0) return;
+
+    uint32_t count = v->len - v->pos;
+    if (count > n) count = n;
+
+    const float32_t sr = v->sr;
+    const float32_t index0 = v->index0;
+    const float32_t amp = v->amp;
+    const float32_t decay = v->decay;
+    const float32_t *env_tab = v->env_tab;
+    const float32_t c_inc = X86_TAU * v->carrier_freq / sr;
+    const float32_t m_inc = c_inc * v->ratio;
+    float32_t cp = v->carrier_phase;
+    float32_t mp = v->mod_phase;
+    uint32_t pos = v->pos;
+    uint32_t i = 0;
+
+#if X86_SIMD_WIDTH > 1
+    enum { W = X86_SIMD_WIDTH };
+    if ((float32_t)W * c_inc < X86_TAU && (float32_t)W * m_inc < X86_TAU) {
+        const vf_t lane = vf_ramp();
+        const vf_t c_incv = VF_MUL(lane, VF_SET1(c_inc));
+        const vf_t m_incv = VF_MUL(lane, VF_SET1(m_inc));
+        const vf_t inv_sr = VF_SET1(1.0f / sr), one = VF_SET1(1.0f);
+        const vf_t decayv = VF_SET1(decay), index0v = VF_SET1(index0);
+        const vf_t gain = VF_SET1(amp * FM_OUT_SCALE);
+        const vf_t mclamp = VF_SET1(FM_MOD_CLAMP);
+        for (; i + W <= count; i += W, pos += W) {
+            if (render) {
+                vf_t env;
+                if (env_tab) {
+                    env = VF_LOAD(env_tab + pos);
+                } else {
+                    vf_t t = VF_MUL(VF_ADD(VF_SET1((float32_t)pos), lane), inv_sr);
+                    env = VF_DIV(one, VF_ADD(one, VF_MUL(decayv, t)));
+                }
+
+                vf_t mpv = vf_wrap_tau(VF_ADD(VF_SET1(mp), m_incv));
+                vf_t cpv = vf_wrap_tau(VF_ADD(VF_SET1(cp), c_incv));
+
+                vf_t mod = VF_MUL(VF_MUL(index0v, env), vf_sin_taylor5(mpv));
+                mod = VF_MAX(VF_MIN(mod, mclamp), VF_SUB(VF_SET1(0.0f), mclamp));
+                vf_t s = vf_sin_taylor5(VF_ADD(cpv, mod));
+                s = VF_MUL(VF_MUL(s, env), gain);
+                s = VF_MAX(VF_MIN(s, one), VF_SET1(-1.0f));
+
+                VF_STORE(L + i, VF_ADD(VF_LOAD(L + i), s));
+                VF_STORE(R + i, VF_ADD(VF_LOAD(R + i), s));
+            }
+
+            cp += (float32_t)W * c_inc; if (cp >= X86_TAU) cp -= X86_TAU;
+            mp += (float32_t)W * m_inc; if (mp >= X86_TAU) mp -= X86_TAU;
+        }
+    }
+#endif
+
+    for (; i < count; ++i, ++pos) {
+        if (render) {
+            float32_t env;
+            if (env_tab) {
+                env = env_tab[pos];
+            } else {
+                float32_t t = (float32_t)pos / sr;
+                env = 1.0f / (1.0f + decay * t);
+            }
+            float32_t mod = index0 * env * x86_sin_taylor5(mp);
+            if (mod > FM_MOD_CLAMP) mod = FM_MOD_CLAMP;
+            if (mod < -FM_MOD_CLAMP) mod = -FM_MOD_CLAMP;
+            float32_t s = x86_sin_taylor5(cp + mod) * env * amp * FM_OUT_SCALE;
+            if (s > 1.0f) s = 1.0f;
+            if (s < -1.0f) s = -1.0f;
+            L[i] += s;
+            R[i] += s;
+        }
+        cp += c_inc; if (cp >= X86_TAU) cp -= X86_TAU;
+        mp += m_inc; if (mp >= X86_TAU) mp -= X86_TAU;
+    }
+
+    v->carrier_phase = cp;
+    v->mod_phase = mp;
+    v->pos = pos;
+}
+
+void X86_KFN(fm_voice_process)(fm_voice_t *v, float32_t *L, float32_t *R, uint32_t n)
+{
+    fm_voice_run(v, L, R, n, 1);
+}
+
+void X86_KFN(fm_voice_skip)(fm_voice_t *v, uint32_t n)
+{
+    fm_voice_run(v, NULL, NULL, n, 0);
+}
@@ -1,46 +1,61 @@
 #include "generator.h"
 #include <string.h>
+#include <stddef.h>
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include "fm_presets.h"
 #include "euclid.h"
+#include "trace.h"
+#include "wavetable.h"
+#ifdef DSP_DISPATCH
+#include "dsp_dispatch.h"
+#endif
 
 /* Helper for RNG float */
 #define RNG_FLOAT(rng) ( (rng_next_u32(rng) >> 8) * (1.0f/16777216.0f) )
 
 volatile float g_block_rms = 0.0f;
 
+/* generator.s addresses these fields at fixed offsets */
+_Static_assert(offsetof(generator_t, event_idx) == 0xd8, "update the event_idx offset in generator.s");
+_Static_assert(offsetof(generator_t, delay) == 232, "update the delay offset in generator.s");
+_Static_assert(offsetof(generator_t, limiter) == 256, "update the limiter offset in generator.s");
+
 // C fallback for generator_build_events_asm - for debugging
-static void generator_build_events_c(event_queue_t *q, rng_t *rng, 
+// Returns 0, or -1 if the queue could not be allocated or grown.
+static int generator_build_events_c(event_queue_t *q, rng_t *rng, 
                                      const uint8_t *kick_pat, const uint8_t *snare_pat, const uint8_t *hat_pat,
                                      uint32_t step_samples)
 {
-    eq_init(q);
+    int err = eq_init(q, step_samples);
     
     for(uint32_t step = 0; step < TOTAL_STEPS; step++) {
         uint32_t t = step * step_samples;
         uint32_t bar_step = step % STEPS_PER_BAR;
         
         // Drums
-        if(kick_pat[bar_step])  eq_push(q, t, EVT_KICK, 0);
-        if(snare_pat[bar_step]) eq_push(q, t, EVT_SNARE, 0);
-        if(hat_pat[bar_step])   eq_push(q, t, EVT_HAT, 0);
+        if(kick_pat[bar_step])  err |= eq_push(q, t, EVT_KICK, 0);
+        if(snare_pat[bar_step]) err |= eq_push(q, t, EVT_SNARE, 0);
+        if(hat_pat[bar_step])   err |= eq_push(q, t, EVT_HAT, 0);
         
         // Melody at specific positions
         if(bar_step == 0 || bar_step == 8 || bar_step == 16 || bar_step == 24) {
-            eq_push(q, t, EVT_MELODY, bar_step/8);
+            err |= eq_push(q, t, EVT_MELODY, bar_step/8);
         }
         
         // Mid triggers
         if((bar_step % 4) == 2 || (((bar_step % 4) == 1 || (bar_step % 4) == 3) && RNG_FLOAT(rng) < 0.1f)) {
-            eq_push(q, t, EVT_MID, rng_next_u32(rng) % 7);
+            err |= eq_push(q, t, EVT_MID, rng_next_u32(rng) % 7);
         }
         
         // Bass at bar start
         if(bar_step == 0) {
-            eq_push(q, t, EVT_FM_BASS, 0);
+            err |= eq_push(q, t, EVT_FM_BASS, 0);
         }
     }
+    eq_build_index(q);
+    return err ? -1 : 0;
 }
 
 // C fallback for generator_rotate_pattern_asm - for debugging
@@ -57,9 +72,95 @@ static void generator_rotate_pattern_c(uint8_t *pattern, uint8_t *tmp, uint32_t
     }
 }
 
-void generator_init(generator_t *g, uint64_t seed)
+/* Fresh voices and empty pools (capacities kept).  Slot 0's noise seeds
+   are the ones the single-voice generator used; the others are offset so
+   overlapping hits do not share a noise stream. */
+static void generator_init_voices(generator_t *g)
+{
+    gen_voices_t *vs = &g->voices;
+    const float32_t sr = (float32_t)g->mt.sr;
+    for(uint32_t i = 0; i < GEN_MAX_VOICES; i++){
+        const uint64_t salt = (uint64_t)i << 32;
+        kick_init(&vs->kick[i], sr);
+        snare_init(&vs->snare[i], sr, g->seed ^ 0xABCDEF ^ salt);
+        hat_init(&vs->hat[i], sr,   g->seed ^ 0x123456 ^ salt);
+        melody_init(&vs->mel[i], sr);
+        fm_voice_init(&vs->mid_fm[i], sr);
+        fm_voice_init(&vs->bass_fm[i], sr);
+        simple_voice_init(&vs->mid_simple[i], sr);
+    }
+    fm_bank_init(&vs->mid_bank, sr);
+    fm_bank_init(&vs->bass_bank, sr);
+    for(int i = 0; i < GEN_INST_COUNT; i++)
+        voice_pool_reset(&vs->pool[i]);
+}
+
+/* Voices at the loop starts generator_seek has passed: at[l - 1] is the
+   state at frame l * period (loop 0 is generator_init_voices). */
+struct gen_seek {
+    uint32_t loops;
+    uint32_t capacity;
+    gen_voices_t *at;
+};
+
+static void generator_seek_free(generator_t *g)
+{
+    if(!g->seek) return;
+    free(g->seek->at);
+    free(g->seek);
+    g->seek = NULL;
+}
+
+/* Record the voices as the checkpoint for loop `loop` if it is the next
+   one; on allocation failure seeking carries on without it. */
+static void generator_seek_checkpoint(generator_t *g, uint32_t loop)
+{
+    struct gen_seek *s = g->seek;
+    if(!s || loop != s->loops + 1) return;
+    if(s->loops == s->capacity){
+        uint32_t cap = s->capacity ? s->capacity * 2 : 8;
+        gen_voices_t *grown = realloc(s->at, sizeof(gen_voices_t) * cap);
+        if(!grown) return;
+        s->at = grown;
+        s->capacity = cap;
+    }
+    s->at[s->loops++] = g->voices;
+}
+
+void generator_set_polyphony(generator_t *g, gen_inst_t inst, uint32_t voices, voice_steal_t steal)
+{
+    if((unsigned)inst >= GEN_INST_COUNT) return;
+    voice_pool_init(&g->voices.pool[inst], voices, steal);
+    if(g->seek) g->seek->loops = 0;  /* recorded with the old pools */
+}
+
+static void generator_init_limiter(generator_t *g)
+{
+    if(g->limiter_mode == LIMITER_TRUE_PEAK){
+        /* 2 ms lookahead, delivery ceiling of -1 dBTP */
+        limiter_init_mode(&g->limiter, LIMITER_TRUE_PEAK, (float32_t)g->mt.sr, 2.0f, 50.0f, -1.0f);
+        return;
+    }
+    /* Limiter tweak: faster attack/release and softer threshold (−0.1 dB) */
+    limiter_init(&g->limiter, (float32_t)g->mt.sr, 0.5f, 50.0f, -0.1f);
+}
+
+void generator_set_limiter(generator_t *g, limiter_mode_t mode)
 {
+    if((unsigned)mode >= LIMITER_MODE_COUNT) return;
+    g->limiter_mode = mode;
+    generator_init_limiter(g);
+}
+
+int generator_init(generator_t *g, uint64_t seed, uint32_t sr)
+{
+#ifdef DSP_DISPATCH
+    dsp_dispatch_init(); /* no-op once the kernel level has been chosen */
+#endif
     memset(g, 0, sizeof(generator_t));
+    if(sr < SR_MIN) sr = SR_MIN;
+    if(sr > SR_MAX) sr = SR_MAX;
+    g->seed = seed;
     g->rng = rng_seed(seed);
 
     /* ---- Derive per-run musical variation from seed ---- */
@@ -69,17 +170,13 @@ void generator_init(generator_t *g, uint64_t seed)
     uint8_t preset_offset = rng_next_u32(&g->rng) % 4;
     
     float bpm = 50.0f + (RNG_FLOAT(&g->rng) * 70.0f);
-    music_time_init(&g->mt, bpm);
+    music_time_init(&g->mt, bpm, sr);
     music_globals_init(&g->music, &g->rng);
 
-    /* ---- Init voices ---- */
-    kick_init(&g->kick, SR);
-    snare_init(&g->snare, SR, seed ^ 0xABCDEF);
-    hat_init(&g->hat, SR,   seed ^ 0x123456);
-    melody_init(&g->mel, SR);
-    fm_voice_init(&g->mid_fm, SR);
-    fm_voice_init(&g->bass_fm, SR);
-    simple_voice_init(&g->mid_simple, SR);
+    /* ---- Init voices: one per instrument until generator_set_polyphony ---- */
+    for(int i = 0; i < GEN_INST_COUNT; i++)
+        voice_pool_init(&g->voices.pool[i], 1, VOICE_STEAL_OLDEST);
+    generator_init_voices(g);
 
     /* ---- Build drum patterns ---- */
     uint8_t kick_pat[STEPS_PER_BAR], snare_pat[STEPS_PER_BAR], hat_pat[STEPS_PER_BAR];
@@ -98,18 +195,15 @@ void generator_init(generator_t *g, uint64_t seed)
     
     /* ---- Pre-compute event queue ---- */
     /* Phase 5.5: Use C implementation (assembly has infinite loop bug) */
-    generator_build_events_c(&g->q, &g->rng, kick_pat, snare_pat, hat_pat, g->mt.step_samples);
+    if(generator_build_events_c(&g->q, &g->rng, kick_pat, snare_pat, hat_pat, g->mt.step_samples) != 0){
+        fprintf(stderr, "generator_init: cannot allocate the event queue\n");
+        generator_free(g);
+        return -1;
+    }
     g->event_idx = 0;
     g->step = 0;
     g->pos_in_step = 0;
 
-    /* Debug: count how many EVT_MID events were scheduled */
-    uint32_t mid_evt_count = 0;
-    for(uint32_t i = 0; i < g->q.count; i++){
-        if(g->q.events[i].type == EVT_MID) mid_evt_count++;
-    }
-    printf("DEBUG: EVT_MID events scheduled = %u\n", mid_evt_count);
-    
     /* ---- Init Effects ---- */
 #ifdef DELAY_FACTOR_OVERRIDE
     float delay_factor = DELAY_FACTOR_OVERRIDE;
@@ -117,87 +211,250 @@ void generator_init(generator_t *g, uint64_t seed)
     float delay_factors[] = {2.0f,1.0f,0.5f,0.25f};
     float delay_factor = delay_factors[rng_next_u32(&g->rng)%4];
 #endif
-    uint32_t delay_samples = (uint32_t)(g->mt.beat_sec * delay_factor * SR);
-    if(delay_samples > MAX_DELAY_SAMPLES) delay_samples = MAX_DELAY_SAMPLES;
-    delay_init(&g->delay, g->delay_buf, delay_samples);
-    printf("DEBUG: After delay_init - buf=%p size=%u idx=%u\n", g->delay.buf, g->delay.size, g->delay.idx);
-    printf("DEBUG: LLDB WATCHPOINT ADDRESSES - delay struct at %p, delay.size at %p, delay.idx at %p\n", 
-           &g->delay, &g->delay.size, &g->delay.idx);
-    /* Limiter tweak: faster attack/release and softer threshold (−0.1 dB) */
-    limiter_init(&g->limiter, SR, 0.5f, 50.0f, -0.1f);
+    uint32_t delay_samples = (uint32_t)(g->mt.beat_sec * delay_factor * (float32_t)sr);
+    const uint32_t max_delay = (uint32_t)(MAX_DELAY_SEC * (float32_t)sr);
+    if(delay_samples > max_delay) delay_samples = max_delay;
+    if(delay_samples == 0) delay_samples = 1;
+    g->delay_buf = malloc(sizeof(float32_t) * delay_samples * 2);
+    if(!g->delay_buf){
+        fprintf(stderr, "generator_init: cannot allocate %u delay frames\n", delay_samples);
+        generator_free(g);
+        return -1;
+    }
+    /* Planar ring: the kernels run it without deinterleaving, same output
+       (a few percent faster than interleaved; the run split is the gain) */
+    delay_init_layout(&g->delay, g->delay_buf, delay_samples, DELAY_PLANAR);
+    generator_init_limiter(g);
+
+    /* Per-event pitch/preset draws come after every init draw, as they
+       did when they were made while rendering. */
+    generator_resolve_events(g);
+    generator_warm_envelopes(g);
+    wavetable_init();
+    return 0;
 }
 
-#ifndef GENERATOR_ASM
-void generator_process(generator_t *g, float32_t *L, float32_t *R, uint32_t num_frames)
+void generator_free(generator_t *g)
 {
-    /* clear visual event flags */
-    g->saw_hit = false;
-    g->bass_hit = false;
+    generator_par_free(g);
+    generator_bus_free(g);
+    generator_seek_free(g);
+    eq_free(&g->q);
+    free(g->delay_buf);
+    g->delay_buf = NULL;
+}
+
+void generator_schedule(const generator_t *g, uint32_t n, gen_plan_t *plan)
+{
+    const event_queue_t *q = &g->q;
+    const uint32_t ss = g->mt.step_samples;
+    const uint32_t t0 = g->step * ss + g->pos_in_step;
+    uint32_t base = 0;           /* becomes the loop length after the wrap */
+    uint32_t s = g->step;
+    uint32_t idx = g->event_idx;
+    uint32_t k = 0;
+
+    /* Usual short block: inside the current step, its events all fired */
+    if(g->pos_in_step + n <= ss && idx >= eq_step_end(q, s)){
+        plan->frames = n;
+        plan->num_splits = 0;
+        plan->next_event = idx;
+        return;
+    }
+
+    /* Walk the steps the block touches through the CSR index; only the
+       events of those steps are looked at. */
+    for(;;){
+        if(s == TOTAL_STEPS){
+            s = 0;
+            idx = 0;
+            base = TOTAL_STEPS * ss;
+        }
+        if(base + s * ss >= t0 + n) break;
+
+        uint32_t end = eq_step_end(q, s);
+        if(idx < eq_step_begin(q, s)) idx = eq_step_begin(q, s);
+        while(idx < end){
+            uint32_t t = q->events[idx].time + base;
+            if(t < t0){ idx++; continue; } /* already behind us */
+            if(t >= t0 + n) goto done;
+            if(k == GEN_MAX_SPLITS){
+                n = t - t0; /* plan is full: stop just before this split */
+                goto done;
+            }
+            uint32_t first = idx;
+            while(idx < end && q->events[idx].time + base == t) idx++;
+            plan->splits[k++] = (gen_split_t){ t - t0, first, idx - first };
+        }
+        s++;
+    }
+done:
+    plan->frames = n;
+    plan->num_splits = k;
+    plan->next_event = idx;
+}
+
+/* Move step/pos_in_step/event_idx past a plan that has been rendered. */
+void generator_advance(generator_t *g, const gen_plan_t *plan)
+{
+    g->event_idx = plan->next_event;
+    /* Short blocks mostly stay inside one step: no division needed */
+    if(g->pos_in_step + plan->frames < g->mt.step_samples){
+        g->pos_in_step += plan->frames;
+        return;
+    }
+    const uint32_t period = TOTAL_STEPS * g->mt.step_samples;
+    uint32_t t = g->step * g->mt.step_samples + g->pos_in_step + plan->frames;
+    if(t >= period) t -= period;
+    g->step = t / g->mt.step_samples;
+    g->pos_in_step = t % g->mt.step_samples;
+}
+
+/* Delay on the synth bus, drum + synth mix, limiter: the tail shared by the
+   scheduled, step-sliced and parallel renderers. */
+void generator_finish_block(generator_t *g, float32_t *L, float32_t *R, uint32_t num_frames,
+                            float32_t *Ld, float32_t *Rd, float32_t *Ls, float32_t *Rs)
+{
+    TRACE_CURSOR(g->step, g->step * g->mt.step_samples + g->pos_in_step);
+    TRACE_EMIT(TRACE_BLOCK, 0, num_frames, g->delay.size, g->delay.idx, 0);
+    delay_process_block(&g->delay, Ls, Rs, num_frames, 0.45f);
+
+    /* Phase 5.1: Use C implementation for debugging */
+    for(uint32_t i = 0; i < num_frames; i++) {
+        L[i] = Ld[i] + Ls[i];
+        R[i] = Rd[i] + Rs[i];
+    }
+
+    limiter_process(&g->limiter, L, R, num_frames);
+}
+
+/* Render the drum (Ld/Rd) and synth (Ls/Rs) buses for the next n frames,
+ * adding into them.  Triggers fire at their exact sample offsets and
+ * voices run uninterrupted between them, so a span with no events is a
+ * single run per voice. */
+void generator_render_dry(generator_t *g, float32_t *Ld, float32_t *Rd,
+                          float32_t *Ls, float32_t *Rs, uint32_t n)
+{
+    uint32_t done = 0;
+    while(done < n){
+        gen_plan_t plan;
+        generator_schedule(g, n - done, &plan);
+
+        uint32_t run_start = 0;
+        for(uint32_t s = 0; s < plan.num_splits; s++){
+            const gen_split_t *sp = &plan.splits[s];
+            if(sp->offset > run_start){
+                uint32_t at = done + run_start;
+                generator_process_voices(g, Ld + at, Rd + at, Ls + at, Rs + at, sp->offset - run_start);
+                run_start = sp->offset;
+            }
+            TRACE_CURSOR(g->q.events[sp->first].time / g->mt.step_samples, g->q.events[sp->first].time);
+            for(uint32_t e = sp->first; e < sp->first + sp->count; e++)
+                generator_fire_event(g, &g->q.events[e]);
+        }
+        if(plan.frames > run_start){
+            uint32_t at = done + run_start;
+            generator_process_voices(g, Ld + at, Rd + at, Ls + at, Rs + at, plan.frames - run_start);
+        }
 
+        generator_advance(g, &plan);
+        done += plan.frames;
+    }
+}
+
+/* Advance every live voice n samples without rendering. */
+static void generator_skip_voices(generator_t *g, uint32_t n)
+{
+    for(int i = 0; i < GEN_INST_COUNT; i++)
+        generator_skip_inst(g, (gen_inst_t)i, n);
+}
+
+/* generator_render_dry without the audio: same plan walk and triggers,
+ * voices only step their state.  Runs are cut at the same GEN_MAX_BLOCK
+ * boundaries generator_process renders in, counted from frame `origin` of
+ * a render that started at 0, so the SIMD kernels' per-run phase
+ * bookkeeping comes out identical too. */
+static void generator_fast_forward_from(generator_t *g, uint32_t origin, uint32_t n)
+{
+    uint32_t done = 0;
+    while(done < n){
+        uint32_t block = GEN_MAX_BLOCK - (origin + done) % GEN_MAX_BLOCK;
+        gen_plan_t plan;
+        generator_schedule(g, n - done < block ? n - done : block, &plan);
+
+        uint32_t run_start = 0;
+        for(uint32_t s = 0; s < plan.num_splits; s++){
+            const gen_split_t *sp = &plan.splits[s];
+            generator_skip_voices(g, sp->offset - run_start);
+            run_start = sp->offset;
+            for(uint32_t e = sp->first; e < sp->first + sp->count; e++)
+                generator_fire_event(g, &g->q.events[e]);
+        }
+        generator_skip_voices(g, plan.frames - run_start);
+
+        generator_advance(g, &plan);
+        done += plan.frames;
+    }
+}
+
+void generator_fast_forward(generator_t *g, uint32_t n)
+{
+    generator_fast_forward_from(g, 0, n);
+}
+
+#ifndef GENERATOR_ASM
+/* Render one chunk of at most GEN_MAX_BLOCK frames.  The four sub-mix
+ * buffers are carved out of the generator's scratch arena. */
+static void generator_render_block(generator_t *g, float32_t *L, float32_t *R,
+                                   uint32_t num_frames, float32_t *scratch)
+{
     /* buffers for sub-mixes */
-    float32_t Ld[num_frames], Rd[num_frames];
-    float32_t Ls[num_frames], Rs[num_frames];
-    
+    float32_t *Ld = scratch;
+    float32_t *Rd = scratch + num_frames;
+    float32_t *Ls = scratch + 2 * num_frames;
+    float32_t *Rs = scratch + 3 * num_frames;
+
     /* Phase 5.3: Use C implementation for debugging */
     memset(Ld, 0, num_frames * sizeof(float32_t));
     memset(Rd, 0, num_frames * sizeof(float32_t));
     memset(Ls, 0, num_frames * sizeof(float32_t));
     memset(Rs, 0, num_frames * sizeof(float32_t));
 
+    generator_render_dry(g, Ld, Rd, Ls, Rs, num_frames);
+    generator_finish_block(g, L, R, num_frames, Ld, Rd, Ls, Rs);
+}
+#else
+/* generator.s: same contract, x4 = scratch arena */
+void generator_render_block_asm(generator_t *g, float32_t *L, float32_t *R,
+                                uint32_t num_frames, float32_t *scratch);
+#define generator_render_block generator_render_block_asm
+#endif // GENERATOR_ASM
+
+/* Pre-scheduler render loop: fires events only when pos_in_step == 0 and
+ * slices every block at step boundaries. */
+static void generator_render_block_stepwise(generator_t *g, float32_t *L, float32_t *R,
+                                            uint32_t num_frames, float32_t *scratch)
+{
+    float32_t *Ld = scratch;
+    float32_t *Rd = scratch + num_frames;
+    float32_t *Ls = scratch + 2 * num_frames;
+    float32_t *Rs = scratch + 3 * num_frames;
+
+    memset(Ld, 0, num_frames * sizeof(float32_t));
+    memset(Rd, 0, num_frames * sizeof(float32_t));
+    memset(Ls, 0, num_frames * sizeof(float32_t));
+    memset(Rs, 0, num_frames * sizeof(float32_t));
+
     uint32_t frames_rem = num_frames;
     uint32_t current_frame = 0;
 
     while(frames_rem > 0){
         /* Trigger events at the *beginning* of each step */
         if(g->pos_in_step == 0){
-            uint32_t t_step_start = g->step * g->mt.step_samples;
-            while(g->event_idx < g->q.count && g->q.events[g->event_idx].time == t_step_start){
-                event_t *e = &g->q.events[g->event_idx];
-                switch(e->type){
-                    case EVT_KICK:  kick_trigger(&g->kick); break;
-                    case EVT_SNARE: snare_trigger(&g->snare); break;
-                    case EVT_HAT:   hat_trigger(&g->hat); break;
-                    case EVT_MELODY: {
-                        float32_t freq=g->music.root_freq;
-                        int deg;
-                        switch(e->aux){
-                            case 0: freq *= 4.0f; break;
-                            case 1: deg=g->music.scale_degrees[rng_next_u32(&g->rng)%(g->music.scale_len-1)+1]; freq *= powf(2.0f, deg/12.0f + 1.0f); break;
-                            case 2: freq *= 4.0f; break;
-                            case 3: deg=g->music.scale_degrees[rng_next_u32(&g->rng)%(g->music.scale_len-1)+1]; freq *= powf(2.0f, deg/12.0f); break;
-                        }
-                        melody_trigger(&g->mel, freq, g->mt.beat_sec);
-                        g->saw_hit = true;
-                        break; }
-                    case EVT_MID: {
-                        uint8_t idx = e->aux;
-                        int deg = g->music.scale_degrees[rng_next_u32(&g->rng)%g->music.scale_len];
-                        float32_t freq = g->music.root_freq * powf(2.0f, deg/12.0f + 1.0f);
-                        if(idx < 3){
-                            simple_wave_t w = (idx==0)?SIMPLE_TRI:(idx==1)?SIMPLE_SINE:SIMPLE_SQUARE;
-                            simple_voice_trigger(&g->mid_simple, freq, g->mt.step_sec, w, 0.2f, 6.0f);
-                        } else {
-                            fm_params_t mid_presets[4] = {FM_PRESET_BELLS, FM_PRESET_CALM, FM_PRESET_QUANTUM, FM_PRESET_PLUCK};
-                            fm_params_t p = mid_presets[(idx-3)%4];
-                            fm_voice_trigger(&g->mid_fm, freq, g->mt.step_sec + (1.0f/(float32_t)SR), p.ratio, p.index, p.amp, p.decay);
-                        }
-                        break; }
-                    case EVT_FM_BASS: {
-                        int deg = g->music.scale_degrees[rng_next_u32(&g->rng)%g->music.scale_len];
-                        float32_t freq = g->music.root_freq/4.0f * powf(2.0f, deg/12.0f);
-                        uint8_t bass_choice = rng_next_u32(&g->rng) % 3;
-                        fm_params_t p;
-                        switch(bass_choice){
-                            default: case 0: p = FM_BASS_DEFAULT; break;
-                            case 1: p = FM_BASS_QUANTUM; break;
-                            case 2: p = FM_BASS_PLUCKY;  break;
-                        }
-                        fm_voice_trigger(&g->bass_fm, freq, g->mt.beat_sec*2, p.ratio, p.index, p.amp, p.decay);
-                        g->bass_hit = true;
-                        break; }
-                }
-                g->event_idx++;
-            }
+            TRACE_CURSOR(g->step, g->step * g->mt.step_samples);
+            uint32_t end = eq_step_end(&g->q, g->step);
+            for(g->event_idx = eq_step_begin(&g->q, g->step); g->event_idx < end; g->event_idx++)
+                generator_fire_event(g, &g->q.events[g->event_idx]);
         }
 
         /* How many frames until the next step boundary? */
@@ -214,14 +471,8 @@ void generator_process(generator_t *g, float32_t *L, float32_t *R, uint32_t num_
         }
         uint32_t frames_to_process = (frames_rem < frames_to_step_boundary) ? frames_rem : frames_to_step_boundary;
 
-        /* Render voices */
-        kick_process(&g->kick,   &Ld[current_frame], &Rd[current_frame], frames_to_process);
-        snare_process(&g->snare, &Ld[current_frame], &Rd[current_frame], frames_to_process);
-        hat_process(&g->hat,     &Ld[current_frame], &Rd[current_frame], frames_to_process);
-        melody_process(&g->mel,      &Ls[current_frame], &Rs[current_frame], frames_to_process);
-        fm_voice_process(&g->mid_fm, &Ls[current_frame], &Rs[current_frame], frames_to_process);
-        fm_voice_process(&g->bass_fm,&Ls[current_frame], &Rs[current_frame], frames_to_process);
-        simple_voice_process(&g->mid_simple, &Ls[current_frame], &Rs[current_frame], frames_to_process);
+        generator_process_voices(g, &Ld[current_frame], &Rd[current_frame],
+                                 &Ls[current_frame], &Rs[current_frame], frames_to_process);
 
         /* Advance pointers / counters */
         current_frame += frames_to_process;
@@ -239,22 +490,110 @@ void generator_process(generator_t *g, float32_t *L, float32_t *R, uint32_t num_
         }
     }
 
-    printf("DEBUG: Before delay_process_block - buf=%p size=%u idx=%u n=%u\n", g->delay.buf, g->delay.size, g->delay.idx, num_frames);
-    delay_process_block(&g->delay, Ls, Rs, num_frames, 0.45f);
+    generator_finish_block(g, L, R, num_frames, Ld, Rd, Ls, Rs);
+}
 
-    /* Phase 5.1: Use C implementation for debugging */
-    for(uint32_t i = 0; i < num_frames; i++) {
-        L[i] = Ld[i] + Ls[i];
-        R[i] = Rd[i] + Rs[i];
-    }
+typedef void (*generator_block_fn)(generator_t *g, float32_t *L, float32_t *R,
+                                   uint32_t num_frames, float32_t *scratch);
 
-    limiter_process(&g->limiter, L, R, num_frames);
+static void generator_process_blocks(generator_t *g, float32_t *L, float32_t *R, uint32_t num_frames,
+                                     uint32_t max_block, generator_block_fn render_block)
+{
+    /* clear visual event flags */
+    g->saw_hit = false;
+    g->bass_hit = false;
 
-    /* Phase 5.2: Use C implementation for debugging */
+    /* Long renders are chunked so the scratch arena never has to grow;
+       every stage is streaming, so chunking does not change the output. */
+    float32_t *scratch = generator_scratch(g);
     float sum = 0.0f;
-    for(uint32_t i = 0; i < num_frames; i++) {
-        sum += L[i] * L[i] + R[i] * R[i];
+    for(uint32_t done = 0; done < num_frames; ){
+        uint32_t n = num_frames - done;
+        if(n > max_block) n = max_block;
+        render_block(g, L + done, R + done, n, scratch);
+
+        /* Phase 5.2: Use C implementation for debugging */
+        for(uint32_t i = done; i < done + n; i++) {
+            sum += L[i] * L[i] + R[i] * R[i];
+        }
+        done += n;
+    }
+    if(num_frames > 0) g_block_rms = sqrtf(sum / (num_frames * 2));
+}
+
+/* Whole call at once on the worker threads; falls back to the serial
+   renderer when the workers cannot be set up. */
+static void generator_render_span_parallel(generator_t *g, float32_t *L, float32_t *R,
+                                           uint32_t num_frames, float32_t *scratch)
+{
+    if(generator_render_parallel(g, L, R, num_frames) == 0) return;
+    for(uint32_t done = 0; done < num_frames; ){
+        uint32_t n = num_frames - done;
+        if(n > GEN_MAX_BLOCK) n = GEN_MAX_BLOCK;
+        generator_render_block(g, L + done, R + done, n, scratch);
+        done += n;
+    }
+}
+
+/* One block with its voice buses on the bus workers; blocks too short to
+   amortize the barrier render on this thread. */
+static void generator_render_block_buses(generator_t *g, float32_t *L, float32_t *R,
+                                         uint32_t num_frames, float32_t *scratch)
+{
+    if(generator_render_buses(g, L, R, num_frames, scratch) != 0)
+        generator_render_block(g, L, R, num_frames, scratch);
+}
+
+void generator_process(generator_t *g, float32_t *L, float32_t *R, uint32_t num_frames)
+{
+    if(g->threads > 1 && num_frames >= 2 * GEN_PAR_MIN_CHUNK)
+        generator_process_blocks(g, L, R, num_frames, num_frames, generator_render_span_parallel);
+    else if(g->bus)
+        generator_process_blocks(g, L, R, num_frames, GEN_MAX_BLOCK, generator_render_block_buses);
+    else
+        generator_process_blocks(g, L, R, num_frames, GEN_MAX_BLOCK, generator_render_block);
+}
+
+void generator_process_stepwise(generator_t *g, float32_t *L, float32_t *R, uint32_t num_frames)
+{
+    generator_process_blocks(g, L, R, num_frames, GEN_MAX_BLOCK, generator_render_block_stepwise);
+}
+
+void generator_seek(generator_t *g, uint32_t frame)
+{
+    const uint32_t tail = GEN_SEEK_TAIL_REPEATS * g->delay.size;
+    const uint32_t start = frame > tail ? frame - tail : 0;
+
+    /* Voices: replay every trigger before `start` from the last loop start
+       checkpointed before it, not from a fresh state: the noise RNGs and
+       the melody and simple-voice phases are not reset by a trigger, so
+       they carry over from one loop to the next. */
+    const uint32_t period = TOTAL_STEPS * g->mt.step_samples;
+    const uint32_t loop = start / period;
+    if(!g->seek) g->seek = calloc(1, sizeof(struct gen_seek));
+    uint32_t from = 0;
+    if(g->seek) from = g->seek->loops < loop ? g->seek->loops : loop;
+    if(from > 0) g->voices = g->seek->at[from - 1];
+    else generator_init_voices(g);
+    g->step = 0;
+    g->pos_in_step = 0;
+    g->event_idx = 0;
+    for(uint32_t l = from; l < loop; l++){
+        generator_fast_forward_from(g, l * period, period);
+        generator_seek_checkpoint(g, l + 1);
+    }
+    generator_fast_forward_from(g, loop * period, start - loop * period);
+
+    /* Effects: empty delay line and a fresh limiter, then render the delay
+       tail up to `frame` and throw it away. */
+    memset(g->delay.buf, 0, sizeof(float32_t) * g->delay.size * 2);
+    g->delay.idx = g->delay.size ? start % g->delay.size : 0;
+    generator_init_limiter(g);
+
+    float32_t L[1024], R[1024];
+    for(uint32_t done = start; done < frame; ){
+        uint32_t n = frame - done < 1024 ? frame - done : 1024;
+        generator_process(g, L, R, n);
+        done += n;
     }
-    g_block_rms = sqrtf(sum / (num_frames * 2));
 }
-#endif // GENERATOR_ASM 
\ No newline at end of file
@@ -0,0 +1,317 @@
+// Voice-bus parallelism for realtime blocks (generator_set_bus_threads).
+//
+// A block's voices are split into GEN_BUS_COUNT jobs - the drum bus, the
+// synth bus (melody + simple voice) and the two FM voices - that share
+// nothing but the read-only event queue.  Every job walks the same block
+// plan, running its own voices between the splits and firing only the
+// events that trigger them, into buffers of its own.  Job j runs on thread
+// j % threads; thread 0 is the callback thread, the rest are pinned
+// workers that live as long as the pool.
+//
+// Rounds are coordinated by a lock-free barrier: the callback thread
+// publishes a round by bumping `epoch` (release) and workers count
+// themselves out on `arrived` (release); the round is over once `arrived`
+// reaches (threads - 1) * epoch.  Waiters spin with a pause, then yield,
+// and idle workers finally nap so a stopped stream does not burn cores.
+//
+// The synth partials are summed in the order generator_process_voices adds
+// them (melody, mid FM, bass FM, simple), so the result is bit-identical
+// to the single-threaded renderer as long as those instruments have one
+// voice each (generator_set_polyphony); each job touches only its own
+// instruments' voice pools.  Mix, delay and limiter stay on the
+// callback thread.
+#define _GNU_SOURCE
+#include "generator.h"
+#include "trace.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define bus_relax() _mm_pause()
+#elif defined(__aarch64__)
+#define bus_relax() __asm__ __volatile__("yield")
+#else
+#define bus_relax() ((void)0)
+#endif
+
+#define BUS_SPINS   4096   /* pause-spins before yielding */
+#define BUS_YIELDS  1024   /* yields before an idle worker naps */
+#define BUS_NAP_NS  50000L
+
+enum { BUF_MID_FM, BUF_BASS_FM, BUF_SIMPLE, BUF_COUNT };
+
+typedef struct {
+    struct gen_bus *b;
+    uint32_t thread;
+} bus_worker_t;
+
+struct gen_bus {
+    uint32_t threads;                    /* including the callback thread */
+    generator_t *g;
+    pthread_t tid[GEN_BUS_COUNT - 1];
+    bus_worker_t w[GEN_BUS_COUNT - 1];
+    uint32_t started;                    /* workers running */
+
+    _Alignas(64) _Atomic uint32_t epoch;
+    _Alignas(64) _Atomic uint32_t arrived;
+    _Atomic int stop;
+
+    /* Round parameters, written by the callback thread before `epoch`. */
+    _Alignas(64) const gen_plan_t *plan;
+    uint32_t at;                         /* plan start within the block */
+    uint32_t clear;                      /* frames to zero first (0 = none) */
+    float32_t *out[GEN_BUS_COUNT][2];
+    float32_t *simple[2];
+
+    _Atomic uint64_t bus_ns[GEN_BUS_COUNT];
+    uint64_t blocks, serial_blocks, frames, wait_ns;
+
+    _Alignas(GEN_SCRATCH_ALIGN) float32_t buf[BUF_COUNT][2][GEN_MAX_BLOCK];
+};
+
+static inline uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline void bus_backoff(uint32_t *spins, int may_nap)
+{
+    if(*spins < BUS_SPINS){
+        bus_relax();
+    } else if(*spins < BUS_SPINS + BUS_YIELDS || !may_nap){
+        sched_yield();
+    } else {
+        struct timespec ts = { 0, BUS_NAP_NS };
+        nanosleep(&ts, NULL);
+        return;
+    }
+    (*spins)++;
+}
+
+/* Which job owns the voice an event triggers (see generator_fire_event) */
+static int bus_of_event(const event_t *e)
+{
+    switch(e->type){
+        case EVT_MELODY:  return GEN_BUS_SYNTH;
+        case EVT_MID:     return e->aux < 3 ? GEN_BUS_SYNTH : GEN_BUS_MID_FM;
+        case EVT_FM_BASS: return GEN_BUS_BASS_FM;
+        default:          return GEN_BUS_DRUMS;
+    }
+}
+
+static void bus_voices(struct gen_bus *b, generator_t *g, int job, uint32_t off, uint32_t n)
+{
+    float32_t *L = b->out[job][0] + off, *R = b->out[job][1] + off;
+    switch(job){
+        case GEN_BUS_DRUMS:
+            generator_render_inst(g, GEN_INST_KICK,  L, R, n);
+            generator_render_inst(g, GEN_INST_SNARE, L, R, n);
+            generator_render_inst(g, GEN_INST_HAT,   L, R, n);
+            break;
+        case GEN_BUS_SYNTH:
+            generator_render_inst(g, GEN_INST_MELODY, L, R, n);
+            generator_render_inst(g, GEN_INST_MID_SIMPLE, b->simple[0] + off, b->simple[1] + off, n);
+            break;
+        case GEN_BUS_MID_FM:
+            generator_render_inst(g, GEN_INST_MID_FM, L, R, n);
+            break;
+        case GEN_BUS_BASS_FM:
+            generator_render_inst(g, GEN_INST_BASS_FM, L, R, n);
+            break;
+    }
+}
+
+/* One job's share of the current round. */
+static void bus_job(struct gen_bus *b, int job)
+{
+    generator_t *g = b->g;
+    const gen_plan_t *plan = b->plan;
+    uint64_t t0 = now_ns();
+
+    if(b->clear){
+        memset(b->out[job][0], 0, b->clear * sizeof(float32_t));
+        memset(b->out[job][1], 0, b->clear * sizeof(float32_t));
+        if(job == GEN_BUS_SYNTH){
+            memset(b->simple[0], 0, b->clear * sizeof(float32_t));
+            memset(b->simple[1], 0, b->clear * sizeof(float32_t));
+        }
+    }
+
+    uint32_t run_start = 0;
+    for(uint32_t s = 0; s < plan->num_splits; s++){
+        const gen_split_t *sp = &plan->splits[s];
+        if(sp->offset > run_start){
+            bus_voices(b, g, job, b->at + run_start, sp->offset - run_start);
+            run_start = sp->offset;
+        }
+        TRACE_CURSOR(g->q.events[sp->first].time / g->mt.step_samples, g->q.events[sp->first].time);
+        for(uint32_t e = sp->first; e < sp->first + sp->count; e++)
+            if(bus_of_event(&g->q.events[e]) == job)
+                generator_fire_event(g, &g->q.events[e]);
+    }
+    if(plan->frames > run_start)
+        bus_voices(b, g, job, b->at + run_start, plan->frames - run_start);
+
+    atomic_fetch_add_explicit(&b->bus_ns[job], now_ns() - t0, memory_order_relaxed);
+}
+
+static void bus_run_jobs(struct gen_bus *b, uint32_t thread)
+{
+    for(int j = (int)thread; j < GEN_BUS_COUNT; j += (int)b->threads)
+        bus_job(b, j);
+}
+
+static void *bus_worker_main(void *arg)
+{
+    bus_worker_t *w = arg;
+    struct gen_bus *b = w->b;
+    uint32_t seen = 0;  /* epoch before the first round, whenever we start */
+    for(;;){
+        uint32_t spins = 0, e;
+        while((e = atomic_load_explicit(&b->epoch, memory_order_acquire)) == seen){
+            if(atomic_load_explicit(&b->stop, memory_order_relaxed)) return NULL;
+            bus_backoff(&spins, 1);
+        }
+        seen = e;
+        bus_run_jobs(b, w->thread);
+        atomic_fetch_add_explicit(&b->arrived, 1, memory_order_release);
+    }
+}
+
+static void bus_pin(pthread_t tid, uint32_t thread)
+{
+#ifdef __linux__
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if(cpus < 1) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((int)(thread % (uint32_t)cpus), &set);
+    pthread_setaffinity_np(tid, sizeof(set), &set);
+#else
+    (void)tid; (void)thread;  /* no portable affinity API */
+#endif
+}
+
+static void bus_stop(struct gen_bus *b)
+{
+    atomic_store_explicit(&b->stop, 1, memory_order_relaxed);
+    for(uint32_t i = 0; i < b->started; i++) pthread_join(b->tid[i], NULL);
+}
+
+void generator_bus_free(generator_t *g)
+{
+    if(!g->bus) return;
+    bus_stop(g->bus);
+    free(g->bus);
+    g->bus = NULL;
+}
+
+int generator_set_bus_threads(generator_t *g, uint32_t threads)
+{
+    generator_bus_free(g);
+    if(threads > GEN_BUS_COUNT) threads = GEN_BUS_COUNT;
+    /* Spinning threads sharing a core only slow each other down. */
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if(cpus > 0 && threads > (uint32_t)cpus) threads = (uint32_t)cpus;
+    if(threads < 2) return 0;
+
+    struct gen_bus *b = aligned_alloc(64, (sizeof(struct gen_bus) + 63) & ~(size_t)63);
+    if(!b) return -1;
+    memset(b, 0, sizeof(*b));
+    b->threads = threads;
+    b->g = g;
+    for(uint32_t i = 0; i < threads - 1; i++){
+        b->w[i] = (bus_worker_t){ b, i + 1 };
+        if(pthread_create(&b->tid[i], NULL, bus_worker_main, &b->w[i]) != 0){
+            bus_stop(b);
+            free(b);
+            return -1;
+        }
+        b->started++;
+        bus_pin(b->tid[i], i + 1);
+    }
+    g->bus = b;
+    return 0;
+}
+
+void generator_bus_stats(const generator_t *g, gen_bus_stats_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    const struct gen_bus *b = g->bus;
+    if(!b) return;
+    out->threads = b->threads;
+    out->blocks = b->blocks;
+    out->serial_blocks = b->serial_blocks;
+    out->frames = b->frames;
+    out->wait_ns = b->wait_ns;
+    for(int j = 0; j < GEN_BUS_COUNT; j++)
+        out->bus_ns[j] = atomic_load_explicit(&((struct gen_bus *)b)->bus_ns[j], memory_order_relaxed);
+}
+
+int generator_render_buses(generator_t *g, float32_t *L, float32_t *R, uint32_t num_frames,
+                           float32_t *scratch)
+{
+    struct gen_bus *b = g->bus;
+    if(!b) return -1;
+    if(num_frames < GEN_BUS_MIN_FRAMES){
+        b->serial_blocks++;
+        return -1;
+    }
+
+    float32_t *Ld = scratch;
+    float32_t *Rd = scratch + num_frames;
+    float32_t *Ls = scratch + 2 * num_frames;
+    float32_t *Rs = scratch + 3 * num_frames;
+    b->out[GEN_BUS_DRUMS][0] = Ld;   b->out[GEN_BUS_DRUMS][1] = Rd;
+    b->out[GEN_BUS_SYNTH][0] = Ls;   b->out[GEN_BUS_SYNTH][1] = Rs;
+    b->out[GEN_BUS_MID_FM][0] = b->buf[BUF_MID_FM][0];
+    b->out[GEN_BUS_MID_FM][1] = b->buf[BUF_MID_FM][1];
+    b->out[GEN_BUS_BASS_FM][0] = b->buf[BUF_BASS_FM][0];
+    b->out[GEN_BUS_BASS_FM][1] = b->buf[BUF_BASS_FM][1];
+    b->simple[0] = b->buf[BUF_SIMPLE][0];
+    b->simple[1] = b->buf[BUF_SIMPLE][1];
+
+    const uint32_t workers = b->threads - 1;
+    uint32_t done = 0;
+    b->clear = num_frames;
+    while(done < num_frames){
+        gen_plan_t plan;
+        generator_schedule(g, num_frames - done, &plan);
+        b->plan = &plan;
+        b->at = done;
+
+        uint32_t e = atomic_load_explicit(&b->epoch, memory_order_relaxed) + 1;
+        atomic_store_explicit(&b->epoch, e, memory_order_release);
+        bus_run_jobs(b, 0);
+
+        uint64_t t0 = now_ns();
+        uint32_t spins = 0;
+        while(atomic_load_explicit(&b->arrived, memory_order_acquire) != workers * e)
+            bus_backoff(&spins, 0);
+        b->wait_ns += now_ns() - t0;
+
+        b->clear = 0;
+        generator_advance(g, &plan);
+        done += plan.frames;
+    }
+
+    const float32_t *Fm[2] = { b->buf[BUF_MID_FM][0], b->buf[BUF_MID_FM][1] };
+    const float32_t *Fb[2] = { b->buf[BUF_BASS_FM][0], b->buf[BUF_BASS_FM][1] };
+    const float32_t *Sv[2] = { b->buf[BUF_SIMPLE][0], b->buf[BUF_SIMPLE][1] };
+    for(uint32_t i = 0; i < num_frames; i++){
+        Ls[i] = ((Ls[i] + Fm[0][i]) + Fb[0][i]) + Sv[0][i];
+        Rs[i] = ((Rs[i] + Fm[1][i]) + Fb[1][i]) + Sv[1][i];
+    }
+
+    b->blocks++;
+    b->frames += num_frames;
+    generator_finish_block(g, L, R, num_frames, Ld, Rd, Ls, Rs);
+    return 0;
+}
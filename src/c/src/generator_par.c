@@ -0,0 +1,150 @@
+// Parallel rendering of long generator_process calls.
+//
+// The dry voices are pure functions of their trigger history, so a call is
+// cut into one contiguous time chunk per thread.  Every worker starts from
+// a copy of the generator's sequencer and voice state, fast-forwards it to
+// its chunk (generator_fast_forward fires the events on the way and steps
+// only the voices' state recurrences) and renders the drum and synth buses
+// for that chunk.  The delay line and limiter carry state from sample to
+// sample, so they run over the whole call on the calling thread once the
+// workers have joined.  The last worker's state becomes the generator's,
+// which leaves it exactly where a single-threaded render would.
+//
+// The drum bus is rendered straight into the caller's L/R; only the synth
+// bus needs memory of its own, grown on demand like the event queue.
+#include "generator.h"
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Sequencer state: every generator_t field ahead of the effects; the
+   voices live further on in g->voices. */
+#define GEN_VOICE_STATE_BYTES offsetof(generator_t, delay)
+
+static void par_copy_state(generator_t *dst, const generator_t *src)
+{
+    memcpy(dst, src, GEN_VOICE_STATE_BYTES);
+    memcpy(&dst->voices, &src->voices, sizeof(src->voices));
+}
+
+typedef struct {
+    generator_t *g;
+    float32_t *Ld, *Rd, *Ls, *Rs;
+    uint32_t skip;     /* frames to fast-forward before rendering */
+    uint32_t frames;
+} par_job_t;
+
+struct gen_par {
+    uint32_t workers;        /* generator copies in w[] */
+    uint32_t capacity;       /* frames the synth bus holds */
+    float32_t *bus;          /* Ls then Rs, `capacity` frames each */
+    generator_t *w[GEN_MAX_THREADS - 1];
+};
+
+void generator_set_threads(generator_t *g, uint32_t threads)
+{
+    g->threads = threads > GEN_MAX_THREADS ? GEN_MAX_THREADS : threads;
+}
+
+void generator_par_free(generator_t *g)
+{
+    struct gen_par *p = g->par;
+    if(!p) return;
+    for(uint32_t i = 0; i < p->workers; i++) free(p->w[i]);
+    free(p->bus);
+    free(p);
+    g->par = NULL;
+}
+
+/* Make room for `threads` workers and `frames` frames of synth bus.
+   The copies are full generator_t so voice code can touch any field, but
+   only their first pages are ever written: the delay line and scratch
+   arena are never faulted in. */
+static int par_reserve(generator_t *g, uint32_t threads, uint32_t frames)
+{
+    struct gen_par *p = g->par;
+    if(!p){
+        p = calloc(1, sizeof(*p));
+        if(!p) return -1;
+        g->par = p;
+    }
+    while(p->workers < threads - 1){
+        p->w[p->workers] = malloc(sizeof(generator_t));
+        if(!p->w[p->workers]) return -1;
+        p->workers++;
+    }
+    if(p->capacity < frames){
+        float32_t *bus = realloc(p->bus, sizeof(float32_t) * 2 * (size_t)frames);
+        if(!bus) return -1;
+        p->bus = bus;
+        p->capacity = frames;
+    }
+    return 0;
+}
+
+/* Render in GEN_MAX_BLOCK runs like the serial path, so the voices'
+   run boundaries (and with them the SIMD kernels' output) match it. */
+static void *par_run(void *arg)
+{
+    par_job_t *j = arg;
+    generator_fast_forward(j->g, j->skip);
+    memset(j->Ld, 0, j->frames * sizeof(float32_t));
+    memset(j->Rd, 0, j->frames * sizeof(float32_t));
+    memset(j->Ls, 0, j->frames * sizeof(float32_t));
+    memset(j->Rs, 0, j->frames * sizeof(float32_t));
+    for(uint32_t at = 0; at < j->frames; at += GEN_MAX_BLOCK){
+        uint32_t n = j->frames - at < GEN_MAX_BLOCK ? j->frames - at : GEN_MAX_BLOCK;
+        generator_render_dry(j->g, j->Ld + at, j->Rd + at, j->Ls + at, j->Rs + at, n);
+    }
+    return NULL;
+}
+
+int generator_render_parallel(generator_t *g, float32_t *L, float32_t *R, uint32_t num_frames)
+{
+    uint32_t threads = num_frames / GEN_PAR_MIN_CHUNK;
+    if(threads > g->threads) threads = g->threads;
+    if(threads < 2 || par_reserve(g, threads, num_frames) != 0) return -1;
+
+    struct gen_par *p = g->par;
+    float32_t *Ls = p->bus, *Rs = p->bus + p->capacity;
+
+    /* Chunks are whole GEN_MAX_BLOCKs; the last one takes the remainder. */
+    uint32_t chunk = (num_frames / threads) / GEN_MAX_BLOCK * GEN_MAX_BLOCK;
+    par_job_t jobs[GEN_MAX_THREADS];
+    pthread_t tid[GEN_MAX_THREADS];
+    bool started[GEN_MAX_THREADS];
+
+    for(uint32_t i = 0; i < threads; i++){
+        uint32_t at = i * chunk;
+        jobs[i] = (par_job_t){
+            .g = i == 0 ? g : p->w[i - 1],
+            .Ld = L + at, .Rd = R + at, .Ls = Ls + at, .Rs = Rs + at,
+            .skip = at,
+            .frames = i == threads - 1 ? num_frames - at : chunk,
+        };
+        /* Copy before any worker runs: job 0 advances g itself. */
+        if(i > 0){
+            par_copy_state(p->w[i - 1], g);
+            p->w[i - 1]->saw_hit = false;
+            p->w[i - 1]->bass_hit = false;
+        }
+    }
+    for(uint32_t i = 1; i < threads; i++)
+        started[i] = pthread_create(&tid[i], NULL, par_run, &jobs[i]) == 0;
+    par_run(&jobs[0]);
+    for(uint32_t i = 1; i < threads; i++){
+        if(started[i]) pthread_join(tid[i], NULL);
+        else par_run(&jobs[i]);
+    }
+
+    generator_t *last = jobs[threads - 1].g;
+    for(uint32_t i = 1; i < threads; i++){
+        g->saw_hit |= jobs[i].g->saw_hit;
+        g->bass_hit |= jobs[i].g->bass_hit;
+    }
+    par_copy_state(g, last);
+
+    generator_finish_block(g, L, R, num_frames, L, R, Ls, Rs);
+    return 0;
+}
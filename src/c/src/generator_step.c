@@ -1,105 +1,246 @@
 #include "generator.h"
 #include "fm_presets.h"
 #include "fm_voice.h"
+#include "trace.h"
+#include "env.h"
+#ifdef DSP_DISPATCH
+#include "dsp_dispatch.h"
+#endif
 #include <math.h>
-#include <stdio.h>
 #include <string.h>
 
-#define DEBUG_MID_LOG 1
-
 /* Helper for RNG float (copied from generator.c) */
 #define RNG_FLOAT(rng) ( (rng_next_u32(rng) >> 8) * (1.0f/16777216.0f) )
 
-/* Global debug counter for mid-FM triggers */
-int g_mid_trigger_count = 0;
-
-void generator_trigger_step(generator_t *g)
+/* Draw every event's random choices up front, in queue order - the order
+   the render used to draw them in while firing, so a segment sounds the
+   same.  Loops of the segment now repeat these choices. */
+void generator_resolve_events(generator_t *g)
 {
-    /* Only act at the very start of a step */
-    if(g->pos_in_step != 0) return;
-
-    uint32_t t_step_start = g->step * g->mt.step_samples;
-
-    while(g->event_idx < g->q.count && g->q.events[g->event_idx].time == t_step_start){
-        event_t *e = &g->q.events[g->event_idx];
-        printf("TRIGGER type=%u aux=%u step=%u pos=%u\n", e->type, e->aux, g->step, g->pos_in_step);
+    for(uint32_t i = 0; i < g->q.count; i++){
+        event_t *e = &g->q.events[i];
+        int deg;
         switch(e->type){
-            case EVT_KICK:
-                kick_trigger(&g->kick);
-                break;
-            case EVT_SNARE:
-                snare_trigger(&g->snare);
-                break;
-            case EVT_HAT:
-                hat_trigger(&g->hat);
-                break;
-            case EVT_MELODY: {
-                float32_t freq = g->music.root_freq;
-                int deg;
+            case EVT_MELODY:
+                e->freq = g->music.root_freq;
                 switch(e->aux){
                     case 0:
-                        freq *= 4.0f;
+                        e->freq *= 4.0f;
                         break;
                     case 1:
                         deg = g->music.scale_degrees[rng_next_u32(&g->rng) % (g->music.scale_len - 1) + 1];
-                        freq *= powf(2.0f, deg / 12.0f + 1.0f);
+                        e->freq *= powf(2.0f, deg / 12.0f + 1.0f);
                         break;
                     case 2:
-                        freq *= 4.0f;
+                        e->freq *= 4.0f;
                         break;
                     case 3:
                         deg = g->music.scale_degrees[rng_next_u32(&g->rng) % (g->music.scale_len - 1) + 1];
-                        freq *= powf(2.0f, deg / 12.0f);
+                        e->freq *= powf(2.0f, deg / 12.0f);
                         break;
                 }
-                melody_trigger(&g->mel, freq, g->mt.beat_sec);
-                g->saw_hit = true;
-                break; }
-            case EVT_MID: {
-                /* TEMP DEBUG: Log each mid trigger */
-#ifdef DEBUG_MID_LOG
-                printf("MID TRIGGER step=%u aux=%u pos=%u\n", g->step, e->aux, g->pos_in_step);
-#endif
-                g_mid_trigger_count++; /* count how many actually fire */
-                uint8_t idx = e->aux;
-                int deg = g->music.scale_degrees[rng_next_u32(&g->rng) % g->music.scale_len];
-                float32_t freq = g->music.root_freq * powf(2.0f, deg / 12.0f + 1.0f);
-                if(idx < 3){
-                    simple_wave_t w = (idx == 0) ? SIMPLE_TRI : (idx == 1) ? SIMPLE_SINE : SIMPLE_SQUARE;
-                    simple_voice_trigger(&g->mid_simple, freq, g->mt.step_sec, w, 0.2f, 6.0f);
-                } else {
-                    fm_params_t mid_presets[4] = {FM_PRESET_BELLS, FM_PRESET_CALM, FM_PRESET_QUANTUM, FM_PRESET_PLUCK};
-                    fm_params_t p = mid_presets[(idx - 3) % 4];
-                    fm_voice_trigger(&g->mid_fm, freq, g->mt.step_sec + (1.0f/ (float32_t)SR), p.ratio, p.index, p.amp, p.decay);
-                }
-                break; }
-            case EVT_FM_BASS: {
-                int deg = g->music.scale_degrees[rng_next_u32(&g->rng) % g->music.scale_len];
-                float32_t freq = g->music.root_freq / 4.0f * powf(2.0f, deg / 12.0f);
-                uint8_t bass_choice = rng_next_u32(&g->rng) % 3;
-                fm_params_t p;
-                switch(bass_choice){
-                    default:
-                    case 0:
-                        p = FM_BASS_DEFAULT;
-                        break;
-                    case 1:
-                        p = FM_BASS_QUANTUM;
-                        break;
-                    case 2:
-                        p = FM_BASS_PLUCKY;
-                        break;
-                }
-                fm_voice_trigger(&g->bass_fm, freq, g->mt.beat_sec * 2, p.ratio, p.index, p.amp, p.decay);
-                g->bass_hit = true;
-                break; }
+                break;
+            case EVT_MID:
+                deg = g->music.scale_degrees[rng_next_u32(&g->rng) % g->music.scale_len];
+                e->freq = g->music.root_freq * powf(2.0f, deg / 12.0f + 1.0f);
+                break;
+            case EVT_FM_BASS:
+                deg = g->music.scale_degrees[rng_next_u32(&g->rng) % g->music.scale_len];
+                e->freq = g->music.root_freq / 4.0f * powf(2.0f, deg / 12.0f);
+                e->variant = rng_next_u32(&g->rng) % 3;
+                break;
+            default:
+                break;
         }
-        g->event_idx++;
     }
+}
+
+/* Rough decay of each instrument's level per frame, for quietest-voice
+   stealing; the melody's rational 1/(1+5t) envelope is taken as exp(-5t). */
+#define MELODY_LEVEL 0.07f
+#define MELODY_LEVEL_DECAY 5.0f
+
+#define MID_SIMPLE_DECAY 6.0f
 
-#ifdef DEBUG_MID_LOG
-    printf("TRIGGER_STEP END event_idx=%u step=%u pos=%u\n", g->event_idx, g->step, g->pos_in_step);
+/* Mid FM preset per EVT_MID aux 3.., bass preset per EVT_FM_BASS variant */
+static const fm_params_t *const s_mid_fm[4] = {
+    &FM_PRESET_BELLS, &FM_PRESET_CALM, &FM_PRESET_QUANTUM, &FM_PRESET_PLUCK };
+static const fm_params_t *const s_bass_fm[3] = {
+    &FM_BASS_DEFAULT, &FM_BASS_QUANTUM, &FM_BASS_PLUCKY };
+
+/* The FM pools' bank under the phasor model (lane = pool slot), or NULL
+   when inst is rendered voice by voice. */
+static fm_bank_t *generator_fm_bank(gen_voices_t *vs, gen_inst_t inst)
+{
+#ifdef DSP_DISPATCH
+    if(dsp_fm_current() == DSP_FM_PHASOR){
+        if(inst == GEN_INST_MID_FM) return &vs->mid_bank;
+        if(inst == GEN_INST_BASS_FM) return &vs->bass_bank;
+    }
+#else
+    (void)vs; (void)inst;
 #endif
+    return NULL;
+}
+
+/* Start a 2-operator FM note on a slot of an FM pool: a bank lane under
+   the phasor model, else the slot's fm_voice_t. */
+static void generator_fire_fm(gen_voices_t *vs, gen_inst_t inst, fm_voice_t *voices,
+                              const fm_params_t *fp, float32_t freq, float32_t duration_sec)
+{
+    voice_pool_t *p = &vs->pool[inst];
+    fm_bank_t *bank = generator_fm_bank(vs, inst);
+    const int slot = voice_pool_alloc(p);
+    if(bank){
+        fm_patch_t patch;
+        fm_patch_from_params(&patch, fp);
+        fm_bank_trigger_lane(bank, slot, &patch, freq, duration_sec, fp->amp);
+        TRACE_EMIT(TRACE_FM, 0, freq, duration_sec, fp->ratio, fp->index);
+        voice_pool_start(p, slot, bank->remaining[slot], fp->amp, expf(-fp->decay / bank->sr));
+    } else {
+        fm_voice_t *v = &voices[slot];
+        fm_voice_trigger(v, freq, duration_sec, fp->ratio, fp->index, fp->amp, fp->decay);
+        voice_pool_start(p, slot, v->len, v->amp, expf(-v->decay / v->sr));
+    }
+}
+
+/* Fire one queued event (pitch/preset already resolved) on a voice from
+   the instrument's pool.  Shared by the block scheduler in generator.c,
+   the step-sliced reference loop, generator_seek and
+   generator_trigger_step (called from generator.s). */
+void generator_fire_event(generator_t *g, const event_t *e)
+{
+    gen_voices_t *vs = &g->voices;
+    voice_pool_t *p;
+    int slot;
+    TRACE_EMIT(TRACE_STEP_EVENT, e->type, e->aux, e->freq, e->variant, 0);
+    switch(e->type){
+        case EVT_KICK: {
+            p = &vs->pool[GEN_INST_KICK];
+            kick_t *k = &vs->kick[slot = voice_pool_alloc(p)];
+            kick_trigger(k);
+            voice_pool_start(p, slot, k->len, 1.0f, k->env_coef);
+            break; }
+        case EVT_SNARE: {
+            p = &vs->pool[GEN_INST_SNARE];
+            snare_t *sn = &vs->snare[slot = voice_pool_alloc(p)];
+            snare_trigger(sn);
+            voice_pool_start(p, slot, sn->len, 1.0f, sn->env_coef);
+            break; }
+        case EVT_HAT: {
+            p = &vs->pool[GEN_INST_HAT];
+            hat_t *h = &vs->hat[slot = voice_pool_alloc(p)];
+            hat_trigger(h);
+            voice_pool_start(p, slot, h->len, 1.0f, h->env_coef);
+            break; }
+        case EVT_MELODY: {
+            p = &vs->pool[GEN_INST_MELODY];
+            melody_t *m = &vs->mel[slot = voice_pool_alloc(p)];
+            melody_trigger(m, e->freq, g->mt.beat_sec);
+            voice_pool_start(p, slot, m->len, MELODY_LEVEL, expf(-MELODY_LEVEL_DECAY / m->sr));
+            g->saw_hit = true;
+            break; }
+        case EVT_MID: {
+            uint8_t idx = e->aux;
+            if(idx < 3){
+                simple_wave_t w = (idx == 0) ? SIMPLE_TRI : (idx == 1) ? SIMPLE_SINE : SIMPLE_SQUARE;
+                p = &vs->pool[GEN_INST_MID_SIMPLE];
+                simple_voice_t *sv = &vs->mid_simple[slot = voice_pool_alloc(p)];
+                simple_voice_trigger(sv, e->freq, g->mt.step_sec, w, 0.2f, MID_SIMPLE_DECAY);
+                voice_pool_start(p, slot, sv->len, sv->amp, expf(-sv->decay / sv->sr));
+            } else {
+                generator_fire_fm(vs, GEN_INST_MID_FM, vs->mid_fm, s_mid_fm[(idx - 3) % 4],
+                                  e->freq, g->mt.step_sec + (1.0f/ (float32_t)g->mt.sr));
+            }
+            break; }
+        case EVT_FM_BASS: {
+            generator_fire_fm(vs, GEN_INST_BASS_FM, vs->bass_fm, s_bass_fm[e->variant < 3 ? e->variant : 0],
+                              e->freq, g->mt.beat_sec * 2);
+            g->bass_hit = true;
+            break; }
+    }
+}
+
+/* Build the envelope tables (env.h) the mid and bass triggers read, so the
+   first notes of a realtime render do not build them on the audio thread.
+   The lengths are the ones the triggers in generator_fire_event ask for. */
+void generator_warm_envelopes(const generator_t *g)
+{
+    const float32_t sr = (float32_t)g->mt.sr;
+    env_table_get(ENV_SHAPE_EXP, MID_SIMPLE_DECAY, sr, (uint32_t)(g->mt.step_sec * sr));
+    for(uint32_t i = 0; i < 4; i++)
+        env_table_get(ENV_SHAPE_RATIONAL, s_mid_fm[i]->decay, sr,
+                      (uint32_t)((g->mt.step_sec + 1.0f / sr) * sr));
+    for(uint32_t i = 0; i < 3; i++)
+        env_table_get(ENV_SHAPE_RATIONAL, s_bass_fm[i]->decay, sr,
+                      (uint32_t)(g->mt.beat_sec * 2 * sr));
+}
+
+void generator_trigger_step(generator_t *g)
+{
+    /* Only act at the very start of a step */
+    if(g->pos_in_step != 0) return;
+
+    TRACE_CURSOR(g->step, g->step * g->mt.step_samples);
+
+    uint32_t end = eq_step_end(&g->q, g->step);
+    for(g->event_idx = eq_step_begin(&g->q, g->step); g->event_idx < end; g->event_idx++){
+        generator_fire_event(g, &g->q.events[g->event_idx]);
+    }
+
+    TRACE_EMIT(TRACE_STEP_END, 0, g->event_idx, 0, 0, 0);
+}
+
+void generator_render_inst(generator_t *g, gen_inst_t inst, float32_t *L, float32_t *R, uint32_t n)
+{
+    gen_voices_t *vs = &g->voices;
+    voice_pool_t *p = &vs->pool[inst];
+    fm_bank_t *bank = generator_fm_bank(vs, inst);
+    if(bank){
+        if(p->count) fm_bank_process(bank, L, R, n);
+        voice_pool_advance(p, n);
+        return;
+    }
+    for(uint32_t i = 0; i < p->count; i++){
+        const uint8_t s = p->live[i];
+        switch(inst){
+            case GEN_INST_KICK:       kick_process(&vs->kick[s], L, R, n); break;
+            case GEN_INST_SNARE:      snare_process(&vs->snare[s], L, R, n); break;
+            case GEN_INST_HAT:        hat_process(&vs->hat[s], L, R, n); break;
+            case GEN_INST_MELODY:     melody_process(&vs->mel[s], L, R, n); break;
+            case GEN_INST_MID_FM:     fm_voice_process(&vs->mid_fm[s], L, R, n); break;
+            case GEN_INST_BASS_FM:    fm_voice_process(&vs->bass_fm[s], L, R, n); break;
+            case GEN_INST_MID_SIMPLE: simple_voice_process(&vs->mid_simple[s], L, R, n); break;
+            default: break;
+        }
+    }
+    voice_pool_advance(p, n);
+}
+
+void generator_skip_inst(generator_t *g, gen_inst_t inst, uint32_t n)
+{
+    gen_voices_t *vs = &g->voices;
+    voice_pool_t *p = &vs->pool[inst];
+    fm_bank_t *bank = generator_fm_bank(vs, inst);
+    if(bank){
+        if(p->count) fm_bank_skip(bank, n);
+        voice_pool_advance(p, n);
+        return;
+    }
+    for(uint32_t i = 0; i < p->count; i++){
+        const uint8_t s = p->live[i];
+        switch(inst){
+            case GEN_INST_KICK:       kick_skip(&vs->kick[s], n); break;
+            case GEN_INST_SNARE:      snare_skip(&vs->snare[s], n); break;
+            case GEN_INST_HAT:        hat_skip(&vs->hat[s], n); break;
+            case GEN_INST_MELODY:     melody_skip(&vs->mel[s], n); break;
+            case GEN_INST_MID_FM:     fm_voice_skip(&vs->mid_fm[s], n); break;
+            case GEN_INST_BASS_FM:    fm_voice_skip(&vs->bass_fm[s], n); break;
+            case GEN_INST_MID_SIMPLE: simple_voice_skip(&vs->mid_simple[s], n); break;
+            default: break;
+        }
+    }
+    voice_pool_advance(p, n);
 }
 
 /*------------------------------------------------------------------
@@ -109,37 +250,14 @@ void generator_trigger_step(generator_t *g)
 void generator_process_voices(generator_t *g, float32_t *Ld, float32_t *Rd,
                                float32_t *Ls, float32_t *Rs, uint32_t n)
 {
-    static int dbg_count=0;
-    /* Drums: call even when ASM versions are linked – symbol resolves to
-       _kick_process/_snare_process/_hat_process in assembly builds, or C
-       implementation otherwise. */
-    kick_process(&g->kick,   Ld, Rd, n);
-    snare_process(&g->snare, Ld, Rd, n);
-    hat_process(&g->hat,     Ld, Rd, n);
-
-#if !NO_C_VOICES
-    // C fallback path (only when NO_C_VOICES disabled)
-    #ifndef MELODY_ASM
-        melody_process(&g->mel,         Ls, Rs, n);
-    #endif
-    #ifndef FM_VOICE_ASM
-        fm_voice_process(&g->mid_fm,    Ls, Rs, n);
-    #endif
-    #ifndef FM_VOICE_ASM
-        fm_voice_process(&g->bass_fm,   Ls, Rs, n);
-    #endif
-    #ifndef SIMPLE_VOICE_ASM
-        simple_voice_process(&g->mid_simple, Ls, Rs, n);
-    #endif
-#else
-    // NO_C_VOICES: All voices must be ASM - no fallbacks allowed
-    // These calls will fail to link if ASM implementations are missing
-    melody_process(&g->mel,         Ls, Rs, n);
-    fm_voice_process(&g->mid_fm,    Ls, Rs, n);
-    fm_voice_process(&g->bass_fm,   Ls, Rs, n);
-    simple_voice_process(&g->mid_simple, Ls, Rs, n);
-#endif
-#if 0
-    /* Disabled additional debug prints */
-#endif
-} 
\ No newline at end of file
+    /* Drums: the *_process symbols resolve to the assembly voices in
+       assembly builds, or the C/dispatched kernels otherwise. */
+    generator_render_inst(g, GEN_INST_KICK,  Ld, Rd, n);
+    generator_render_inst(g, GEN_INST_SNARE, Ld, Rd, n);
+    generator_render_inst(g, GEN_INST_HAT,   Ld, Rd, n);
+
+    generator_render_inst(g, GEN_INST_MELODY,     Ls, Rs, n);
+    generator_render_inst(g, GEN_INST_MID_FM,     Ls, Rs, n);
+    generator_render_inst(g, GEN_INST_BASS_FM,    Ls, Rs, n);
+    generator_render_inst(g, GEN_INST_MID_SIMPLE, Ls, Rs, n);
+}
@@ -1,6 +1,6 @@
 #include "hat.h"
 #include <math.h>
-#include <stdio.h>
+#include "trace.h"
 
 #define HAT_DECAY_RATE 120.0f
 #define HAT_DUR_SEC 0.05f
@@ -20,9 +20,23 @@ void hat_trigger(hat_t *h)
     h->env = 1.0f;
     h->env_coef = expf(-HAT_DECAY_RATE / h->sr);
     
-    printf("*** HAT_TRIGGER: len=%u env_coef=%f ***\n", 
-           h->len, h->env_coef);
-    fflush(stdout);
+    TRACE_EMIT(TRACE_HAT, 0, h->len, h->env_coef, 0, 0);
 }
 
+#ifndef DSP_DISPATCH /* x86: level-matched kernels in src/hat_x86.c */
+/* Envelope recurrence as in the kernel; the noise stream is one draw per
+   sample, so it jumps ahead in O(1). */
+void hat_skip(hat_t *h, uint32_t n)
+{
+    if(h->pos >= h->len) return;
+    uint32_t count = h->len - h->pos;
+    if(count > n) count = n;
+    float32_t env = h->env;
+    for(uint32_t i = 0; i < count; i++) env *= h->env_coef;
+    h->env = env;
+    rng_skip(&h->rng, count);
+    h->pos += count;
+}
+#endif
+
 /* NO hat_process - ASM implementation required */
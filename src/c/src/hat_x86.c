@@ -0,0 +1,69 @@
+#include "hat.h"
+#include "fast_math_x86.h"
+
+/* x86-64 port of src/asm/active/hat.s: envelope recurrence + SplitMix64
+ * white noise, the stream hat.s draws inline.  Lanes compute it counter
+ * style (X86_NOISE), bit-identical to rng_float_mono() at every level, so a
+ * seed sounds the same on x86-64 and arm64. */
+#define HAT_AMP 0.15f
+
+/* render = 0 advances the envelope and noise stream exactly as rendering
+ * would without writing any output (hat_skip). */
+static inline void hat_run(hat_t *h, float32_t *L, float32_t *R, uint32_t n, const int render)
+{
+    if (h->pos >= h->len || n == 0) return;
+
+    uint32_t count = h->len - h->pos;
+    if (count > n) count = n;
+
+    float32_t env = h->env;
+    const float32_t coef = h->env_coef;
+    uint32_t i = 0;
+
+#if X86_SIMD_WIDTH > 1
+    enum { W = X86_SIMD_WIDTH };
+    if (count >= W) {
+        float ramp[W];
+        x86_geom_ramp(ramp, env, coef, W);
+        float32_t coef_w = 1.0f;
+        for (int j = 0; j < W; ++j) coef_w *= coef;
+
+        vf_t ev = VF_LOAD(ramp);
+        vf_t last = ev;
+        const vf_t cwv = VF_SET1(coef_w), amp = VF_SET1(HAT_AMP);
+        for (; i + W <= count; i += W) {
+            if (render) {
+                vf_t smp = VF_MUL(VF_MUL(X86_NOISE(&h->rng.state), ev), amp);
+                VF_STORE(L + i, VF_ADD(VF_LOAD(L + i), smp));
+                VF_STORE(R + i, VF_ADD(VF_LOAD(R + i), smp));
+            }
+            last = ev;
+            ev = VF_MUL(ev, cwv);
+        }
+        env = vf_last(last);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        env *= coef;
+        if (render) {
+            float32_t sample = rng_float_mono(&h->rng) * env * HAT_AMP;
+            L[i] += sample;
+            R[i] += sample;
+        }
+    }
+
+    h->env = env;
+    if (!render) rng_skip(&h->rng, count);  /* one draw per sample */
+    h->pos += count;
+}
+
+void X86_KFN(hat_process)(hat_t *h, float32_t *L, float32_t *R, uint32_t n)
+{
+    hat_run(h, L, R, n, 1);
+}
+
+void X86_KFN(hat_skip)(hat_t *h, uint32_t n)
+{
+    hat_run(h, NULL, NULL, n, 0);
+}
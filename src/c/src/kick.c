@@ -1,10 +1,10 @@
 #include "kick.h"
 #include <math.h>
 #include <assert.h>
-#include <stdio.h>
+#include "trace.h"
 
 #define KICK_BASE_FREQ 70.0f
-#define TAU (2.0f * M_PI)
+#define TAU 6.28318530717958647692f
 
 void kick_init(kick_t *k, float32_t sr)
 {
@@ -32,9 +32,30 @@ void kick_trigger(kick_t *k)
     k->y_prev  = 0.0f;            /* sin(0) */
     k->y_prev2 = -sinf(delta);    /* y[-1] = -sin(Δ) */
     
-    printf("*** KICK_TRIGGER: len=%u env_coef=%f y_prev2=%f k1=%f ***\n", 
-           k->len, k->env_coef, k->y_prev2, k->k1);
-    fflush(stdout);
+    TRACE_EMIT(TRACE_KICK, 0, k->len, k->env_coef, k->y_prev2, k->k1);
 }
 
+#ifndef DSP_DISPATCH /* x86: level-matched kernels in src/kick_x86.c */
+/* Run the envelope and sine recurrences n samples without producing
+   output.  Same float steps as the scalar kernel, so rendering continues
+   exactly where a straight render would be. */
+void kick_skip(kick_t *k, uint32_t n)
+{
+    if(k->pos >= k->len) return;
+    uint32_t count = k->len - k->pos;
+    if(count > n) count = n;
+    float32_t env = k->env, y1 = k->y_prev, y2 = k->y_prev2;
+    for(uint32_t i = 0; i < count; i++){
+        env *= k->env_coef;
+        float32_t y = k->k1 * y1 - y2;
+        y2 = y1;
+        y1 = y;
+    }
+    k->env = env;
+    k->y_prev = y1;
+    k->y_prev2 = y2;
+    k->pos += count;
+}
+#endif
+
 /* NO kick_process - ASM implementation required */
@@ -0,0 +1,96 @@
+#include "kick.h"
+#include "fast_math_x86.h"
+
+/* x86-64 port of src/asm/active/kick.s (same AMP, no early stop). */
+#define KICK_AMP 1.2f
+
+/* render = 0 advances the envelope and recurrence exactly as rendering
+ * would without writing any output (kick_skip). */
+static inline void kick_run(kick_t *k, float32_t *L, float32_t *R, uint32_t n, const int render)
+{
+    if (k->pos >= k->len || n == 0) return;
+
+    uint32_t count = k->len - k->pos;
+    if (count > n) count = n;
+
+    float32_t env = k->env;
+    const float32_t coef = k->env_coef;
+    const float32_t k1 = k->k1;
+    float32_t y1 = k->y_prev;   /* y[n-1] */
+    float32_t y2 = k->y_prev2;  /* y[n-2] */
+    uint32_t i = 0;
+
+#if X86_SIMD_WIDTH > 1
+    enum { W = X86_SIMD_WIDTH };
+    if (count >= 2 * W) {
+        /* Stride-W form of the sine recurrence:
+         *   y[m+W] = 2cos(WΔ)·y[m] − y[m−W]
+         * with 2cos(2Δ) = k1²−2 applied log2(W) times. */
+        float32_t kw = k1;
+        for (int s = 1; s < W; s <<= 1) kw = kw * kw - 2.0f;
+
+        float hist[2 * W];
+        /* backward recurrence for y[n-W .. n-3] */
+        hist[W - 1] = y1;
+        hist[W - 2] = y2;
+        for (int j = W - 3; j >= 0; --j) hist[j] = k1 * hist[j + 1] - hist[j + 2];
+        /* forward recurrence for y[n .. n+W-1] */
+        for (int j = W; j < 2 * W; ++j) hist[j] = k1 * hist[j - 1] - hist[j - 2];
+
+        float ramp[W];
+        x86_geom_ramp(ramp, env, coef, W);
+        float32_t coef_w = 1.0f;
+        for (int j = 0; j < W; ++j) coef_w *= coef;
+
+        vf_t prev = VF_LOAD(hist);
+        vf_t cur  = VF_LOAD(hist + W);
+        vf_t ev   = VF_LOAD(ramp);
+        vf_t last = ev;
+        const vf_t kwv = VF_SET1(kw), cwv = VF_SET1(coef_w), amp = VF_SET1(KICK_AMP);
+
+        for (; i + W <= count; i += W) {
+            if (render) {
+                vf_t s = VF_MUL(VF_MUL(ev, cur), amp);
+                VF_STORE(L + i, VF_ADD(VF_LOAD(L + i), s));
+                VF_STORE(R + i, VF_ADD(VF_LOAD(R + i), s));
+            }
+            vf_t next = VF_SUB(VF_MUL(kwv, cur), prev);
+            prev = cur;
+            cur  = next;
+            last = ev;
+            ev   = VF_MUL(ev, cwv);
+        }
+        /* `prev` holds the last W rendered samples */
+        y1  = vf_last(prev);
+        y2  = vf_lane(prev, W - 2);
+        env = vf_last(last);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        env *= coef;
+        float32_t y = k1 * y1 - y2;
+        if (render) {
+            float32_t sample = env * y * KICK_AMP;
+            L[i] += sample;
+            R[i] += sample;
+        }
+        y2 = y1;
+        y1 = y;
+    }
+
+    k->env = env;
+    k->y_prev = y1;
+    k->y_prev2 = y2;
+    k->pos += count;
+}
+
+void X86_KFN(kick_process)(kick_t *k, float32_t *L, float32_t *R, uint32_t n)
+{
+    kick_run(k, L, R, n, 1);
+}
+
+void X86_KFN(kick_skip)(kick_t *k, uint32_t n)
+{
+    kick_run(k, NULL, NULL, n, 0);
+}
@@ -2,6 +2,10 @@
 
 void limiter_process(limiter_t *l, float32_t *L, float32_t *R, uint32_t n)
 {
+    if(l->mode == LIMITER_TRUE_PEAK){
+        limiter_tp_process(l, L, R, n);
+        return;
+    }
     float32_t env = l->envelope;
     float32_t att = l->attack_coeff;
     float32_t rel = l->release_coeff;
@@ -0,0 +1,109 @@
+#include "limiter.h"
+#include <string.h>
+
+void limiter_init_mode(limiter_t *l, limiter_mode_t mode, float32_t sr, float32_t attack_ms,
+                       float32_t release_ms, float32_t threshold_db)
+{
+    limiter_init(l, sr, attack_ms, release_ms, threshold_db);
+    if(mode != LIMITER_TRUE_PEAK) return;
+
+    /* Without the 4x bank (out of memory) stay on the soft knee */
+    uint32_t taps;
+    const float32_t *coef = resampler_bank(1, LIMITER_TP_PHASES, &taps);
+    if(!coef || taps != LIMITER_TP_TAPS) return;
+    l->mode = LIMITER_TRUE_PEAK;
+
+    limiter_tp_t *tp = &l->tp;
+    memset(tp, 0, sizeof(*tp));
+    tp->coef = coef;
+    tp->ceiling = l->threshold * powf(10.0f, -LIMITER_TP_MARGIN_DB / 20.0f);
+    uint32_t w = (uint32_t)(attack_ms * sr / 1000.0f + 0.5f);
+    if(w < LIMITER_TP_MIN_LOOKAHEAD) w = LIMITER_TP_MIN_LOOKAHEAD;
+    if(w > LIMITER_TP_MAX_LOOKAHEAD) w = LIMITER_TP_MAX_LOOKAHEAD;
+    tp->window = w;
+    tp->delay = w + LIMITER_TP_AHEAD - 1;
+    tp->release = l->release_coeff;
+    tp->gain = 1.0f;
+    /* Silence before the first frame: no reduction held */
+    for(uint32_t i = 0; i < w; i++) tp->hold[i] = 1.0f;
+    tp->box = (double)w;
+}
+
+void limiter_tp_gains(limiter_tp_t *tp, const float32_t *req, float32_t *gain, uint32_t m)
+{
+    const uint32_t mask = LIMITER_TP_MAX_LOOKAHEAD - 1;
+    const uint32_t w = tp->window;
+    const double inv_w = 1.0 / (double)w;
+    const float32_t rel = tp->release;
+    uint32_t head = tp->dq_head, count = tp->dq_count, frame = tp->frame, hp = tp->hold_pos;
+    float32_t g = tp->gain;
+    double box = tp->box;
+
+    for(uint32_t k = 0; k < m; k++, frame++){
+        /* Sliding minimum of req over the last w frames */
+        const float32_t r = req[k];
+        if(count && frame - tp->dq_idx[head] >= w){ head = (head + 1) & mask; count--; }
+        while(count && tp->dq_val[(head + count - 1) & mask] >= r) count--;
+        tp->dq_val[(head + count) & mask] = r;
+        tp->dq_idx[(head + count) & mask] = frame;
+        count++;
+        const float32_t h = tp->dq_val[head];
+
+        /* Each held minimum covers the w frames up to its own, so their
+           average over the last w never exceeds the gain of the frame now
+           leaving the delay line */
+        box += (double)h - (double)tp->hold[hp];
+        tp->hold[hp] = h;
+        if(++hp == w) hp = 0;
+        const float32_t target = (float32_t)(box * inv_w);
+        g = target < g ? target : target + rel * (g - target);
+        gain[k] = g;
+    }
+    tp->dq_head = head;
+    tp->dq_count = count;
+    tp->frame = frame;
+    tp->hold_pos = hp;
+    tp->gain = g;
+    tp->box = box;
+}
+
+#ifndef DSP_DISPATCH /* x86: SIMD kernels in src/limiter_tp_x86.c */
+void limiter_tp_process(limiter_t *l, float32_t *L, float32_t *R, uint32_t n)
+{
+    limiter_tp_t *tp = &l->tp;
+    const uint32_t d = tp->delay;
+    const float32_t ceiling = tp->ceiling;
+    float32_t req[LIMITER_TP_CHUNK], gain[LIMITER_TP_CHUNK];
+    float32_t *ll = tp->line[0], *lr = tp->line[1];
+
+    for(uint32_t base = 0; base < n; base += LIMITER_TP_CHUNK){
+        const uint32_t m = n - base < LIMITER_TP_CHUNK ? n - base : LIMITER_TP_CHUNK;
+        memcpy(ll + d, L + base, sizeof(float32_t) * m);
+        memcpy(lr + d, R + base, sizeof(float32_t) * m);
+
+        /* Frame k of the chunk completes the taps of frame d + k - AHEAD */
+        for(uint32_t k = 0; k < m; k++){
+            const float32_t *xl = ll + d + k - LIMITER_TP_AHEAD, *xr = lr + d + k - LIMITER_TP_AHEAD;
+            float32_t peak = fmaxf(fabsf(xl[0]), fabsf(xr[0]));
+            for(int p = 0; p < LIMITER_TP_PHASES; p++){
+                const float32_t *c = tp->coef + p * LIMITER_TP_TAPS;
+                float32_t yl = 0.0f, yr = 0.0f;
+                for(int j = 0; j < LIMITER_TP_TAPS; j++){
+                    yl += c[j] * xl[j - (LIMITER_TP_AHEAD - 1)];
+                    yr += c[j] * xr[j - (LIMITER_TP_AHEAD - 1)];
+                }
+                peak = fmaxf(peak, fmaxf(fabsf(yl), fabsf(yr)));
+            }
+            req[k] = fminf(1.0f, ceiling / fmaxf(peak, 1e-30f));
+        }
+        limiter_tp_gains(tp, req, gain, m);
+
+        for(uint32_t k = 0; k < m; k++){
+            L[base + k] = ll[k] * gain[k];
+            R[base + k] = lr[k] * gain[k];
+        }
+        memmove(ll, ll + m, sizeof(float32_t) * d);
+        memmove(lr, lr + m, sizeof(float32_t) * d);
+    }
+}
+#endif
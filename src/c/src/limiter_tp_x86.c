@@ -0,0 +1,79 @@
+#include "limiter.h"
+#include <string.h>
+#include "fast_math_x86.h"
+
+/* x86-64 limiter_tp_process (same contract as limiter_tp.c).  The true-peak
+ * estimate runs across frames a vector at a time: lane j of each tap load
+ * is frame k + j's tap, so the interpolators are plain multiply-adds with
+ * broadcast coefficients.  The required gain and the final multiply are
+ * vectorised the same way; limiter_tp_gains is the only serial pass. */
+
+static inline float32_t limiter_tp_peak(const float32_t *coef, const float32_t *xl, const float32_t *xr)
+{
+    float32_t peak = fmaxf(fabsf(xl[0]), fabsf(xr[0]));
+    for (int p = 0; p < LIMITER_TP_PHASES; p++) {
+        const float32_t *c = coef + p * LIMITER_TP_TAPS;
+        float32_t yl = 0.0f, yr = 0.0f;
+        for (int j = 0; j < LIMITER_TP_TAPS; j++) {
+            yl += c[j] * xl[j - (LIMITER_TP_AHEAD - 1)];
+            yr += c[j] * xr[j - (LIMITER_TP_AHEAD - 1)];
+        }
+        peak = fmaxf(peak, fmaxf(fabsf(yl), fabsf(yr)));
+    }
+    return peak;
+}
+
+void X86_KFN(limiter_tp_process)(limiter_t *l, float32_t *L, float32_t *R, uint32_t n)
+{
+    limiter_tp_t *tp = &l->tp;
+    const uint32_t d = tp->delay;
+    const float32_t ceiling = tp->ceiling;
+    float32_t req[LIMITER_TP_CHUNK], gain[LIMITER_TP_CHUNK];
+    float32_t *ll = tp->line[0], *lr = tp->line[1];
+
+    for (uint32_t base = 0; base < n; base += LIMITER_TP_CHUNK) {
+        const uint32_t m = n - base < LIMITER_TP_CHUNK ? n - base : LIMITER_TP_CHUNK;
+        memcpy(ll + d, L + base, sizeof(float32_t) * m);
+        memcpy(lr + d, R + base, sizeof(float32_t) * m);
+        const float32_t *el = ll + d - LIMITER_TP_AHEAD, *er = lr + d - LIMITER_TP_AHEAD;
+
+        uint32_t k = 0;
+#if X86_SIMD_WIDTH > 1
+        const vf_t one = VF_SET1(1.0f), ceil_v = VF_SET1(ceiling), tiny = VF_SET1(1e-30f);
+        for (; k + X86_SIMD_WIDTH <= m; k += X86_SIMD_WIDTH) {
+            const float32_t *xl = el + k, *xr = er + k;
+            vf_t peak = VF_MAX(vf_abs(VF_LOAD(xl)), vf_abs(VF_LOAD(xr)));
+            for (int p = 0; p < LIMITER_TP_PHASES; p++) {
+                const float32_t *cp = tp->coef + p * LIMITER_TP_TAPS;
+                vf_t yl = VF_SET1(0.0f), yr = yl;
+                for (int j = 0; j < LIMITER_TP_TAPS; j++) {
+                    const vf_t c = VF_SET1(cp[j]);
+                    yl = VF_ADD(yl, VF_MUL(c, VF_LOAD(xl + j - (LIMITER_TP_AHEAD - 1))));
+                    yr = VF_ADD(yr, VF_MUL(c, VF_LOAD(xr + j - (LIMITER_TP_AHEAD - 1))));
+                }
+                peak = VF_MAX(peak, VF_MAX(vf_abs(yl), vf_abs(yr)));
+            }
+            VF_STORE(req + k, VF_MIN(one, VF_DIV(ceil_v, VF_MAX(peak, tiny))));
+        }
+#endif
+        for (; k < m; k++)
+            req[k] = fminf(1.0f, ceiling / fmaxf(limiter_tp_peak(tp->coef, el + k, er + k), 1e-30f));
+
+        limiter_tp_gains(tp, req, gain, m);
+
+        k = 0;
+#if X86_SIMD_WIDTH > 1
+        for (; k + X86_SIMD_WIDTH <= m; k += X86_SIMD_WIDTH) {
+            const vf_t g = VF_LOAD(gain + k);
+            VF_STORE(L + base + k, VF_MUL(VF_LOAD(ll + k), g));
+            VF_STORE(R + base + k, VF_MUL(VF_LOAD(lr + k), g));
+        }
+#endif
+        for (; k < m; k++) {
+            L[base + k] = ll[k] * gain[k];
+            R[base + k] = lr[k] * gain[k];
+        }
+        memmove(ll, ll + m, sizeof(float32_t) * d);
+        memmove(lr, lr + m, sizeof(float32_t) * d);
+    }
+}
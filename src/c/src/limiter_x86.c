@@ -0,0 +1,133 @@
+#include "limiter.h"
+#include <stdbool.h>
+#include "fast_math_x86.h"
+
+/* x86-64 port of src/asm/active/limiter.s (soft-knee gain computer on top of
+ * the attack/release envelope follower).
+ *
+ * The follower itself is a serial recurrence, so each block is handled in
+ * three passes over a small chunk: vector peak detection, the scalar
+ * envelope, then gain.  Below the knee the ARM kernel's log10f/powf pair
+ * always yields a gain of exactly 1, so those samples skip the transcendental
+ * math entirely and whole chunks below the knee are left untouched.
+ *
+ * The vector levels compute the gain without libm.  Above the knee the gain
+ * is thresh / env (10^(-over_db/20) with over_db = 20·log10(env/thresh)).
+ * Inside it env/thresh lies within 10^(±knee/40), so ln(env/thresh) comes
+ * from the atanh series and 10^(-reduction_db/20) from a short exp series
+ * (relative error < 1e-7 for the 5 dB knee).  The scalar level keeps the
+ * libm calls as the baseline. */
+#define LIMITER_CHUNK 64
+
+#if X86_SIMD_WIDTH > 1
+/* ln(x) for x near 1: 2·atanh(s), s = (x-1)/(x+1), through s^9 */
+static inline vf_t limiter_ln_near1(vf_t x)
+{
+    const vf_t one = VF_SET1(1.0f);
+    const vf_t s = VF_DIV(VF_SUB(x, one), VF_ADD(x, one));
+    const vf_t s2 = VF_MUL(s, s);
+    vf_t y = VF_SET1(1.0f / 9.0f);
+    y = VF_ADD(VF_MUL(y, s2), VF_SET1(1.0f / 7.0f));
+    y = VF_ADD(VF_MUL(y, s2), VF_SET1(1.0f / 5.0f));
+    y = VF_ADD(VF_MUL(y, s2), VF_SET1(1.0f / 3.0f));
+    y = VF_ADD(VF_MUL(y, s2), one);
+    return VF_MUL(VF_MUL(y, s), VF_SET1(2.0f));
+}
+
+/* exp(t) for small |t|: (degree-6 Taylor of exp(t/4))^4 */
+static inline vf_t limiter_exp_small(vf_t t)
+{
+    const vf_t q = VF_MUL(t, VF_SET1(0.25f));
+    vf_t y = VF_SET1(1.0f / 720.0f);
+    y = VF_ADD(VF_MUL(y, q), VF_SET1(1.0f / 120.0f));
+    y = VF_ADD(VF_MUL(y, q), VF_SET1(1.0f / 24.0f));
+    y = VF_ADD(VF_MUL(y, q), VF_SET1(1.0f / 6.0f));
+    y = VF_ADD(VF_MUL(y, q), VF_SET1(0.5f));
+    y = VF_ADD(VF_MUL(y, q), VF_SET1(1.0f));
+    y = VF_ADD(VF_MUL(y, q), VF_SET1(1.0f));
+    y = VF_MUL(y, y);
+    return VF_MUL(y, y);
+}
+#endif
+
+static inline float32_t limiter_gain(float32_t env, float32_t thresh, float32_t knee)
+{
+    float32_t over_db = 20.0f * log10f(env / thresh);
+    float32_t reduction_db;
+    if (over_db >= 0.5f * knee) {
+        reduction_db = over_db;
+    } else {
+        float32_t d = over_db + 0.5f * knee;
+        reduction_db = d * d / (2.0f * knee);
+    }
+    return powf(10.0f, -reduction_db / 20.0f);
+}
+
+void X86_KFN(limiter_process)(limiter_t *l, float32_t *L, float32_t *R, uint32_t n)
+{
+    float32_t env = l->envelope;
+    const float32_t att = l->attack_coeff;
+    const float32_t rel = l->release_coeff;
+    const float32_t thresh = l->threshold;
+    const float32_t knee = l->knee_width;
+    /* envelope level at which over_db reaches the lower knee edge */
+    const float32_t knee_floor = thresh * powf(10.0f, -knee / 40.0f);
+#if X86_SIMD_WIDTH > 1
+    /* ... and the upper one, past which the gain is thresh / env */
+    const vf_t v_floor = VF_SET1(knee_floor), v_ceil = VF_SET1(thresh * powf(10.0f, knee / 40.0f));
+    const vf_t v_thresh = VF_SET1(thresh), v_inv_thresh = VF_SET1(1.0f / thresh), one = VF_SET1(1.0f);
+    const vf_t v_db = VF_SET1(20.0f / 2.302585093f), v_half_knee = VF_SET1(0.5f * knee);
+    const vf_t v_knee_scale = VF_SET1(-2.302585093f / (20.0f * 2.0f * knee));
+#endif
+
+    float32_t peak[LIMITER_CHUNK];
+    float32_t envs[LIMITER_CHUNK];
+
+    for (uint32_t base = 0; base < n; base += LIMITER_CHUNK) {
+        uint32_t m = n - base;
+        if (m > LIMITER_CHUNK) m = LIMITER_CHUNK;
+        float32_t *cl = L + base;
+        float32_t *cr = R + base;
+
+        uint32_t i = 0;
+#if X86_SIMD_WIDTH > 1
+        for (; i + X86_SIMD_WIDTH <= m; i += X86_SIMD_WIDTH)
+            VF_STORE(peak + i, VF_MAX(vf_abs(VF_LOAD(cl + i)), vf_abs(VF_LOAD(cr + i))));
+#endif
+        for (; i < m; ++i)
+            peak[i] = fmaxf(fabsf(cl[i]), fabsf(cr[i]));
+
+        bool over = false;
+        for (i = 0; i < m; ++i) {
+            float32_t p = peak[i];
+            env = p + ((p > env) ? att : rel) * (env - p);
+            envs[i] = env;
+            over |= env > knee_floor;
+        }
+        if (!over) continue;
+
+        i = 0;
+#if X86_SIMD_WIDTH > 1
+        for (; i + X86_SIMD_WIDTH <= m; i += X86_SIMD_WIDTH) {
+            const vf_t e = VF_LOAD(envs + i);
+            const vf_t in_use = VF_GT(e, v_floor);
+            if (!VF_MASK(in_use)) continue;
+            const vf_t d = VF_ADD(VF_MUL(v_db, limiter_ln_near1(VF_MUL(e, v_inv_thresh))), v_half_knee);
+            const vf_t knee_gain = limiter_exp_small(VF_MUL(VF_MUL(d, d), v_knee_scale));
+            vf_t gain = vf_select(VF_GE(e, v_ceil), VF_DIV(v_thresh, e), knee_gain);
+            gain = vf_select(in_use, VF_MIN(gain, one), one);
+            VF_STORE(cl + i, VF_MUL(VF_LOAD(cl + i), gain));
+            VF_STORE(cr + i, VF_MUL(VF_LOAD(cr + i), gain));
+        }
+#endif
+        for (; i < m; ++i) {
+            if (envs[i] <= knee_floor) continue;
+            float32_t gain = limiter_gain(envs[i], thresh, knee);
+            if (gain < 1.0f) {
+                cl[i] *= gain;
+                cr[i] *= gain;
+            }
+        }
+    }
+    l->envelope = env;
+}
@@ -1,3 +1,16 @@
+// Realtime player: the generator through an audio backend (coreaudio.h)
+// with the visualiser in an SDL window.
+//
+// Usage: realtime [SEED] [--audio=coreaudio|sdl|null] [--buffer=FRAMES]
+//                 [--seconds=N] [--sink=out.wav] [--unpaced]
+//
+// --seconds=N runs headless: no window, N seconds of audio, then the
+// backend's callback timing (null backend only).  With the null backend
+// (also NDB_AUDIO=null) that makes a CI check of realtime headroom:
+//    bin/realtime 0x1234 --audio=null --seconds=30
+// --sink writes the null backend's output to a float WAV; --unpaced runs
+// its clock as fast as the callback allows.
+#define _DEFAULT_SOURCE  /* M_PI and nanosleep under -std=c11 on glibc */
 #include "coreaudio.h"
 #include "generator.h"
 #include "video.h"
@@ -7,15 +20,20 @@
 #include "shapes.h"
 #include "crt_fx.h"
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h> // for sleep
+#include <time.h>
 #include <stdlib.h> // for strtoull
 #include <stdbool.h>
 #include <math.h>
 
 static generator_t g_generator;
 
+#define AUDIO_BUFFER 512
+
 void audio_render_callback(float* buffer, uint32_t num_frames, void* user_data)
 {
+    (void)user_data;
     float L[num_frames], R[num_frames];
     generator_process(&g_generator, L, R, num_frames);
     for(uint32_t i=0; i<num_frames; ++i){
@@ -27,11 +45,38 @@ void audio_render_callback(float* buffer, uint32_t num_frames, void* user_data)
 int main(int argc, char **argv)
 {
     uint64_t seed = 0xCAFEBABEULL;
-    if(argc > 1) {
-        seed = strtoull(argv[1], NULL, 0);
+    uint32_t buffer = AUDIO_BUFFER;
+    double seconds = 0.0;
+    const char *sink = NULL;
+    int paced = 1;
+    for(int i = 1; i < argc; ++i){
+        if(strncmp(argv[i], "--audio=", 8) == 0){
+            if(audio_select(audio_backend_from_name(argv[i] + 8)) != 0){
+                fprintf(stderr, "Audio backend %s not available in this build\n", argv[i] + 8);
+                return 1;
+            }
+        } else if(strncmp(argv[i], "--buffer=", 9) == 0){
+            buffer = (uint32_t)strtoul(argv[i] + 9, NULL, 0);
+        } else if(strncmp(argv[i], "--seconds=", 10) == 0){
+            seconds = atof(argv[i] + 10);
+        } else if(strncmp(argv[i], "--sink=", 7) == 0){
+            sink = argv[i] + 7;
+        } else if(strcmp(argv[i], "--unpaced") == 0){
+            paced = 0;
+        } else if(argv[i][0] != '-'){
+            seed = strtoull(argv[i], NULL, 0);
+        } else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if(buffer == 0){
+        fprintf(stderr, "--buffer must be at least one frame\n");
+        return 1;
     }
+    if(sink || !paced) audio_null_configure(sink, paced);
 
-    generator_init(&g_generator, seed);
+    if(generator_init(&g_generator, seed, SR_DEFAULT) != 0) return 1;
     terrain_init(seed);
     particles_init();
     shapes_init();
@@ -40,11 +85,31 @@ int main(int argc, char **argv)
     crt_fx_t crt_fx;
     crt_fx_init(&crt_fx, seed, 800, 600);
 
-    if(audio_init(SR, 512, audio_render_callback, NULL) != 0){
-        fprintf(stderr, "Audio init failed\n");
+    if(audio_init(SR_DEFAULT, buffer, audio_render_callback, NULL) != 0){
+        fprintf(stderr, "Audio init failed (%s)\n", audio_backend_name(audio_backend()));
         return 1;
     }
 
+    if(seconds > 0.0){
+        printf("Playing seed 0x%llx through %s for %.1f s without video\n",
+               (unsigned long long)seed, audio_backend_name(audio_backend()), seconds);
+        audio_start();
+        struct timespec ts = { (time_t)seconds, (long)((seconds - (time_t)seconds) * 1e9) };
+        while(nanosleep(&ts, &ts) != 0) {}
+        audio_stop();
+        crt_fx_cleanup(&crt_fx);
+        audio_stats_t st;
+        if(audio_get_stats(&st) == 0){
+            printf("%llu callbacks of %u frames (%.0f us), %llu deadline misses\n",
+                   (unsigned long long)st.callbacks, buffer, st.period_us, (unsigned long long)st.misses);
+            printf("jitter mean %.1f us, max %.1f us; callback mean %.1f us, max %.1f us (%.0f%% of the period)\n",
+                   st.jitter_mean_us, st.jitter_max_us, st.callback_mean_us, st.callback_max_us,
+                   100.0 * st.callback_max_us / st.period_us);
+            return st.misses ? 2 : 0;
+        }
+        return 0;
+    }
+
     printf("Playing with seed 0x%llx. Close the window to quit.\n", (unsigned long long)seed);
 
     /* show CRT effect levels */
@@ -149,8 +214,9 @@ int main(int argc, char **argv)
         frame++;
     }
 
+    /* audio first: video_shutdown quits SDL, which the sdl backend runs on */
+    audio_stop();
     video_shutdown();
     crt_fx_cleanup(&crt_fx);
-    audio_stop();
     return 0;
 } 
\ No newline at end of file
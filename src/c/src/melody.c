@@ -1,8 +1,9 @@
 #include "melody.h"
 #include <math.h>
-#include <stdio.h>
+#include "trace.h"
 
 #define MELODY_MAX_SEC 2.0f
+#define TAU 6.28318530717958647692f
 
 void melody_init(melody_t *m, float32_t sr)
 {
@@ -20,7 +21,25 @@ void melody_trigger(melody_t *m, float32_t freq, float32_t dur_sec)
     if(m->len > (uint32_t)(MELODY_MAX_SEC * m->sr))
         m->len = (uint32_t)(MELODY_MAX_SEC * m->sr);
     m->pos = 0;
-    printf("*** MELODY_TRIGGER: freq=%.2f dur=%.2f len=%u ***\n", freq, dur_sec, m->len);
+    TRACE_EMIT(TRACE_MELODY, 0, freq, dur_sec, m->len, 0);
 }
 
+#ifndef DSP_DISPATCH /* x86: level-matched kernels in src/melody_x86.c */
+/* The envelope is a function of pos; only the phase carries over. */
+void melody_skip(melody_t *m, uint32_t n)
+{
+    if(m->pos >= m->len) return;
+    uint32_t count = m->len - m->pos;
+    if(count > n) count = n;
+    const float32_t inc = TAU * m->freq / m->sr;
+    float32_t phase = m->osc.phase;
+    for(uint32_t i = 0; i < count; i++){
+        phase += inc;
+        if(phase >= TAU) phase -= TAU;
+    }
+    m->osc.phase = phase;
+    m->pos += count;
+}
+#endif
+
 /* NO melody_process - ASM implementation required */ 
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "melody.h"
+#include "fast_math_x86.h"
+
+/* x86-64 port of src/asm/active/melody.s: driven, soft-clipped saw with the
+ * rational decay env = 1/(1 + 5t) used by the ARM kernel. */
+#define MELODY_DECAY_RATE 5.0f
+#define MELODY_AMP 0.07f
+
+static inline float32_t melody_shape(float32_t phase)
+{
+    float32_t raw = 2.0f * (phase / X86_TAU) - 1.0f;
+    float32_t driven = 1.2f * raw;
+    return 1.5f * driven - 0.5f * driven * driven * driven;
+}
+
+/* render = 0 advances the phase exactly as rendering would without
+ * writing any output (melody_skip). */
+static inline void melody_run(melody_t *m, float32_t *L, float32_t *R, uint32_t n, const int render)
+{
+    if (m->pos >= m->len || n == 0) return;
+
+    uint32_t count = m->len - m->pos;
+    if (count > n) count = n;
+
+    const float32_t sr = m->sr;
+    const float32_t inc = X86_TAU * m->freq / sr;
+    float32_t phase = m->osc.phase;
+    uint32_t pos = m->pos;
+    uint32_t i = 0;
+
+#if X86_SIMD_WIDTH > 1
+    enum { W = X86_SIMD_WIDTH };
+    /* lane phases need at most one wrap per vector */
+    if ((float32_t)W * inc < X86_TAU) {
+        const vf_t lane = vf_ramp();
+        const vf_t incv = VF_MUL(lane, VF_SET1(inc));
+        const vf_t inv_sr = VF_SET1(1.0f / sr), one = VF_SET1(1.0f);
+        const vf_t decay = VF_SET1(MELODY_DECAY_RATE);
+        for (; i + W <= count; i += W, pos += W) {
+            if (render) {
+                vf_t ph = vf_wrap_tau(VF_ADD(VF_SET1(phase), incv));
+                vf_t t = VF_MUL(VF_ADD(VF_SET1((float32_t)pos), lane), inv_sr);
+                vf_t env = VF_DIV(one, VF_ADD(one, VF_MUL(decay, t)));
+
+                vf_t raw = VF_SUB(VF_MUL(VF_MUL(ph, VF_SET1(1.0f / X86_TAU)), VF_SET1(2.0f)), one);
+                vf_t d = VF_MUL(raw, VF_SET1(1.2f));
+                vf_t soft = VF_SUB(VF_MUL(d, VF_SET1(1.5f)),
+                                   VF_MUL(VF_MUL(VF_MUL(d, d), d), VF_SET1(0.5f)));
+                vf_t s = VF_MUL(VF_MUL(soft, env), VF_SET1(MELODY_AMP));
+
+                VF_STORE(L + i, VF_ADD(VF_LOAD(L + i), s));
+                VF_STORE(R + i, VF_ADD(VF_LOAD(R + i), s));
+            }
+
+            phase += (float32_t)W * inc;
+            if (phase >= X86_TAU) phase -= X86_TAU;
+        }
+    }
+#endif
+
+    for (; i < count; ++i, ++pos) {
+        if (render) {
+            float32_t t = (float32_t)pos / sr;
+            float32_t env = 1.0f / (1.0f + MELODY_DECAY_RATE * t);
+            float32_t sample = melody_shape(phase) * env * MELODY_AMP;
+            L[i] += sample;
+            R[i] += sample;
+        }
+        phase += inc;
+        if (phase >= X86_TAU) phase -= X86_TAU;
+    }
+
+    m->osc.phase = phase;
+    m->pos = pos;
+}
+
+void X86_KFN(melody_process)(melody_t *m, float32_t *L, float32_t *R, uint32_t n)
+{
+    melody_run(m, L, R, n, 1);
+}
+
+void X86_KFN(melody_skip)(melody_t *m, uint32_t n)
+{
+    melody_run(m, NULL, NULL, n, 0);
+}
@@ -0,0 +1,15 @@
+#include "noise.h"
+#include "fast_math_x86.h"
+
+/* x86-64 noise_block: the counter-based SplitMix64 lanes of fast_math_x86.h,
+ * bit-identical to the serial rng_float_mono() stream in noise.c. */
+void X86_KFN(noise_block)(rng_t *rng, float *out, uint32_t n)
+{
+    uint32_t i = 0;
+#if X86_SIMD_WIDTH > 1
+    for (; i + X86_SIMD_WIDTH <= n; i += X86_SIMD_WIDTH)
+        VF_STORE(out + i, X86_NOISE(&rng->state));
+#endif
+    for (; i < n; ++i)
+        out[i] = rng_float_mono(rng);
+}
@@ -1,5 +1,6 @@
 #include "osc.h"
 #include <math.h>
+#include "wavetable.h"
 
 #define TAU 6.28318530717958647692f
 
@@ -18,42 +19,28 @@ void osc_sine_block(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float3
 #endif
 
 #ifndef OSC_SHAPES_ASM
+/* Saw, square and triangle read the band-limited wavetables; the phase is
+   carried as Q32 turns for the block. */
+static void osc_table_block(osc_t *o, wt_shape_t shape, float32_t *out, uint32_t n, float32_t freq, float32_t sr)
+{
+    const uint32_t inc = wavetable_inc(freq, sr);
+    uint32_t ph = wavetable_phase_from_rad(o->phase);
+    wavetable_block_ref(wavetable_for(shape, inc), &ph, inc, out, n);
+    o->phase = wavetable_phase_to_rad(ph);
+}
+
 void osc_saw_block(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float32_t sr)
 {
-    const float32_t phase_inc = TAU * freq / sr;
-    float32_t ph = o->phase;
-    for (uint32_t i = 0; i < n; ++i) {
-        float32_t frac = ph / TAU; // 0..1
-        out[i] = 2.0f * frac - 1.0f; // -1..1
-        ph += phase_inc;
-        if (ph >= TAU) ph -= TAU;
-    }
-    o->phase = ph;
+    osc_table_block(o, WT_SAW, out, n, freq, sr);
 }
 
 void osc_square_block(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float32_t sr)
 {
-    const float32_t phase_inc = TAU * freq / sr;
-    float32_t ph = o->phase;
-    for (uint32_t i = 0; i < n; ++i) {
-        out[i] = (ph < TAU * 0.5f) ? 1.0f : -1.0f;
-        ph += phase_inc;
-        if (ph >= TAU) ph -= TAU;
-    }
-    o->phase = ph;
+    osc_table_block(o, WT_SQUARE, out, n, freq, sr);
 }
 
 void osc_triangle_block(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float32_t sr)
 {
-    const float32_t phase_inc = TAU * freq / sr;
-    float32_t ph = o->phase;
-    for (uint32_t i = 0; i < n; ++i) {
-        float32_t frac = ph / TAU; // 0..1
-        float32_t val = 2.0f * fabsf(2.0f * frac - 1.0f) - 1.0f; // triangle -1..1
-        out[i] = val;
-        ph += phase_inc;
-        if (ph >= TAU) ph -= TAU;
-    }
-    o->phase = ph;
+    osc_table_block(o, WT_TRIANGLE, out, n, freq, sr);
 }
-#endif 
\ No newline at end of file
+#endif
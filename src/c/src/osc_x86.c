@@ -0,0 +1,74 @@
+#include "osc.h"
+#include <math.h>
+#include "fast_math_x86.h"
+#include "wavetable.h"
+
+/* x86-64 oscillator blocks (same contracts as osc.c).  Each vector lane of
+ * the sine starts at phase + j·inc, so a block is only vectorised while
+ * W·inc stays below TAU and every lane needs at most one wrap. */
+
+#if X86_SIMD_WIDTH > 1
+enum { W = X86_SIMD_WIDTH };
+#define OSC_VEC_OK(inc) ((float32_t)W * (inc) < X86_TAU)
+
+static inline vf_t osc_lane_phase(float32_t ph, vf_t incv)
+{
+    return vf_wrap_tau(VF_ADD(VF_SET1(ph), incv));
+}
+
+static inline float32_t osc_advance(float32_t ph, float32_t inc_w)
+{
+    ph += inc_w;
+    if (ph >= X86_TAU) ph -= X86_TAU;
+    return ph;
+}
+#endif
+
+void X86_KFN(osc_sine_block)(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float32_t sr)
+{
+    const float32_t inc = X86_TAU * freq / sr;
+    float32_t ph = o->phase;
+    uint32_t i = 0;
+#if X86_SIMD_WIDTH > 1
+    if (OSC_VEC_OK(inc)) {
+        const vf_t incv = VF_MUL(vf_ramp(), VF_SET1(inc));
+        for (; i + W <= n; i += W) {
+            VF_STORE(out + i, vf_sin_phase(osc_lane_phase(ph, incv)));
+            ph = osc_advance(ph, (float32_t)W * inc);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = sinf(ph);
+        ph += inc;
+        if (ph >= X86_TAU) ph -= X86_TAU;
+    }
+    o->phase = ph;
+}
+
+/* Saw, square and triangle read the band-limited wavetables through this
+ * level's wavetable kernel; the phase is carried as Q32 turns. */
+void X86_KFN(wavetable_block)(const float32_t *tab, uint32_t *phase, uint32_t inc, float32_t *out, uint32_t n);
+
+static void osc_table_block(osc_t *o, wt_shape_t shape, float32_t *out, uint32_t n, float32_t freq, float32_t sr)
+{
+    const uint32_t inc = wavetable_inc(freq, sr);
+    uint32_t ph = wavetable_phase_from_rad(o->phase);
+    X86_KFN(wavetable_block)(wavetable_for(shape, inc), &ph, inc, out, n);
+    o->phase = wavetable_phase_to_rad(ph);
+}
+
+void X86_KFN(osc_saw_block)(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float32_t sr)
+{
+    osc_table_block(o, WT_SAW, out, n, freq, sr);
+}
+
+void X86_KFN(osc_square_block)(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float32_t sr)
+{
+    osc_table_block(o, WT_SQUARE, out, n, freq, sr);
+}
+
+void X86_KFN(osc_triangle_block)(osc_t *o, float32_t *out, uint32_t n, float32_t freq, float32_t sr)
+{
+    osc_table_block(o, WT_TRIANGLE, out, n, freq, sr);
+}
@@ -1,3 +1,4 @@
+#define _DEFAULT_SOURCE  /* M_PI under -std=c11 on glibc */
 #include "particles.h"
 #include "raster.h"
 #include <stdlib.h>
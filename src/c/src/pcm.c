@@ -0,0 +1,82 @@
+#include "pcm.h"
+#include <math.h>
+#include <string.h>
+
+static const char *s_pcm_names[PCM_FORMAT_COUNT] = { "s16", "s24", "f32" };
+
+const char *pcm_format_name(pcm_format_t f)
+{
+    return (unsigned)f < PCM_FORMAT_COUNT ? s_pcm_names[f] : "?";
+}
+
+pcm_format_t pcm_format_from_name(const char *name)
+{
+    for(int f = 0; f < PCM_FORMAT_COUNT; f++)
+        if(strcmp(name, s_pcm_names[f]) == 0) return (pcm_format_t)f;
+    return PCM_FORMAT_COUNT;
+}
+
+void pcm_conv_init(pcm_conv_t *c, pcm_format_t format, int dither, uint64_t seed)
+{
+    c->format = format;
+    c->dither = dither && format != PCM_F32;
+    c->state = rng_seed(seed).state;
+    c->pos = 0;
+}
+
+/* Draw k of the dither stream */
+static inline float pcm_draw(uint64_t state, uint64_t k)
+{
+    rng_t r = { state };
+    rng_skip(&r, k);
+    return rng_wide_float_mono(&r);
+}
+
+/* Saturate and round (to nearest even, like cvtps2dq) a scaled sample */
+static inline int32_t pcm_quantize(float v, float lo, float hi)
+{
+    v = v < lo ? lo : v;
+    return (int32_t)lrintf(v > hi ? hi : v);
+}
+
+void pcm_convert_frames(const pcm_conv_t *c, uint64_t pos, const float *L, const float *R, uint32_t n,
+                        void *out)
+{
+    if(c->format == PCM_F32){
+        float *o = out;
+        for(uint32_t i = 0; i < n; i++){
+            o[2*i]   = L[i];
+            o[2*i+1] = R[i];
+        }
+        return;
+    }
+    const float scale = c->format == PCM_S16 ? 32767.0f : 8388607.0f;
+    const float lo = -scale - 1.0f, hi = scale;
+    uint8_t *o = out;
+    for(uint32_t i = 0; i < n; i++){
+        float vl = L[i] * scale, vr = R[i] * scale;
+        if(c->dither){
+            const uint64_t f = pos + i;
+            const uint64_t k = (f / PCM_DITHER_GROUP) * 4 * PCM_DITHER_GROUP + f % PCM_DITHER_GROUP;
+            vl += 0.5f * (pcm_draw(c->state, k) + pcm_draw(c->state, k + PCM_DITHER_GROUP));
+            vr += 0.5f * (pcm_draw(c->state, k + 2 * PCM_DITHER_GROUP) + pcm_draw(c->state, k + 3 * PCM_DITHER_GROUP));
+        }
+        const int32_t ql = pcm_quantize(vl, lo, hi), qr = pcm_quantize(vr, lo, hi);
+        if(c->format == PCM_S16){
+            const int16_t s[2] = { (int16_t)ql, (int16_t)qr };
+            memcpy(o + 4*i, s, 4);
+        } else {
+            uint8_t *p = o + 6*i;
+            p[0] = (uint8_t)ql; p[1] = (uint8_t)(ql >> 8); p[2] = (uint8_t)(ql >> 16);
+            p[3] = (uint8_t)qr; p[4] = (uint8_t)(qr >> 8); p[5] = (uint8_t)(qr >> 16);
+        }
+    }
+}
+
+#ifndef DSP_DISPATCH /* x86: SIMD kernels in src/pcm_x86.c */
+void pcm_convert(pcm_conv_t *c, const float *L, const float *R, uint32_t n, void *out)
+{
+    pcm_convert_frames(c, c->pos, L, R, n, out);
+    c->pos += n;
+}
+#endif
@@ -0,0 +1,167 @@
+#include "pcm.h"
+#include <string.h>
+#include "fast_math_x86.h"
+
+/* x86-64 pcm_convert (same contract and output as pcm.c).  X86_SIMD_WIDTH
+ * frames a step: scale, dither, clamp and round in float lanes, then
+ * interleave L/R in registers and store once.  Unpacking the two channels'
+ * int32 lanes gives two frames per 128-bit lane; s16 packs those with
+ * saturation, s24 shuffles each lane's two frames down to 6 bytes.  The dither
+ * is pcm.c's draws: lane j of an X86_NOISE_WIDE call started at draw k is
+ * draw k + j.  Heads up to a vector boundary of c->pos and tails go through
+ * pcm_convert_frames, which makes every level bit-identical. */
+
+#if X86_SIMD_WIDTH > 1
+
+#if X86_SIMD_WIDTH == 4
+typedef __m128i pcm_vi_t;
+#define PCM_CVT(x)         _mm_cvtps_epi32(x)
+#define PCM_UNPACKLO(a, b) _mm_unpacklo_epi32((a), (b))
+#define PCM_UNPACKHI(a, b) _mm_unpackhi_epi32((a), (b))
+#elif X86_SIMD_WIDTH == 8
+typedef __m256i pcm_vi_t;
+#define PCM_CVT(x)         _mm256_cvtps_epi32(x)
+#define PCM_UNPACKLO(a, b) _mm256_unpacklo_epi32((a), (b))
+#define PCM_UNPACKHI(a, b) _mm256_unpackhi_epi32((a), (b))
+#else
+typedef __m512i pcm_vi_t;
+#define PCM_CVT(x)         _mm512_cvtps_epi32(x)
+#define PCM_UNPACKLO(a, b) _mm512_unpacklo_epi32((a), (b))
+#define PCM_UNPACKHI(a, b) _mm512_unpackhi_epi32((a), (b))
+
+/* Unpacked frame pairs (lo: pairs 0,2,4,6, hi: 1,3,5,7, one per 128-bit
+   lane) into frames 0-7 and 8-15 */
+static inline void pcm_zip512(__m512i lo, __m512i hi, __m512i *x0, __m512i *x1)
+{
+    const __m512i a = _mm512_shuffle_i32x4(lo, hi, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m512i b = _mm512_shuffle_i32x4(lo, hi, _MM_SHUFFLE(3, 2, 3, 2));
+    *x0 = _mm512_shuffle_i32x4(a, a, _MM_SHUFFLE(3, 1, 2, 0));
+    *x1 = _mm512_shuffle_i32x4(b, b, _MM_SHUFFLE(3, 1, 2, 0));
+}
+#endif
+
+/* Interleaved int16 of unpacked frame pairs, saturating */
+static inline void pcm_store_s16(uint8_t *p, pcm_vi_t a, pcm_vi_t b)
+{
+#if X86_SIMD_WIDTH == 4
+    _mm_storeu_si128((__m128i *)p, _mm_packs_epi32(a, b));
+#elif X86_SIMD_WIDTH == 8
+    /* The in-lane pack puts each lane's pairs of a then b: frame order */
+    _mm256_storeu_si256((__m256i *)p, _mm256_packs_epi32(a, b));
+#else
+    /* 512-bit packs needs AVX512BW: order the lanes, then narrow */
+    __m512i x0, x1;
+    pcm_zip512(a, b, &x0, &x1);
+    _mm256_storeu_si256((__m256i *)p, _mm512_cvtsepi32_epi16(x0));
+    _mm256_storeu_si256((__m256i *)(p + 32), _mm512_cvtsepi32_epi16(x1));
+#endif
+}
+
+/* 4 int32 -> their low 3 bytes, packed into the first 12 bytes */
+static inline __m128i pcm_pack24(__m128i v)
+{
+    const __m128i m = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    return _mm_shuffle_epi8(v, m);
+}
+
+static inline void pcm_store24(uint8_t *p, __m128i v)
+{
+    const int32_t hi = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+    _mm_storel_epi64((__m128i *)p, v);
+    memcpy(p + 8, &hi, 4);
+}
+
+/* Interleaved 24-bit of unpacked frame pairs: 128-bit lane k of a holds
+   frames 4k, 4k+1, of b frames 4k+2, 4k+3 */
+static inline void pcm_store_s24(uint8_t *p, pcm_vi_t a, pcm_vi_t b)
+{
+#if X86_SIMD_WIDTH == 4
+    pcm_store24(p, pcm_pack24(a));
+    pcm_store24(p + 12, pcm_pack24(b));
+#elif X86_SIMD_WIDTH == 8
+    pcm_store24(p,      pcm_pack24(_mm256_castsi256_si128(a)));
+    pcm_store24(p + 12, pcm_pack24(_mm256_castsi256_si128(b)));
+    pcm_store24(p + 24, pcm_pack24(_mm256_extracti128_si256(a, 1)));
+    pcm_store24(p + 36, pcm_pack24(_mm256_extracti128_si256(b, 1)));
+#else
+    pcm_store24(p,      pcm_pack24(_mm512_castsi512_si128(a)));
+    pcm_store24(p + 12, pcm_pack24(_mm512_castsi512_si128(b)));
+    pcm_store24(p + 24, pcm_pack24(_mm512_extracti32x4_epi32(a, 1)));
+    pcm_store24(p + 36, pcm_pack24(_mm512_extracti32x4_epi32(b, 1)));
+    pcm_store24(p + 48, pcm_pack24(_mm512_extracti32x4_epi32(a, 2)));
+    pcm_store24(p + 60, pcm_pack24(_mm512_extracti32x4_epi32(b, 2)));
+    pcm_store24(p + 72, pcm_pack24(_mm512_extracti32x4_epi32(a, 3)));
+    pcm_store24(p + 84, pcm_pack24(_mm512_extracti32x4_epi32(b, 3)));
+#endif
+}
+
+/* Interleaved float */
+static inline void pcm_store_f32(float *o, vf_t l, vf_t r)
+{
+#if X86_SIMD_WIDTH == 4
+    _mm_storeu_ps(o, _mm_unpacklo_ps(l, r));
+    _mm_storeu_ps(o + 4, _mm_unpackhi_ps(l, r));
+#elif X86_SIMD_WIDTH == 8
+    const __m256 lo = _mm256_unpacklo_ps(l, r), hi = _mm256_unpackhi_ps(l, r);
+    _mm256_storeu_ps(o, _mm256_permute2f128_ps(lo, hi, 0x20));
+    _mm256_storeu_ps(o + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+#else
+    __m512i x0, x1;
+    pcm_zip512(_mm512_castps_si512(_mm512_unpacklo_ps(l, r)), _mm512_castps_si512(_mm512_unpackhi_ps(l, r)),
+               &x0, &x1);
+    _mm512_storeu_si512((void *)o, x0);
+    _mm512_storeu_si512((void *)(o + 16), x1);
+#endif
+}
+
+/* TPDF dither for W frames starting at draw k: half the sum of two draws */
+static inline vf_t pcm_tpdf(uint64_t state, uint64_t k)
+{
+    uint64_t s1 = state + k * SM64_GAMMA;
+    uint64_t s2 = state + (k + PCM_DITHER_GROUP) * SM64_GAMMA;
+    const vf_t a = X86_NOISE_WIDE(&s1), b = X86_NOISE_WIDE(&s2);
+    return VF_MUL(VF_SET1(0.5f), VF_ADD(a, b));
+}
+
+#endif /* X86_SIMD_WIDTH > 1 */
+
+void X86_KFN(pcm_convert)(pcm_conv_t *c, const float *L, const float *R, uint32_t n, void *out)
+{
+#if X86_SIMD_WIDTH > 1
+    const uint32_t bytes = 2 * pcm_sample_bytes(c->format);
+    uint8_t *o = out;
+    /* Vectors start on a multiple of the width in absolute frames, so none
+       straddles a dither group */
+    uint32_t head = (uint32_t)(-c->pos & (X86_SIMD_WIDTH - 1));
+    if(head > n) head = n;
+    pcm_convert_frames(c, c->pos, L, R, head, o);
+    uint32_t i = head;
+
+    if(c->format == PCM_F32){
+        for(; i + X86_SIMD_WIDTH <= n; i += X86_SIMD_WIDTH)
+            pcm_store_f32((float *)(o + (size_t)i * bytes), VF_LOAD(L + i), VF_LOAD(R + i));
+    } else {
+        const float scale = c->format == PCM_S16 ? 32767.0f : 8388607.0f;
+        const vf_t sv = VF_SET1(scale), lo = VF_SET1(-scale - 1.0f), hi = VF_SET1(scale);
+        for(; i + X86_SIMD_WIDTH <= n; i += X86_SIMD_WIDTH){
+            vf_t vl = VF_MUL(VF_LOAD(L + i), sv), vr = VF_MUL(VF_LOAD(R + i), sv);
+            if(c->dither){
+                const uint64_t f = c->pos + i;
+                const uint64_t k = (f / PCM_DITHER_GROUP) * 4 * PCM_DITHER_GROUP + f % PCM_DITHER_GROUP;
+                vl = VF_ADD(vl, pcm_tpdf(c->state, k));
+                vr = VF_ADD(vr, pcm_tpdf(c->state, k + 2 * PCM_DITHER_GROUP));
+            }
+            const pcm_vi_t ql = PCM_CVT(VF_MIN(VF_MAX(vl, lo), hi));
+            const pcm_vi_t qr = PCM_CVT(VF_MIN(VF_MAX(vr, lo), hi));
+            const pcm_vi_t a = PCM_UNPACKLO(ql, qr), b = PCM_UNPACKHI(ql, qr);
+            uint8_t *p = o + (size_t)i * bytes;
+            if(c->format == PCM_S16) pcm_store_s16(p, a, b);
+            else pcm_store_s24(p, a, b);
+        }
+    }
+    pcm_convert_frames(c, c->pos + i, L + i, R + i, n - i, o + (size_t)i * bytes);
+#else
+    pcm_convert_frames(c, c->pos, L, R, n, out);
+#endif
+    c->pos += n;
+}
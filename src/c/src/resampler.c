@@ -0,0 +1,221 @@
+#include "resampler.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RS_PI 3.14159265358979323846
+
+typedef struct {
+    uint32_t up, down, taps;
+    float32_t *bank;
+} rs_bank_t;
+
+static rs_bank_t s_bank[RS_BANK_SLOTS];
+static uint32_t s_banks;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t rs_gcd(uint32_t a, uint32_t b)
+{
+    while(b){ uint32_t t = a % b; a = b; b = t; }
+    return a;
+}
+
+/* Zeroth-order modified Bessel function (Kaiser window) */
+static double rs_bessel_i0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for(int k = 1; k < 64 && term > sum * 1e-17; k++){
+        const double h = x / (2.0 * k);
+        term *= h * h;
+        sum += term;
+    }
+    return sum;
+}
+
+/* Prototype tap m of up·taps sits at input time (m - up·taps/2) / up; each
+   branch is normalised to unit DC gain so the output has no ripple at the
+   ratio's period. */
+static void rs_design(float32_t *bank, uint32_t up, uint32_t down, uint32_t taps)
+{
+    const double rho = up < down ? (double)up / down : 1.0;   /* lower Nyquist / input Nyquist */
+    const double width = (RS_STOP_DB - 7.95) / (14.36 * taps);  /* transition, cycles per input frame */
+    const double fc = 0.5 * rho - 0.5 * width;
+    const double beta = 0.1102 * (RS_STOP_DB - 8.7);
+    const double half = 0.5 * taps;
+    const double i0_beta = rs_bessel_i0(beta);
+    double h[RS_MAX_TAPS];
+    for(uint32_t ph = 0; ph < up; ph++){
+        double sum = 0.0;
+        for(uint32_t j = 0; j < taps; j++){
+            const double t = ((double)ph + (double)j * up) / up - half;  /* input frames from centre */
+            const double x = t / half;
+            const double w = x * x < 1.0 ? rs_bessel_i0(beta * sqrt(1.0 - x * x)) / i0_beta : 0.0;
+            const double a = 2.0 * RS_PI * fc * t;
+            h[j] = 2.0 * fc * (t == 0.0 ? 1.0 : sin(a) / a) * w;
+            sum += h[j];
+        }
+        /* Tap j multiplies the frame j before the window's newest */
+        for(uint32_t j = 0; j < taps; j++)
+            bank[(size_t)ph * taps + (taps - 1 - j)] = (float32_t)(h[j] / sum);
+    }
+}
+
+static const float32_t *rs_bank_get(uint32_t up, uint32_t down, uint32_t taps)
+{
+    const float32_t *bank = NULL;
+    pthread_mutex_lock(&s_lock);
+    for(uint32_t i = 0; i < s_banks && !bank; i++)
+        if(s_bank[i].up == up && s_bank[i].down == down && s_bank[i].taps == taps)
+            bank = s_bank[i].bank;
+    if(!bank && s_banks < RS_BANK_SLOTS){
+        float32_t *b = aligned_alloc(64, (size_t)up * taps * sizeof(float32_t));
+        if(b){
+            rs_design(b, up, down, taps);
+            s_bank[s_banks++] = (rs_bank_t){ up, down, taps, b };
+            bank = b;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return bank;
+}
+
+/* Reduced ratio and kernel length for in_rate -> out_rate; -1 if refused */
+static int rs_shape(uint32_t in_rate, uint32_t out_rate, uint32_t *up, uint32_t *down, uint32_t *taps)
+{
+    if(in_rate == 0 || out_rate == 0) return -1;
+    const uint32_t g = rs_gcd(in_rate, out_rate);
+    *up = out_rate / g;
+    *down = in_rate / g;
+    if(*up > RS_MAX_PHASES || *down > (uint64_t)*up * RS_MAX_DOWN) return -1;
+
+    /* Decimating narrows the band in input frames, so the kernel widens
+       by the same factor to keep the transition as sharp at the output */
+    *taps = RS_TAPS;
+    if(*down > *up){
+        *taps = (uint32_t)(((uint64_t)RS_TAPS * *down + *up - 1) / *up);
+        *taps = (*taps + 15) & ~15u;
+    }
+    return 0;
+}
+
+const float32_t *resampler_bank(uint32_t in_rate, uint32_t out_rate, uint32_t *taps)
+{
+    uint32_t up, down;
+    if(rs_shape(in_rate, out_rate, &up, &down, taps) != 0) return NULL;
+    return rs_bank_get(up, down, *taps);
+}
+
+int resampler_init(resampler_t *r, uint32_t in_rate, uint32_t out_rate)
+{
+    memset(r, 0, sizeof(*r));
+    uint32_t up, down, taps;
+    if(rs_shape(in_rate, out_rate, &up, &down, &taps) != 0) return -1;
+
+    r->bank = rs_bank_get(up, down, taps);
+    r->buf[0] = malloc(sizeof(float32_t) * (taps + RS_CHUNK));
+    r->buf[1] = malloc(sizeof(float32_t) * (taps + RS_CHUNK));
+    if(!r->bank || !r->buf[0] || !r->buf[1]){
+        resampler_free(r);
+        return -1;
+    }
+    r->in_rate = in_rate;
+    r->out_rate = out_rate;
+    r->up = up;
+    r->down = down;
+    r->taps = taps;
+    r->step = down / up;
+    r->frac = down % up;
+    r->cap = taps + RS_CHUNK;
+    resampler_reset(r);
+    return 0;
+}
+
+void resampler_free(resampler_t *r)
+{
+    free(r->buf[0]);
+    free(r->buf[1]);
+    r->buf[0] = r->buf[1] = NULL;
+    r->bank = NULL;  /* shared */
+}
+
+void resampler_reset(resampler_t *r)
+{
+    /* taps - 1 frames of silence before input frame 0; output 0's window
+       then ends taps/2 frames into the input */
+    memset(r->buf[0], 0, sizeof(float32_t) * (r->taps - 1));
+    memset(r->buf[1], 0, sizeof(float32_t) * (r->taps - 1));
+    r->fill = r->taps - 1;
+    r->pos = r->taps / 2;
+    r->phase = 0;
+    r->frames_in = 0;
+    r->frames_out = 0;
+}
+
+uint32_t resampler_process(resampler_t *r, const float32_t *inL, const float32_t *inR, uint32_t n,
+                           float32_t *outL, float32_t *outR)
+{
+    uint32_t out = 0;
+    r->frames_in += n;
+    for(;;){
+        out += resampler_run(r, outL + out, outR + out, UINT32_MAX);
+        if(n == 0) break;
+
+        /* Keep what the next window still needs at the front */
+        if(r->pos <= r->fill){
+            const uint32_t keep = r->fill - r->pos;
+            memmove(r->buf[0], r->buf[0] + r->pos, sizeof(float32_t) * keep);
+            memmove(r->buf[1], r->buf[1] + r->pos, sizeof(float32_t) * keep);
+            r->fill = keep;
+            r->pos = 0;
+        } else {
+            r->pos -= r->fill;
+            r->fill = 0;
+        }
+        uint32_t m = r->cap - r->fill;
+        if(m > n) m = n;
+        memcpy(r->buf[0] + r->fill, inL, sizeof(float32_t) * m);
+        memcpy(r->buf[1] + r->fill, inR, sizeof(float32_t) * m);
+        r->fill += m;
+        inL += m; inR += m; n -= m;
+    }
+    r->frames_out += out;
+    return out;
+}
+
+uint32_t resampler_flush(resampler_t *r, float32_t *outL, float32_t *outR)
+{
+    static const float32_t zeros[RS_MAX_TAPS / 2];
+    const uint64_t total = (r->frames_in * r->up + r->down - 1) / r->down;
+    const uint64_t in = r->frames_in, done = r->frames_out;
+    uint32_t out = resampler_process(r, zeros, zeros, resampler_latency(r), outL, outR);
+    r->frames_in = in;
+    if(done + out > total) out = (uint32_t)(total - done);
+    r->frames_out = done + out;
+    return out;
+}
+
+#ifndef DSP_DISPATCH /* x86: SIMD kernels in src/resampler_x86.c */
+uint32_t resampler_run(resampler_t *r, float32_t *outL, float32_t *outR, uint32_t max)
+{
+    const uint32_t taps = r->taps;
+    uint32_t pos = r->pos, phase = r->phase, k = 0;
+    for(; k < max && pos + taps <= r->fill; k++){
+        const float32_t *h = r->bank + (size_t)phase * taps;
+        const float32_t *xl = r->buf[0] + pos, *xr = r->buf[1] + pos;
+        float32_t al = 0.0f, ar = 0.0f;
+        for(uint32_t j = 0; j < taps; j++){
+            al += h[j] * xl[j];
+            ar += h[j] * xr[j];
+        }
+        outL[k] = al;
+        outR[k] = ar;
+        pos += r->step;
+        phase += r->frac;
+        if(phase >= r->up){ phase -= r->up; pos++; }
+    }
+    r->pos = pos;
+    r->phase = phase;
+    return k;
+}
+#endif
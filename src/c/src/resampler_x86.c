@@ -0,0 +1,49 @@
+#include "resampler.h"
+#include "fast_math_x86.h"
+
+/* x86-64 resampler_run (same contract as resampler.c).  Branches are a
+ * multiple of 16 taps long, so every level walks the window in whole
+ * vectors; both channels share each coefficient load.  Two accumulators
+ * per channel keep the adds off one dependency chain. */
+uint32_t X86_KFN(resampler_run)(resampler_t *r, float32_t *outL, float32_t *outR, uint32_t max)
+{
+    const uint32_t taps = r->taps;
+    uint32_t pos = r->pos, phase = r->phase, k = 0;
+    for (; k < max && pos + taps <= r->fill; k++) {
+        const float32_t *h = r->bank + (size_t)phase * taps;
+        const float32_t *xl = r->buf[0] + pos, *xr = r->buf[1] + pos;
+#if X86_SIMD_WIDTH > 1
+        enum { W = X86_SIMD_WIDTH };
+        vf_t al0 = VF_SET1(0.0f), al1 = al0, ar0 = al0, ar1 = al0;
+        uint32_t j = 0;
+        for (; j + 2 * W <= taps; j += 2 * W) {
+            const vf_t h0 = VF_LOAD(h + j), h1 = VF_LOAD(h + j + W);
+            al0 = VF_ADD(al0, VF_MUL(h0, VF_LOAD(xl + j)));
+            ar0 = VF_ADD(ar0, VF_MUL(h0, VF_LOAD(xr + j)));
+            al1 = VF_ADD(al1, VF_MUL(h1, VF_LOAD(xl + j + W)));
+            ar1 = VF_ADD(ar1, VF_MUL(h1, VF_LOAD(xr + j + W)));
+        }
+        if (j < taps) {  /* taps is a multiple of 16, so one vector is left at most */
+            const vf_t h0 = VF_LOAD(h + j);
+            al0 = VF_ADD(al0, VF_MUL(h0, VF_LOAD(xl + j)));
+            ar0 = VF_ADD(ar0, VF_MUL(h0, VF_LOAD(xr + j)));
+        }
+        outL[k] = vf_hsum(VF_ADD(al0, al1));
+        outR[k] = vf_hsum(VF_ADD(ar0, ar1));
+#else
+        float32_t al = 0.0f, ar = 0.0f;
+        for (uint32_t j = 0; j < taps; j++) {
+            al += h[j] * xl[j];
+            ar += h[j] * xr[j];
+        }
+        outL[k] = al;
+        outR[k] = ar;
+#endif
+        pos += r->step;
+        phase += r->frac;
+        if (phase >= r->up) { phase -= r->up; pos++; }
+    }
+    r->pos = pos;
+    r->phase = phase;
+    return k;
+}
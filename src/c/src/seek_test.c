@@ -0,0 +1,155 @@
+// seek_test – generator_seek against a straight render.
+//
+// Renders SEED straight through from frame 0 (in GEN_MAX_BLOCK calls, the
+// chunks generator_fast_forward cuts its runs at), then for each target
+// frame seeks a fresh generator there and renders WINDOW frames.  Targets
+// cover the first loop, the loop point and several loops in, where the
+// noise RNGs and oscillator phases have carried over many times.  Only
+// the delay tail before the target is truncated (GEN_SEEK_TAIL_REPEATS
+// echoes), so every window must match to MIN_SNR_DB.  The same targets are
+// then sought on one generator that has already been past the last of
+// them ("warm": it replays at most a loop from its checkpoints), which
+// must render the fresh generator's window exactly, as must a last target
+// FAR_LOOPS loops in.  The process exits 1 if either check fails.
+//
+// Usage: seek_test [seed] [--dsp=<level>]
+#define _POSIX_C_SOURCE 199309L
+#include "generator.h"
+#ifdef DSP_DISPATCH
+#include "dsp_dispatch.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define WINDOW 8192
+#define MIN_SNR_DB 50.0
+#define FAR_LOOPS 60    /* cold vs warm only: past the straight render */
+
+/* Fallback scalar RMS when assembly version not linked */
+#ifndef GENERATOR_RMS_ASM_PRESENT
+float generator_compute_rms_asm(const float *L, const float *R, uint32_t num_frames)
+{
+    double sum = 0.0;
+    for (uint32_t i = 0; i < num_frames; i++)
+        sum += (double)L[i] * L[i] + (double)R[i] * R[i];
+    return (float)sqrt(sum / (double)(2 * num_frames));
+}
+#endif
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t seed = 0x1234;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--dsp=", 6) == 0) {
+#ifdef DSP_DISPATCH
+            dsp_level_t level = dsp_level_from_name(argv[i] + 6);
+            if (level == DSP_LEVEL_COUNT || dsp_dispatch_select(level) != 0) {
+                fprintf(stderr, "Kernel level '%s' not available on this host\n", argv[i] + 6);
+                return 1;
+            }
+#endif
+        } else {
+            seed = strtoull(argv[i], NULL, 0);
+        }
+    }
+
+    generator_t *g = malloc(sizeof(generator_t));
+    if (!g) return 1;
+    if (generator_init(g, seed, SR_DEFAULT) != 0) {
+        free(g);
+        return 1;
+    }
+    const uint32_t period = TOTAL_STEPS * g->mt.step_samples;
+    const uint32_t targets[] = { 0, 1000, period / 2, period - 100, period + 12345,
+                                 2 * period + 777, 1490000, 5 * period + period / 3 };
+    const int n_targets = (int)(sizeof(targets) / sizeof(targets[0]));
+    uint32_t frames = 0;
+    for (int t = 0; t < n_targets; t++)
+        if (targets[t] + WINDOW > frames) frames = targets[t] + WINDOW;
+
+    float *L = malloc(sizeof(float) * frames), *R = malloc(sizeof(float) * frames);
+    if (!L || !R) return 1;
+    for (uint32_t done = 0; done < frames; ) {
+        uint32_t n = frames - done < GEN_MAX_BLOCK ? frames - done : GEN_MAX_BLOCK;
+        generator_process(g, L + done, R + done, n);
+        done += n;
+    }
+    generator_free(g);
+
+    printf("seed 0x%llx, loop %u frames, %u-frame windows", (unsigned long long)seed, period, WINDOW);
+#ifdef DSP_DISPATCH
+    printf(", %s kernels", dsp_level_name(dsp_current_level()));
+#endif
+    printf("\n%10s %8s %12s %10s %10s %10s\n", "frame", "loops", "max|err|", "SNR dB", "seek ms", "warm ms");
+
+    generator_t *warm = malloc(sizeof(generator_t));
+    if (!warm || generator_init(warm, seed, SR_DEFAULT) != 0) return 1;
+    generator_seek(warm, frames - WINDOW);
+
+    int fail = 0;
+    float sL[WINDOW], sR[WINDOW], wL[WINDOW], wR[WINDOW];
+    for (int t = 0; t < n_targets; t++) {
+        const uint32_t frame = targets[t];
+        if (generator_init(g, seed, SR_DEFAULT) != 0) return 1;
+        double t0 = now_sec();
+        generator_seek(g, frame);
+        double ms = (now_sec() - t0) * 1e3;
+        generator_process(g, sL, sR, WINDOW);
+        generator_free(g);
+
+        t0 = now_sec();
+        generator_seek(warm, frame);
+        double warm_ms = (now_sec() - t0) * 1e3;
+        generator_process(warm, wL, wR, WINDOW);
+        int warm_bad = memcmp(wL, sL, sizeof(sL)) != 0 || memcmp(wR, sR, sizeof(sR)) != 0;
+
+        double sig = 0.0, err = 0.0, max_err = 0.0;
+        for (uint32_t i = 0; i < WINDOW; i++) {
+            double eL = (double)sL[i] - L[frame + i], eR = (double)sR[i] - R[frame + i];
+            sig += (double)L[frame + i] * L[frame + i] + (double)R[frame + i] * R[frame + i];
+            err += eL * eL + eR * eR;
+            if (fabs(eL) > max_err) max_err = fabs(eL);
+            if (fabs(eR) > max_err) max_err = fabs(eR);
+        }
+        double snr = err > 0.0 ? 10.0 * log10(sig / err) : INFINITY;
+        int bad = !(snr >= MIN_SNR_DB);
+        fail |= bad | warm_bad;
+        printf("%10u %8.2f %12.3g %10.1f %10.1f %10.1f%s%s\n", frame, (double)frame / period, max_err, snr, ms,
+               warm_ms, bad ? "  FAIL" : "", warm_bad ? "  WARM DIFFERS" : "");
+    }
+
+    /* Far in, where a fresh seek replays every loop before the target */
+    const uint32_t far = FAR_LOOPS * period + period / 3;
+    if (generator_init(g, seed, SR_DEFAULT) != 0) return 1;
+    double t0 = now_sec();
+    generator_seek(g, far);
+    double ms = (now_sec() - t0) * 1e3;
+    generator_process(g, sL, sR, WINDOW);
+    generator_free(g);
+    generator_seek(warm, far + period);
+    t0 = now_sec();
+    generator_seek(warm, far);
+    double warm_ms = (now_sec() - t0) * 1e3;
+    generator_process(warm, wL, wR, WINDOW);
+    int warm_bad = memcmp(wL, sL, sizeof(sL)) != 0 || memcmp(wR, sR, sizeof(sR)) != 0;
+    fail |= warm_bad;
+    printf("%10u %8.2f %12s %10s %10.1f %10.1f%s\n", far, (double)far / period, "-", "-", ms, warm_ms,
+           warm_bad ? "  WARM DIFFERS" : "");
+
+    if (fail) printf("MISMATCH: a seek rendered below %.0f dB SNR against the straight render, "
+                     "or a warm seek differed from a fresh one\n", MIN_SNR_DB);
+
+    generator_free(warm);
+    free(warm); free(g); free(L); free(R);
+    return fail;
+}
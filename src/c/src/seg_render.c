@@ -0,0 +1,190 @@
+#include "seg_render.h"
+#ifdef DSP_DISPATCH
+#include "dsp_dispatch.h"
+#endif
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+void seg_render_free(seg_render_t *r)
+{
+    if(r->out_sr != r->sr) resampler_free(&r->rs);
+    free(r->L); free(r->R);
+    free(r->cL); free(r->cR);
+    free(r->pcm);
+    free(r->rms);
+    memset(r, 0, sizeof(*r));
+}
+
+int seg_render_init(seg_render_t *r, uint32_t sr, uint32_t out_sr, uint32_t block)
+{
+    memset(r, 0, sizeof(*r));
+    r->block = block ? block : SEG_RENDER_BLOCK;
+    r->sr = sr;
+    r->out_sr = out_sr ? out_sr : sr;
+    r->format = PCM_S16;
+
+    uint32_t pcm_frames = r->block;
+    if(r->out_sr != r->sr){
+        if(resampler_init(&r->rs, r->sr, r->out_sr) != 0){
+            r->out_sr = r->sr;  /* nothing to free */
+            return -1;
+        }
+        /* Room for a block's output or the flush, whichever is larger */
+        pcm_frames = resampler_max_out(&r->rs, r->block);
+        const uint32_t tail = resampler_max_out(&r->rs, resampler_latency(&r->rs));
+        if(tail > pcm_frames) pcm_frames = tail;
+        r->cL = malloc(sizeof(float32_t) * pcm_frames);
+        r->cR = malloc(sizeof(float32_t) * pcm_frames);
+    }
+    r->L = malloc(sizeof(float32_t) * r->block);
+    r->R = malloc(sizeof(float32_t) * r->block);
+    r->pcm = malloc((size_t)pcm_sample_bytes(PCM_F32) * pcm_frames * 2);
+    if(!r->L || !r->R || !r->pcm || (r->out_sr != r->sr && (!r->cL || !r->cR))){
+        seg_render_free(r);
+        return -1;
+    }
+    return 0;
+}
+
+void seg_render_set_format(seg_render_t *r, pcm_format_t format, int dither, uint64_t dither_seed)
+{
+    r->format = format;
+    r->dither = dither;
+    r->dither_seed = dither_seed;
+}
+
+void seg_render_set_sidecar(seg_render_t *r, uint32_t fps)
+{
+    r->vis_fps = fps;
+}
+
+/* Fold n written frames into the RMS table: one entry per rms_spf frames
+   (a partial last frame is dropped).  Out of memory stops the table and
+   with it the sidecar (vis_fps 0) for this render. */
+static void seg_render_rms(seg_render_t *r, const float32_t *L, const float32_t *R, uint32_t n)
+{
+    for(uint32_t i = 0; i < n && r->vis_fps; ){
+        uint32_t run = r->rms_spf - r->rms_fill;
+        if(run > n - i) run = n - i;
+        double sum = 0.0;
+        for(uint32_t k = i; k < i + run; k++) sum += (double)L[k]*L[k] + (double)R[k]*R[k];
+        r->rms_acc += sum;
+        r->rms_fill += run;
+        i += run;
+        if(r->rms_fill < r->rms_spf) break;
+        if(r->rms_count == r->rms_cap){
+            const uint32_t cap = r->rms_cap ? 2 * r->rms_cap : 4096;
+            float *grown = realloc(r->rms, sizeof(float) * cap);
+            if(!grown){
+                fprintf(stderr, "seg_render: out of memory for the sidecar RMS, skipping it\n");
+                r->vis_fps = 0;
+                break;
+            }
+            r->rms = grown;
+            r->rms_cap = cap;
+        }
+        r->rms[r->rms_count++] = (float)sqrt(r->rms_acc / (2.0 * r->rms_spf));
+        r->rms_acc = 0.0;
+        r->rms_fill = 0;
+    }
+}
+
+/* The sidecar for the render just written to wav_path */
+static int seg_render_sidecar(const seg_render_t *r, const generator_t *g, const char *wav_path,
+                              uint32_t wav_frames)
+{
+    char path[1024];
+    seg_sidecar_path(wav_path, path, sizeof(path));
+    const double rate = (double)r->out_sr / r->sr;
+    seg_sidecar_header_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.seed = g->seed;
+    hdr.sample_rate = r->out_sr;
+    hdr.fps = r->vis_fps;
+    hdr.bpm = g->mt.bpm;
+    hdr.step_frames = (float)(g->mt.step_samples * rate);
+    hdr.loop_frames = (uint32_t)(g->mt.seg_frames * rate + 0.5);
+    hdr.wav_frames = wav_frames;
+#ifdef DSP_DISPATCH
+    /* Output is bit-exact only within a level: record which one made it */
+    hdr.dsp_level = (uint8_t)(dsp_current_level() + 1);
+    hdr.fm_model = (uint8_t)dsp_fm_current();
+#endif
+    return seg_sidecar_write(path, &hdr, &g->q, r->sr, r->rms, r->rms_count);
+}
+
+/* A WAV rendered without a sidecar: one left by an earlier render would
+   describe the old file, so it goes */
+static int seg_render_drop_sidecar(const char *wav_path)
+{
+    char path[1024];
+    seg_sidecar_path(wav_path, path, sizeof(path));
+    if(remove(path) != 0 && errno != ENOENT){
+        perror("seg_render: removing the stale sidecar");
+        return -1;
+    }
+    return 0;
+}
+
+/* Convert one block and append it.  Integer formats saturate, which also
+   catches the resampler ringing past full scale around clipped peaks. */
+static int seg_render_write(seg_render_t *r, wav_stream_t *ws, const float32_t *L, const float32_t *R,
+                            uint32_t n)
+{
+    seg_render_rms(r, L, R, n);
+    pcm_convert(&r->conv, L, R, n, r->pcm);
+    return wav_stream_append(ws, r->pcm, n);
+}
+
+int seg_render_wav(seg_render_t *r, generator_t *g, uint32_t frames, const char *path,
+                   seg_render_stats_t *stats)
+{
+    seg_render_stats_t st = { 0, 0, 0.0 };
+    const int convert = r->out_sr != r->sr;
+    wav_stream_t ws;
+    if(wav_stream_open_format(&ws, path, 2, r->out_sr, r->format) != 0) return -1;
+    pcm_conv_init(&r->conv, r->format, r->dither, r->dither_seed);
+    if(convert) resampler_reset(&r->rs);
+    const uint32_t vis_fps = r->vis_fps;
+    r->rms_count = r->rms_fill = 0;
+    r->rms_acc = 0.0;
+    r->rms_spf = vis_fps && r->out_sr >= vis_fps ? r->out_sr / vis_fps : 1;
+
+    uint32_t skip = limiter_latency(&g->limiter);
+    uint64_t left = (uint64_t)frames + skip;
+    while(left > 0 && !ws.error){
+        uint32_t n = left < r->block ? (uint32_t)left : r->block;
+        generator_process(g, r->L, r->R, n);
+        left -= n;
+
+        float32_t *L = r->L, *R = r->R;
+        const uint32_t drop = skip < n ? skip : n;
+        L += drop; R += drop; n -= drop; skip -= drop;
+        if(n == 0) continue;
+
+        double sum = 0.0;
+        for(uint32_t i = 0; i < n; i++) sum += (double)L[i]*L[i] + (double)R[i]*R[i];
+        st.sum_sq += sum;
+        st.frames += n;
+
+        if(convert){
+            n = resampler_process(&r->rs, L, R, n, r->cL, r->cR);
+            L = r->cL; R = r->cR;
+        }
+        seg_render_write(r, &ws, L, R, n);
+    }
+    if(convert && !ws.error){
+        const uint32_t n = resampler_flush(&r->rs, r->cL, r->cR);
+        seg_render_write(r, &ws, r->cL, r->cR, n);
+    }
+    st.out_frames = ws.frames;
+    if(stats) *stats = st;
+    int rc = wav_stream_close(&ws);
+    if(rc == 0)
+        rc = r->vis_fps ? seg_render_sidecar(r, g, path, (uint32_t)ws.frames) : seg_render_drop_sidecar(path);
+    r->vis_fps = vis_fps;   /* back on for the next render if RMS ran out of memory */
+    return rc;
+}
@@ -0,0 +1,111 @@
+#define _POSIX_C_SOURCE 200809L
+#include "seg_sidecar.h"
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+void seg_sidecar_path(const char *wav_path, char *out, size_t cap)
+{
+    const char *slash = strrchr(wav_path, '/');
+    const char *dot = strrchr(wav_path, '.');
+    size_t stem = (dot && (!slash || dot > slash)) ? (size_t)(dot - wav_path) : strlen(wav_path);
+    snprintf(out, cap, "%.*s%s", (int)stem, wav_path, SEG_SIDECAR_EXT);
+}
+
+int seg_sidecar_write(const char *path, const seg_sidecar_header_t *hdr, const event_queue_t *q,
+                      uint32_t render_sr, const float *rms, uint32_t rms_count)
+{
+    seg_sidecar_header_t h = *hdr;
+    memcpy(h.magic, SEG_SIDECAR_MAGIC, 4);
+    h.version = SEG_SIDECAR_VERSION;
+    h.steps = TOTAL_STEPS;
+    h.event_count = q->count;
+    h.rms_count = rms_count;
+    h.rms_max = 0.0f;
+    for(uint32_t i = 0; i < rms_count; i++)
+        if(rms[i] > h.rms_max) h.rms_max = rms[i];
+    h.step_offset = sizeof(h);
+    h.event_offset = h.step_offset + sizeof(uint32_t) * (TOTAL_STEPS + 1);
+    h.rms_offset = h.event_offset + sizeof(seg_sidecar_event_t) * q->count;
+
+    FILE *f = fopen(path, "wb");
+    if(!f){
+        perror("seg_sidecar_write: fopen");
+        return -1;
+    }
+    fwrite(&h, sizeof(h), 1, f);
+    fwrite(q->step_start, sizeof(uint32_t), TOTAL_STEPS + 1, f);
+    for(uint32_t i = 0; i < q->count; i++){
+        const event_t *e = &q->events[i];
+        const seg_sidecar_event_t se = {
+            (uint32_t)(((uint64_t)e->time * h.sample_rate + render_sr / 2) / render_sr),
+            e->type, e->aux, e->variant, 0, e->freq
+        };
+        fwrite(&se, sizeof(se), 1, f);
+    }
+    fwrite(rms, sizeof(float), rms_count, f);
+    int rc = 0;
+    if(ferror(f)){
+        perror("seg_sidecar_write: write");
+        rc = -1;
+    }
+    if(fclose(f) != 0){
+        perror("seg_sidecar_write: fclose");
+        rc = -1;
+    }
+    return rc;
+}
+
+void seg_sidecar_unmap(seg_sidecar_t *s)
+{
+    if(s->map) munmap(s->map, s->map_size);
+    memset(s, 0, sizeof(*s));
+}
+
+/* [offset, offset + count·size) lies inside the file */
+static int section_fits(uint32_t offset, uint32_t count, size_t size, size_t file_size)
+{
+    return offset % 4 == 0 && offset <= file_size && (uint64_t)count * size <= file_size - offset;
+}
+
+int seg_sidecar_map(seg_sidecar_t *s, const char *path)
+{
+    memset(s, 0, sizeof(*s));
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return -1;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(seg_sidecar_header_t)){
+        close(fd);
+        return -1;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED) return -1;
+    s->map = map;
+    s->map_size = (size_t)st.st_size;
+
+    const seg_sidecar_header_t *h = map;
+    const uint8_t *base = map;
+    if(memcmp(h->magic, SEG_SIDECAR_MAGIC, 4) != 0 || h->version != SEG_SIDECAR_VERSION ||
+       h->sample_rate == 0 || h->fps == 0 || h->steps == 0 || h->steps > TOTAL_STEPS ||
+       !section_fits(h->step_offset, h->steps + 1, sizeof(uint32_t), s->map_size) ||
+       !section_fits(h->event_offset, h->event_count, sizeof(seg_sidecar_event_t), s->map_size) ||
+       !section_fits(h->rms_offset, h->rms_count, sizeof(float), s->map_size)){
+        seg_sidecar_unmap(s);
+        return -1;
+    }
+    s->hdr = h;
+    s->step_start = (const uint32_t *)(base + h->step_offset);
+    s->events = (const seg_sidecar_event_t *)(base + h->event_offset);
+    s->rms = (const float *)(base + h->rms_offset);
+    for(uint32_t i = 0; i <= h->steps; i++){
+        if(s->step_start[i] > h->event_count || (i && s->step_start[i] < s->step_start[i-1])){
+            seg_sidecar_unmap(s);
+            return -1;
+        }
+    }
+    return 0;
+}
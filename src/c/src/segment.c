@@ -1,15 +1,12 @@
-#include "wav_writer.h"
-#include "generator.h"
+#include "seg_render.h"
+#include "trace.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
-
-/* extern counter defined in generator_step.c */
-extern int g_mid_trigger_count;
-
-#define MAX_SEG_FRAMES 424000 
-static float L[MAX_SEG_FRAMES], R[MAX_SEG_FRAMES];
-static int16_t pcm[MAX_SEG_FRAMES * 2];
+#include <string.h>
+#ifdef DSP_DISPATCH
+#include "dsp_dispatch.h"
+#endif
 
 /* Fallback scalar RMS when assembly version not linked */
 #ifndef GENERATOR_RMS_ASM_PRESENT
@@ -28,33 +25,139 @@ float generator_compute_rms_asm(const float *L, const float *R, uint32_t num_fra
 int main(int argc, char **argv)
 {
     uint64_t seed = 0xCAFEBABEULL;
-    if(argc > 1) {
-        seed = strtoull(argv[1], NULL, 0);
+    const char *trace_path = NULL;
+    uint32_t threads = 1;
+    uint32_t poly = 1;
+    uint32_t sr = SR_DEFAULT;
+    uint32_t out_sr = 0;  /* 0: write the render rate */
+    uint32_t seconds = 0; /* 0: one segment */
+    limiter_mode_t limiter = LIMITER_SOFT_KNEE;
+    pcm_format_t format = PCM_S16;
+    int dither = 0;
+    int sidecar = 1;
+    voice_steal_t steal = VOICE_STEAL_OLDEST;
+    for(int i = 1; i < argc; i++) {
+        if(strncmp(argv[i], "--trace=", 8) == 0) {
+            trace_path = argv[i] + 8;
+        } else if(strncmp(argv[i], "--threads=", 10) == 0) {
+            threads = (uint32_t)strtoul(argv[i] + 10, NULL, 0);
+        } else if(strncmp(argv[i], "--sr=", 5) == 0) {
+            sr = (uint32_t)strtoul(argv[i] + 5, NULL, 0);
+            if(sr < SR_MIN || sr > SR_MAX) {
+                fprintf(stderr, "Sample rate %s out of range (%u..%u)\n", argv[i] + 5, SR_MIN, SR_MAX);
+                return 1;
+            }
+        } else if(strncmp(argv[i], "--seconds=", 10) == 0) {
+            seconds = (uint32_t)strtoul(argv[i] + 10, NULL, 0);
+        } else if(strncmp(argv[i], "--out-sr=", 9) == 0) {
+            out_sr = (uint32_t)strtoul(argv[i] + 9, NULL, 0);
+        } else if(strncmp(argv[i], "--limiter=", 10) == 0) {
+            if(strcmp(argv[i] + 10, "softknee") == 0) limiter = LIMITER_SOFT_KNEE;
+            else if(strcmp(argv[i] + 10, "truepeak") == 0) limiter = LIMITER_TRUE_PEAK;
+            else {
+                fprintf(stderr, "Unknown limiter '%s' (softknee|truepeak)\n", argv[i] + 10);
+                return 1;
+            }
+        } else if(strncmp(argv[i], "--format=", 9) == 0) {
+            format = pcm_format_from_name(argv[i] + 9);
+            if(format == PCM_FORMAT_COUNT) {
+                fprintf(stderr, "Unknown sample format '%s' (s16|s24|f32)\n", argv[i] + 9);
+                return 1;
+            }
+        } else if(strncmp(argv[i], "--dither=", 9) == 0) {
+            if(strcmp(argv[i] + 9, "none") == 0) dither = 0;
+            else if(strcmp(argv[i] + 9, "tpdf") == 0) dither = 1;
+            else {
+                fprintf(stderr, "Unknown dither '%s' (none|tpdf)\n", argv[i] + 9);
+                return 1;
+            }
+        } else if(strcmp(argv[i], "--no-sidecar") == 0) {
+            sidecar = 0;
+        } else if(strncmp(argv[i], "--poly=", 7) == 0) {
+            poly = (uint32_t)strtoul(argv[i] + 7, NULL, 0);
+        } else if(strncmp(argv[i], "--steal=", 8) == 0) {
+            if(strcmp(argv[i] + 8, "oldest") == 0) steal = VOICE_STEAL_OLDEST;
+            else if(strcmp(argv[i] + 8, "quietest") == 0) steal = VOICE_STEAL_QUIETEST;
+            else {
+                fprintf(stderr, "Unknown stealing policy '%s' (oldest|quietest)\n", argv[i] + 8);
+                return 1;
+            }
+        } else if(strncmp(argv[i], "--dsp=", 6) == 0) {
+#ifdef DSP_DISPATCH
+            dsp_level_t level = dsp_level_from_name(argv[i] + 6);
+            if(level == DSP_LEVEL_COUNT || dsp_dispatch_select(level) != 0) {
+                fprintf(stderr, "Kernel level '%s' not available on this host\n", argv[i] + 6);
+                return 1;
+            }
+#endif
+        } else if(strncmp(argv[i], "--fm=", 5) == 0) {
+#ifdef DSP_DISPATCH
+            if(dsp_fm_select(dsp_fm_from_name(argv[i] + 5)) != 0) {
+                fprintf(stderr, "Unknown FM model '%s' (arm|phasor)\n", argv[i] + 5);
+                return 1;
+            }
+#endif
+        } else {
+            seed = strtoull(argv[i], NULL, 0);
+        }
     }
+#ifdef DSP_DISPATCH
+    dsp_dispatch_init();
+    printf("DSP kernels: %s, FM %s\n", dsp_level_name(dsp_current_level()), dsp_fm_name(dsp_fm_current()));
+#endif
     
-    generator_t g;
-    generator_init(&g, seed);
-
-    uint32_t total_frames = g.mt.seg_frames;
-    if(total_frames > MAX_SEG_FRAMES) total_frames = MAX_SEG_FRAMES;
+    if(trace_path && trace_start(trace_path) != 0) {
+        fprintf(stderr, "Tracing unavailable (rebuild with TRACE=1)\n");
+    }
 
-    printf("C-DBG before gen_process: step_samples=%u addr=%p\n", g.mt.step_samples, &g.mt.step_samples);
-    generator_process(&g, L, R, total_frames);
-    
-    /* RMS diagnostic to verify audio energy */
-    float rms = generator_compute_rms_asm(L, R, total_frames);
-    printf("C-POST rms=%f\n", rms);
-    printf("DEBUG: MID triggers fired = %d\n", g_mid_trigger_count);
+    generator_t g;
+    if(generator_init(&g, seed, sr) != 0) {
+        trace_stop();
+        return 1;
+    }
+    generator_set_threads(&g, threads);
+    generator_set_limiter(&g, limiter);
+    if(poly > 1 || steal != VOICE_STEAL_OLDEST)
+        for(int i = 0; i < GEN_INST_COUNT; i++)
+            generator_set_polyphony(&g, (gen_inst_t)i, poly, steal);
 
-    for(uint32_t i=0;i<total_frames;i++){
-        pcm[2*i]   = (int16_t)(L[i]*32767);
-        pcm[2*i+1] = (int16_t)(R[i]*32767);
+    /* Stream the render in blocks: memory does not grow with --seconds.
+       Parallel renders need a block long enough to split across threads. */
+    uint32_t total_frames = seconds ? (uint32_t)fmin((double)seconds * g.mt.sr, (double)UINT32_MAX)
+                                    : g.mt.seg_frames;
+    uint32_t block = SEG_RENDER_BLOCK;
+    if(threads > 1 && threads * GEN_PAR_MIN_CHUNK > block) block = threads * GEN_PAR_MIN_CHUNK;
+    seg_render_t render;
+    if(seg_render_init(&render, g.mt.sr, out_sr, block) != 0) {
+        fprintf(stderr, "Cannot render %u Hz to %u Hz\n", g.mt.sr, out_sr ? out_sr : g.mt.sr);
+        return 1;
     }
+    seg_render_set_format(&render, format, dither, seed);
+    seg_render_set_sidecar(&render, sidecar ? SEG_SIDECAR_FPS : 0);
 
     char wavname[64];
     sprintf(wavname, "seed_0x%llx.wav", (unsigned long long)seed);
-    write_wav(wavname, pcm, total_frames, 2, SR);
-    printf("Wrote %s (%u frames, %.2f bpm, root %.2f Hz)\n", wavname, total_frames, g.mt.bpm, g.music.root_freq);
+    printf("C-DBG before gen_process: step_samples=%u addr=%p\n", g.mt.step_samples, &g.mt.step_samples);
+    seg_render_stats_t st;
+    int rc = seg_render_wav(&render, &g, total_frames, wavname, &st);
+    trace_stop();
+    const uint32_t wav_sr = render.out_sr;
+    seg_render_free(&render);
+    if(rc != 0) {
+        generator_free(&g);
+        return 1;
+    }
+
+    /* RMS diagnostic to verify audio energy */
+    printf("C-POST rms=%f\n", st.frames ? sqrt(st.sum_sq / (2.0 * st.frames)) : 0.0);
+    printf("Wrote %s (%u frames at %u Hz %s, %.2f bpm, root %.2f Hz)\n", wavname, st.out_frames, wav_sr,
+           pcm_format_name(format), g.mt.bpm, g.music.root_freq);
+    if(sidecar) {
+        char visname[64];
+        seg_sidecar_path(wavname, visname, sizeof(visname));
+        printf("Wrote %s (RMS at %u fps, %u events)\n", visname, SEG_SIDECAR_FPS, g.q.count);
+    }
+    generator_free(&g);
 
     return 0;
 } 
\ No newline at end of file
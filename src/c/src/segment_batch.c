@@ -0,0 +1,356 @@
+// segment_batch – render many seeds in one process.
+//
+// A pool of worker threads each owns a generator_t and a seg_render_t
+// (generator_t is self-contained per seed: it embeds its own RNG and delay
+// line).  Seeds are split into one contiguous slice per worker; a worker
+// that runs dry steals the back half of the fullest remaining slice, so
+// uneven render times (BPM changes segment length) balance out.  Each
+// worker streams its WAV to disk block by block as it renders, so memory
+// per worker is fixed whatever the segment length.
+//
+// Usage:
+//   segment_batch [-j N] [-o DIR] [--sr HZ] [--out-sr HZ] [--format F] [--dither D] [--no-sidecar] --range START COUNT
+//   segment_batch [-j N] [-o DIR] [--sr HZ] [--out-sr HZ] [--format F] [--dither D] [--no-sidecar] --seeds FILE
+//                                             (one seed per line, # comments)
+//
+// Engine init messages go to stdout; the final seeds/second report goes to
+// stderr.  TRACE=1 builds take --trace FILE to record every worker's
+// voice/step events into one trace.
+#define _POSIX_C_SOURCE 200809L
+#include "seg_render.h"
+#include "trace.h"
+#ifdef DSP_DISPATCH
+#include "dsp_dispatch.h"
+#endif
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_WORKERS 256
+
+typedef struct {
+    pthread_mutex_t lock;
+    uint32_t next;  /* first unclaimed job in this slice */
+    uint32_t end;   /* one past the last job */
+} job_slice_t;
+
+typedef struct {
+    const uint64_t *seeds;
+    const char *out_dir;
+    job_slice_t *slices;
+    uint32_t num_workers;
+    uint32_t sr;
+    uint32_t out_sr;  /* WAV rate; differs from sr when converting */
+    pcm_format_t format;
+    int dither;       /* TPDF, seeded with each render's seed */
+    int sidecar;      /* write seg_sidecar.h analysis next to each WAV */
+    atomic_int stop;  /* set to end the batch early: workers take no new seed */
+} batch_t;
+
+typedef struct {
+    batch_t *batch;
+    uint32_t id;
+    uint32_t rendered;
+    uint32_t stolen;
+    uint64_t frames;
+} worker_t;
+
+/* Pop the next job from our own slice. */
+static int slice_pop(job_slice_t *s, uint32_t *job)
+{
+    int ok = 0;
+    pthread_mutex_lock(&s->lock);
+    if (s->next < s->end) {
+        *job = s->next++;
+        ok = 1;
+    }
+    pthread_mutex_unlock(&s->lock);
+    return ok;
+}
+
+/* Move the back half of the fullest other slice into ours. */
+static int slice_steal(batch_t *b, uint32_t self)
+{
+    for (;;) {
+        uint32_t victim = self, best = 0;
+        for (uint32_t w = 0; w < b->num_workers; ++w) {
+            if (w == self) continue;
+            pthread_mutex_lock(&b->slices[w].lock);
+            uint32_t left = b->slices[w].end - b->slices[w].next;
+            pthread_mutex_unlock(&b->slices[w].lock);
+            if (left > best) { best = left; victim = w; }
+        }
+        if (victim == self) return 0;
+
+        job_slice_t *v = &b->slices[victim];
+        uint32_t lo = 0, hi = 0;
+        pthread_mutex_lock(&v->lock);
+        uint32_t left = v->end - v->next;
+        if (left > 0) {
+            uint32_t take = (left + 1) / 2;
+            hi = v->end;
+            lo = v->end - take;
+            v->end = lo;
+        }
+        pthread_mutex_unlock(&v->lock);
+        if (hi == lo) continue; /* drained while we looked, try again */
+
+        job_slice_t *s = &b->slices[self];
+        pthread_mutex_lock(&s->lock);
+        s->next = lo;
+        s->end = hi;
+        pthread_mutex_unlock(&s->lock);
+        return 1;
+    }
+}
+
+static void *worker_main(void *arg)
+{
+    worker_t *w = arg;
+    batch_t *b = w->batch;
+    generator_t *g = malloc(sizeof(generator_t));
+    seg_render_t render;  /* block buffers, reused for every seed */
+    if (!g || seg_render_init(&render, b->sr, b->out_sr, 0) != 0) {
+        fprintf(stderr, "worker %u: out of memory\n", w->id);
+        free(g);
+        return NULL;
+    }
+    seg_render_set_sidecar(&render, b->sidecar ? SEG_SIDECAR_FPS : 0);
+
+    while (!atomic_load(&b->stop)) {
+        uint32_t job;
+        if (!slice_pop(&b->slices[w->id], &job)) {
+            if (!slice_steal(b, w->id)) break;
+            w->stolen++;
+            continue;
+        }
+        uint64_t seed = b->seeds[job];
+        if (generator_init(g, seed, b->sr) != 0) {
+            fprintf(stderr, "worker %u: cannot start seed 0x%llx\n", w->id, (unsigned long long)seed);
+            continue;
+        }
+        seg_render_set_format(&render, b->format, b->dither, seed);
+        char wavname[512];
+        snprintf(wavname, sizeof(wavname), "%s/seed_0x%llx.wav", b->out_dir, (unsigned long long)seed);
+        seg_render_stats_t st;
+        const int rc = seg_render_wav(&render, g, g->mt.seg_frames, wavname, &st);
+        generator_free(g);
+        w->frames += st.frames;
+        if (rc == 0) w->rendered++;
+    }
+
+    seg_render_free(&render);
+    free(g);
+    return NULL;
+}
+
+static uint64_t *read_seed_file(const char *path, uint32_t *count)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) { perror(path); return NULL; }
+    uint32_t cap = 256, n = 0;
+    uint64_t *seeds = malloc(sizeof(uint64_t) * cap);
+    char line[256];
+    while (seeds && fgets(line, sizeof(line), f)) {
+        char *p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+        if (n == cap) {
+            cap *= 2;
+            uint64_t *grown = realloc(seeds, sizeof(uint64_t) * cap);
+            if (!grown) { free(seeds); seeds = NULL; break; }
+            seeds = grown;
+        }
+        seeds[n++] = strtoull(p, NULL, 0);
+    }
+    fclose(f);
+    *count = n;
+    return seeds;
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-j N] [-o DIR] [--sr HZ] [--out-sr HZ] [--format F] [--dither D] [--dsp L] [--no-sidecar]\n"
+                    "       %*s --range START COUNT\n", prog, (int)strlen(prog), "");
+    fprintf(stderr, "       %s [-j N] [-o DIR] [--sr HZ] [--out-sr HZ] [--format F] [--dither D] [--dsp L] [--no-sidecar]\n"
+                    "       %*s --seeds FILE\n", prog, (int)strlen(prog), "");
+    fprintf(stderr, "  -j N   worker threads (default: online CPUs)\n");
+    fprintf(stderr, "  -o DIR output directory (default: .)\n");
+    fprintf(stderr, "  --sr HZ  sample rate, %u..%u (default: %u)\n", SR_MIN, SR_MAX, SR_DEFAULT);
+    fprintf(stderr, "  --out-sr HZ  convert each render to this rate before writing it\n");
+    fprintf(stderr, "  --format F  s16|s24|f32 (default: s16)\n");
+    fprintf(stderr, "  --dither D  none|tpdf, for s16/s24 (default: none)\n");
+    fprintf(stderr, "  --dsp L  scalar|sse41|avx2|avx512 kernels (default: widest on this CPU; output differs by level)\n");
+    fprintf(stderr, "  --fm M  arm|phasor FM model (default: arm)\n");
+    fprintf(stderr, "  --no-sidecar  skip the visualiser's .vis analysis file next to each WAV (an old one is deleted)\n");
+    fprintf(stderr, "  --trace FILE  binary event trace (TRACE=1 builds)\n");
+}
+
+int main(int argc, char **argv)
+{
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t num_workers = ncpu > 0 ? (uint32_t)ncpu : 1;
+    const char *out_dir = ".";
+    uint64_t *seeds = NULL;
+    uint32_t num_seeds = 0;
+    const char *trace_path = NULL;
+    uint32_t sr = SR_DEFAULT;
+    uint32_t out_sr = 0;
+    pcm_format_t format = PCM_S16;
+    int dither = 0;
+    int sidecar = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            num_workers = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_dir = argv[++i];
+        } else if (strcmp(argv[i], "--range") == 0 && i + 2 < argc) {
+            uint64_t start = strtoull(argv[++i], NULL, 0);
+            num_seeds = (uint32_t)strtoul(argv[++i], NULL, 0);
+            seeds = malloc(sizeof(uint64_t) * (num_seeds ? num_seeds : 1));
+            for (uint32_t s = 0; seeds && s < num_seeds; s++) seeds[s] = start + s;
+        } else if (strcmp(argv[i], "--sr") == 0 && i + 1 < argc) {
+            sr = (uint32_t)strtoul(argv[++i], NULL, 0);
+            if (sr < SR_MIN || sr > SR_MAX) {
+                usage(argv[0]);
+                free(seeds);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--out-sr") == 0 && i + 1 < argc) {
+            out_sr = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            format = pcm_format_from_name(argv[++i]);
+            if (format == PCM_FORMAT_COUNT) {
+                usage(argv[0]);
+                free(seeds);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--dither") == 0 && i + 1 < argc) {
+            ++i;
+            if (strcmp(argv[i], "none") == 0) dither = 0;
+            else if (strcmp(argv[i], "tpdf") == 0) dither = 1;
+            else {
+                usage(argv[0]);
+                free(seeds);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--dsp") == 0 && i + 1 < argc) {
+#ifdef DSP_DISPATCH
+            dsp_level_t level = dsp_level_from_name(argv[++i]);
+            if (level == DSP_LEVEL_COUNT || dsp_dispatch_select(level) != 0) {
+                fprintf(stderr, "Kernel level '%s' not available on this host\n", argv[i]);
+                free(seeds);
+                return 1;
+            }
+#else
+            ++i;
+#endif
+        } else if (strcmp(argv[i], "--fm") == 0 && i + 1 < argc) {
+#ifdef DSP_DISPATCH
+            if (dsp_fm_select(dsp_fm_from_name(argv[++i])) != 0) {
+                usage(argv[0]);
+                free(seeds);
+                return 1;
+            }
+#else
+            ++i;
+#endif
+        } else if (strcmp(argv[i], "--no-sidecar") == 0) {
+            sidecar = 0;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--seeds") == 0 && i + 1 < argc) {
+            seeds = read_seed_file(argv[++i], &num_seeds);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!seeds || num_seeds == 0) {
+        usage(argv[0]);
+        free(seeds);
+        return 1;
+    }
+    if (out_sr == 0) out_sr = sr;
+    if (out_sr != sr) {
+        resampler_t probe;  /* builds the shared bank before the workers start */
+        if (resampler_init(&probe, sr, out_sr) != 0) {
+            fprintf(stderr, "Cannot convert %u Hz to %u Hz\n", sr, out_sr);
+            free(seeds);
+            return 1;
+        }
+        resampler_free(&probe);
+    }
+    if (num_workers == 0) num_workers = 1;
+    if (num_workers > MAX_WORKERS) num_workers = MAX_WORKERS;
+    if (num_workers > num_seeds) num_workers = num_seeds;
+
+#ifdef DSP_DISPATCH
+    dsp_dispatch_init(); /* choose kernels before any worker starts */
+    fprintf(stderr, "DSP kernels: %s, FM %s\n", dsp_level_name(dsp_current_level()), dsp_fm_name(dsp_fm_current()));
+#endif
+
+    batch_t batch = { seeds, out_dir, calloc(num_workers, sizeof(job_slice_t)), num_workers, sr, out_sr,
+                      format, dither, sidecar, 0 };
+    worker_t *workers = calloc(num_workers, sizeof(worker_t));
+    pthread_t *threads = calloc(num_workers, sizeof(pthread_t));
+    if (!batch.slices || !workers || !threads) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (uint32_t w = 0; w < num_workers; w++) {
+        pthread_mutex_init(&batch.slices[w].lock, NULL);
+        batch.slices[w].next = (uint32_t)((uint64_t)num_seeds * w / num_workers);
+        batch.slices[w].end  = (uint32_t)((uint64_t)num_seeds * (w + 1) / num_workers);
+        workers[w].batch = &batch;
+        workers[w].id = w;
+    }
+
+    if (trace_path && trace_start(trace_path) != 0)
+        fprintf(stderr, "Tracing unavailable (rebuild with TRACE=1)\n");
+
+    double t0 = now_sec();
+    for (uint32_t w = 0; w < num_workers; w++) {
+        if (pthread_create(&threads[w], NULL, worker_main, &workers[w]) != 0) {
+            /* Workers already running finish the WAV in hand and stop */
+            fprintf(stderr, "pthread_create failed for worker %u, stopping\n", w);
+            atomic_store(&batch.stop, 1);
+            for (uint32_t j = 0; j < w; j++) pthread_join(threads[j], NULL);
+            trace_stop();
+            for (uint32_t j = 0; j < num_workers; j++) pthread_mutex_destroy(&batch.slices[j].lock);
+            free(batch.slices); free(workers); free(threads); free(seeds);
+            return 1;
+        }
+    }
+    uint32_t rendered = 0, stolen = 0;
+    uint64_t frames = 0;
+    for (uint32_t w = 0; w < num_workers; w++) {
+        pthread_join(threads[w], NULL);
+        rendered += workers[w].rendered;
+        stolen += workers[w].stolen;
+        frames += workers[w].frames;
+    }
+    double elapsed = now_sec() - t0;
+    trace_stop();
+
+    fprintf(stderr, "Rendered %u/%u seeds on %u workers in %.2f s: %.2f seeds/s, %.1fx realtime (%u steals)\n",
+            rendered, num_seeds, num_workers, elapsed, rendered / elapsed,
+            (double)frames / sr / elapsed, stolen);
+
+    for (uint32_t w = 0; w < num_workers; w++) pthread_mutex_destroy(&batch.slices[w].lock);
+    free(batch.slices); free(workers); free(threads); free(seeds);
+    return rendered == num_seeds ? 0 : 1;
+}
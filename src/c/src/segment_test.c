@@ -49,14 +49,22 @@ int main(int argc, char **argv)
 
     const uint32_t sr = 44100;
     generator_t g;
-    generator_init(&g, seed);
+    if(generator_init(&g, seed, SR_DEFAULT) != 0) return 1;
 
     // Calculate total frames (same as segment.c)
     uint32_t total_frames = g.mt.seg_frames;
     printf("Total duration: %.2f sec (%u frames)\n", g.mt.seg_sec, total_frames);
 
-    float *L = calloc(total_frames, sizeof(float));
-    float *R = calloc(total_frames, sizeof(float));
+    // Stream each block to the WAV as it is rendered
+    char filename[64];
+    snprintf(filename, sizeof(filename), "segment_test_0x%llx.wav", (unsigned long long)seed);
+    wav_stream_t ws;
+    if (wav_stream_open(&ws, filename, 2, sr) != 0) {
+        generator_free(&g);
+        return 1;
+    }
+    float block_L[1024], block_R[1024];
+    int16_t pcm[1024 * 2];
 
     // Generate the audio using the same process as segment.c
     // but with selective voice processing
@@ -67,27 +75,23 @@ int main(int argc, char **argv)
         // Trigger events (always run this to advance timing)
         generator_trigger_step(&g);
         
-        // Process voices selectively
-        float *block_L = &L[frame];
-        float *block_R = &R[frame];
-        
         // Clear the block
         memset(block_L, 0, block_size * sizeof(float));
         memset(block_R, 0, block_size * sizeof(float));
         
         if (enable_drums) {
-            kick_process(&g.kick, block_L, block_R, block_size);
-            snare_process(&g.snare, block_L, block_R, block_size);
-            hat_process(&g.hat, block_L, block_R, block_size);
+            generator_render_inst(&g, GEN_INST_KICK, block_L, block_R, block_size);
+            generator_render_inst(&g, GEN_INST_SNARE, block_L, block_R, block_size);
+            generator_render_inst(&g, GEN_INST_HAT, block_L, block_R, block_size);
         }
         
         if (enable_melody) {
-            melody_process(&g.mel, block_L, block_R, block_size);
+            generator_render_inst(&g, GEN_INST_MELODY, block_L, block_R, block_size);
         }
         
         if (enable_fm) {
-            fm_voice_process(&g.mid_fm, block_L, block_R, block_size);
-            fm_voice_process(&g.bass_fm, block_L, block_R, block_size);
+            generator_render_inst(&g, GEN_INST_MID_FM, block_L, block_R, block_size);
+            generator_render_inst(&g, GEN_INST_BASS_FM, block_L, block_R, block_size);
         }
         
         if (enable_delay) {
@@ -105,23 +109,21 @@ int main(int argc, char **argv)
             g.step++;
         }
         
+        // Convert to int16 and append
+        for (uint32_t i = 0; i < block_size; i++) {
+            float vL = block_L[i]; if(vL > 1) vL = 1; if(vL < -1) vL = -1;
+            float vR = block_R[i]; if(vR > 1) vR = 1; if(vR < -1) vR = -1;
+            pcm[2*i] = (int16_t)(vL * 32767);
+            pcm[2*i+1] = (int16_t)(vR * 32767);
+        }
+        wav_stream_append(&ws, pcm, block_size);
+
         frame += block_size;
     }
 
-    // Convert to int16 WAV
-    int16_t *pcm = malloc(sizeof(int16_t) * total_frames * 2);
-    for (uint32_t i = 0; i < total_frames; i++) {
-        float vL = L[i]; if(vL > 1) vL = 1; if(vL < -1) vL = -1;
-        float vR = R[i]; if(vR > 1) vR = 1; if(vR < -1) vR = -1;
-        pcm[2*i] = (int16_t)(vL * 32767);
-        pcm[2*i+1] = (int16_t)(vR * 32767);
-    }
-    
-    char filename[64];
-    snprintf(filename, sizeof(filename), "segment_test_0x%llx.wav", (unsigned long long)seed);
-    write_wav(filename, pcm, total_frames, 2, sr);
-    printf("Generated %s\n", filename);
+    int rc = wav_stream_close(&ws);
+    if (rc == 0) printf("Generated %s\n", filename);
 
-    free(L); free(R); free(pcm);
-    return 0;
+    generator_free(&g);
+    return rc == 0 ? 0 : 1;
 }
@@ -1,3 +1,4 @@
+#define _DEFAULT_SOURCE  /* M_PI under -std=c11 on glibc */
 #include "shapes.h"
 #include "raster.h"
 #include <math.h>
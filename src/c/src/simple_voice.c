@@ -1,12 +1,18 @@
 #include "simple_voice.h"
 #include <math.h>
 #include "env.h"
+#include "trace.h"
 
-#define TAU 6.2831853071795864769f
+#define SIMPLE_CHUNK 64  /* oscillator samples rendered ahead of the envelope */
+
+static const wt_shape_t s_shape[] = {
+    [SIMPLE_SINE] = WT_SINE, [SIMPLE_TRI] = WT_TRIANGLE, [SIMPLE_SQUARE] = WT_SQUARE
+};
 
 void simple_voice_init(simple_voice_t *v, float32_t sr)
 {
-    osc_reset(&v->osc);
+    v->phase = 0;
+    v->inc = 0;
     v->sr = sr;
     v->len = 0;
     v->pos = 0;
@@ -14,6 +20,9 @@ void simple_voice_init(simple_voice_t *v, float32_t sr)
     v->amp = 0.2f;
     v->wave = SIMPLE_SINE;
     v->freq = 440.0f;
+    v->env_tab = NULL;
+    v->env = 0.0f;
+    v->env_coef = 0.0f;
 }
 
 void simple_voice_trigger(simple_voice_t *v, float32_t freq, float32_t dur_sec, simple_wave_t wave, float32_t amp, float32_t decay)
@@ -22,57 +31,60 @@ void simple_voice_trigger(simple_voice_t *v, float32_t freq, float32_t dur_sec,
     v->wave = wave;
     v->amp  = amp;
     v->decay = decay;
+    v->inc = wavetable_inc(freq, v->sr);
     v->len = (uint32_t)(dur_sec * v->sr);
     v->pos = 0;
+    v->env_tab = env_table_get(ENV_SHAPE_EXP, decay, v->sr, v->len);
+    v->env = 1.0f;
+    v->env_coef = env_exp_coef(decay, v->sr);
+    TRACE_EMIT(TRACE_SIMPLE, wave, freq, dur_sec, amp, 0);
 }
 
-static inline float32_t render_sample(simple_voice_t *v)
+/* The waveform's table is picked once per call; the oscillator renders a
+   chunk at a time and the envelope is applied over it. */
+void simple_voice_process(simple_voice_t *v, float32_t *L, float32_t *R, uint32_t n)
 {
-    float32_t phase = v->osc.phase;
-    float32_t frac = phase / TAU; /* 0..1 */
-    float32_t s=0.0f;
-    switch(v->wave){
-        case SIMPLE_TRI:
-            s = 2.0f * fabsf(2.0f * frac - 1.0f) - 1.0f;
-            break;
-        case SIMPLE_SQUARE:
-            s = (frac < 0.5f) ? 1.0f : -1.0f;
-            break;
-        default: /* sine */
-            s = sinf(phase);
-            break;
+    if(v->pos >= v->len) return;
+    uint32_t count = v->len - v->pos;
+    if(count > n) count = n;
+    const float32_t *tab = wavetable_for(s_shape[v->wave], v->inc);
+    const float32_t amp = v->amp;
+    float32_t buf[SIMPLE_CHUNK];
+    for(uint32_t i = 0; i < count; i += SIMPLE_CHUNK){
+        const uint32_t m = count - i < SIMPLE_CHUNK ? count - i : SIMPLE_CHUNK;
+        wavetable_block(tab, &v->phase, v->inc, buf, m);
+        if(v->env_tab){
+            const float32_t *env = v->env_tab + v->pos + i;
+            for(uint32_t k = 0; k < m; k++){
+                float32_t s = buf[k] * (env[k] * amp);
+                L[i + k] += s;
+                R[i + k] += s;
+            }
+        } else {
+            float32_t env = v->env;
+            const float32_t coef = v->env_coef;
+            for(uint32_t k = 0; k < m; k++){
+                float32_t s = buf[k] * (env * amp);
+                L[i + k] += s;
+                R[i + k] += s;
+                env *= coef;
+            }
+            v->env = env;
+        }
     }
-    return s;
+    v->pos += count;
 }
 
-void simple_voice_process(simple_voice_t *v, float32_t *L, float32_t *R, uint32_t n)
+/* A table envelope is a function of pos; only the phase (and a recurrence
+   envelope) carries over. */
+void simple_voice_skip(simple_voice_t *v, uint32_t n)
 {
     if(v->pos >= v->len) return;
-    float32_t phase = v->osc.phase;
-    float32_t inc = TAU * v->freq / v->sr;
-    for(uint32_t i=0;i<n;++i){
-        if(v->pos >= v->len) break;
-        float32_t t = (float32_t)v->pos / v->sr;
-        float32_t env = env_exp_decay(t, v->decay);
-        float32_t sample;
-        float32_t frac = phase / TAU;
-        switch(v->wave){
-            case SIMPLE_TRI:
-                sample = (2.0f * fabsf(2.0f * frac - 1.0f) - 1.0f);
-                break;
-            case SIMPLE_SQUARE:
-                sample = (frac < 0.5f)?1.0f:-1.0f;
-                break;
-            default:
-                sample = sinf(phase);
-                break;
-        }
-        sample *= env * v->amp;
-        L[i]+=sample;
-        R[i]+=sample;
-        phase += inc;
-        if(phase>=TAU) phase -= TAU;
-        v->pos++;
-    }
-    v->osc.phase = phase;
-} 
\ No newline at end of file
+    uint32_t count = v->len - v->pos;
+    if(count > n) count = n;
+    v->phase += count * v->inc;  /* Q32: same as count single steps */
+    /* Stepped like process does so a skip lands on the same level */
+    if(!v->env_tab)
+        for(uint32_t i = 0; i < count; i++) v->env *= v->env_coef;
+    v->pos += count;
+}
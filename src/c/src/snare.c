@@ -1,5 +1,6 @@
 #include "snare.h"
 #include <math.h>
+#include "trace.h"
 
 #define SNARE_DECAY_RATE 35.0f
 #define SNARE_DUR_SEC 0.1f
@@ -20,6 +21,23 @@ void snare_trigger(snare_t *s)
     s->len = (uint32_t)(SNARE_DUR_SEC * s->sr);
     s->env = 1.0f;
     s->env_coef = expf(-SNARE_DECAY_RATE / s->sr);
+    TRACE_EMIT(TRACE_SNARE, 0, s->len, 0, 0, 0);
 }
 
+#ifndef DSP_DISPATCH /* x86: level-matched kernels in src/snare_x86.c */
+/* Envelope recurrence as in the kernel; the noise stream is one draw per
+   sample, so it jumps ahead in O(1). */
+void snare_skip(snare_t *s, uint32_t n)
+{
+    if(s->pos >= s->len) return;
+    uint32_t count = s->len - s->pos;
+    if(count > n) count = n;
+    float32_t env = s->env;
+    for(uint32_t i = 0; i < count; i++) env *= s->env_coef;
+    s->env = env;
+    rng_skip(&s->rng, count);
+    s->pos += count;
+}
+#endif
+
 /* NO snare_process - ASM implementation required */
@@ -0,0 +1,69 @@
+#include "snare.h"
+#include "fast_math_x86.h"
+
+/* x86-64 port of src/asm/active/snare.s: envelope recurrence + SplitMix64
+ * white noise, the stream snare.s draws inline.  Lanes compute it counter
+ * style (X86_NOISE), bit-identical to rng_float_mono() at every level, so a
+ * seed sounds the same on x86-64 and arm64. */
+#define SNARE_AMP 0.4f
+
+/* render = 0 advances the envelope and noise stream exactly as rendering
+ * would without writing any output (snare_skip). */
+static inline void snare_run(snare_t *s, float32_t *L, float32_t *R, uint32_t n, const int render)
+{
+    if (s->pos >= s->len || n == 0) return;
+
+    uint32_t count = s->len - s->pos;
+    if (count > n) count = n;
+
+    float32_t env = s->env;
+    const float32_t coef = s->env_coef;
+    uint32_t i = 0;
+
+#if X86_SIMD_WIDTH > 1
+    enum { W = X86_SIMD_WIDTH };
+    if (count >= W) {
+        float ramp[W];
+        x86_geom_ramp(ramp, env, coef, W);
+        float32_t coef_w = 1.0f;
+        for (int j = 0; j < W; ++j) coef_w *= coef;
+
+        vf_t ev = VF_LOAD(ramp);
+        vf_t last = ev;
+        const vf_t cwv = VF_SET1(coef_w), amp = VF_SET1(SNARE_AMP);
+        for (; i + W <= count; i += W) {
+            if (render) {
+                vf_t smp = VF_MUL(VF_MUL(X86_NOISE(&s->rng.state), ev), amp);
+                VF_STORE(L + i, VF_ADD(VF_LOAD(L + i), smp));
+                VF_STORE(R + i, VF_ADD(VF_LOAD(R + i), smp));
+            }
+            last = ev;
+            ev = VF_MUL(ev, cwv);
+        }
+        env = vf_last(last);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        env *= coef;
+        if (render) {
+            float32_t sample = rng_float_mono(&s->rng) * env * SNARE_AMP;
+            L[i] += sample;
+            R[i] += sample;
+        }
+    }
+
+    s->env = env;
+    if (!render) rng_skip(&s->rng, count);  /* one draw per sample */
+    s->pos += count;
+}
+
+void X86_KFN(snare_process)(snare_t *s, float32_t *L, float32_t *R, uint32_t n)
+{
+    snare_run(s, L, R, n, 1);
+}
+
+void X86_KFN(snare_skip)(snare_t *s, uint32_t n)
+{
+    snare_run(s, NULL, NULL, n, 0);
+}
@@ -21,8 +21,8 @@ int main(void) {
     printf("Delay struct address: %p\n", &g.delay);
     
     // Initialize kick exactly like gen_kick.c
-    kick_init(&g.kick, 44100.0f);
-    kick_trigger(&g.kick);
+    kick_init(&g.voices.kick[0], 44100.0f);
+    kick_trigger(&g.voices.kick[0]);
     
     // Create small buffers - use smaller blocks like gen_kick.c (256 samples)
     float L[256] = {0};
@@ -31,7 +31,7 @@ int main(void) {
     printf("About to call kick_process with 256 samples...\n");
     
     // Call kick_process with smaller block
-    kick_process(&g.kick, L, R, 256);
+    kick_process(&g.voices.kick[0], L, R, 256);
     
     printf("After kick_process: delay.buf=%p size=%u idx=%u\n", 
            g.delay.buf, g.delay.size, g.delay.idx);
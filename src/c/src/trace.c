@@ -0,0 +1,173 @@
+// Lock-free trace ring and its file drain thread (built with TRACE=1).
+//
+// The ring is a bounded multi-producer queue in the style of Vyukov's
+// MPMC array queue: every slot carries a sequence number that tells a
+// producer whether the slot is free for its ticket and tells the consumer
+// whether the record in it has been published.  Producers claim a ticket
+// with one CAS on `head`; a full ring makes trace_emit() drop the record
+// rather than wait, so the audio thread is never held up by the writer.
+// The single consumer is the drain thread, which batches records into
+// fwrite() calls every few milliseconds.
+#define _POSIX_C_SOURCE 200809L
+#include "trace.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TRACE_RING_SIZE  (1u << 16)
+#define TRACE_RING_MASK  (TRACE_RING_SIZE - 1)
+#define TRACE_BATCH      1024
+#define TRACE_DRAIN_NS   5000000L  /* 5 ms between drains */
+
+typedef struct {
+    _Atomic uint32_t seq;
+    trace_record_t rec;
+} trace_slot_t;
+
+static trace_slot_t ring[TRACE_RING_SIZE];
+static _Alignas(64) _Atomic uint32_t ring_head;   /* next ticket for producers */
+static _Alignas(64) uint32_t ring_tail;           /* consumer only */
+static _Alignas(64) _Atomic uint32_t ring_dropped;
+static _Atomic int trace_enabled;
+static _Atomic int writer_running;
+
+static pthread_t writer_thread;
+static FILE *trace_file;
+static uint64_t trace_count;
+
+static _Thread_local uint32_t cur_step, cur_sample;
+
+void trace_cursor(uint32_t step, uint32_t sample)
+{
+    cur_step = step;
+    cur_sample = sample;
+}
+
+void trace_emit(trace_type_t type, uint16_t aux,
+                float p0, float p1, float p2, float p3)
+{
+    if (!atomic_load_explicit(&trace_enabled, memory_order_relaxed)) return;
+
+    uint32_t pos = atomic_load_explicit(&ring_head, memory_order_relaxed);
+    trace_slot_t *slot;
+    for (;;) {
+        slot = &ring[pos & TRACE_RING_MASK];
+        uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int32_t dif = (int32_t)(seq - pos);
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring_head, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        } else if (dif < 0) {
+            atomic_fetch_add_explicit(&ring_dropped, 1, memory_order_relaxed);
+            return;
+        } else {
+            pos = atomic_load_explicit(&ring_head, memory_order_relaxed);
+        }
+    }
+
+    slot->rec.type = (uint16_t)type;
+    slot->rec.aux = aux;
+    slot->rec.step = cur_step;
+    slot->rec.sample = cur_sample;
+    slot->rec.seq = pos;
+    slot->rec.p[0] = p0;
+    slot->rec.p[1] = p1;
+    slot->rec.p[2] = p2;
+    slot->rec.p[3] = p3;
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+}
+
+/* Consumer side: move up to `max` published records into out[]. */
+static uint32_t ring_drain(trace_record_t *out, uint32_t max)
+{
+    uint32_t n = 0;
+    while (n < max) {
+        trace_slot_t *slot = &ring[ring_tail & TRACE_RING_MASK];
+        uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (seq != ring_tail + 1) break;
+        out[n++] = slot->rec;
+        atomic_store_explicit(&slot->seq, ring_tail + TRACE_RING_SIZE, memory_order_release);
+        ring_tail++;
+    }
+    return n;
+}
+
+static void drain_to_file(void)
+{
+    static trace_record_t batch[TRACE_BATCH];
+    uint32_t n;
+    while ((n = ring_drain(batch, TRACE_BATCH)) > 0) {
+        fwrite(batch, sizeof(trace_record_t), n, trace_file);
+        trace_count += n;
+    }
+}
+
+static void *writer_main(void *arg)
+{
+    (void)arg;
+    struct timespec ts = { 0, TRACE_DRAIN_NS };
+    while (atomic_load_explicit(&writer_running, memory_order_acquire)) {
+        drain_to_file();
+        nanosleep(&ts, NULL);
+    }
+    return NULL;
+}
+
+static void write_header(void)
+{
+    trace_file_header_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TRACE_MAGIC, sizeof(h.magic));
+    h.version = TRACE_VERSION;
+    h.record_size = sizeof(trace_record_t);
+    h.count = trace_count;
+    h.dropped = atomic_load(&ring_dropped);
+    fwrite(&h, sizeof(h), 1, trace_file);
+}
+
+int trace_start(const char *path)
+{
+    if (trace_file) return 0;
+    if (!path) path = getenv("NDB_TRACE_FILE");
+    if (!path) path = "trace.bin";
+    trace_file = fopen(path, "wb");
+    if (!trace_file) { perror(path); return -1; }
+
+    for (uint32_t i = 0; i < TRACE_RING_SIZE; i++)
+        atomic_store_explicit(&ring[i].seq, i, memory_order_relaxed);
+    atomic_store(&ring_head, 0);
+    ring_tail = 0;
+    atomic_store(&ring_dropped, 0);
+    trace_count = 0;
+    write_header(); /* placeholder, rewritten with the totals on stop */
+
+    atomic_store(&writer_running, 1);
+    if (pthread_create(&writer_thread, NULL, writer_main, NULL) != 0) {
+        fclose(trace_file);
+        trace_file = NULL;
+        return -1;
+    }
+    atomic_store_explicit(&trace_enabled, 1, memory_order_release);
+    return 0;
+}
+
+void trace_stop(void)
+{
+    if (!trace_file) return;
+    atomic_store_explicit(&trace_enabled, 0, memory_order_release);
+    atomic_store_explicit(&writer_running, 0, memory_order_release);
+    pthread_join(writer_thread, NULL);
+    drain_to_file();
+
+    rewind(trace_file);
+    write_header();
+    fclose(trace_file);
+    trace_file = NULL;
+    if (atomic_load(&ring_dropped))
+        fprintf(stderr, "trace: %u records dropped (ring full)\n", atomic_load(&ring_dropped));
+}
@@ -0,0 +1,50 @@
+// trace_dump – print a binary trace written by a TRACE=1 build.
+//
+// Usage: trace_dump [trace.bin]
+#include "trace.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *type_name(uint16_t type)
+{
+    switch (type) {
+    case TRACE_KICK:       return "KICK";
+    case TRACE_SNARE:      return "SNARE";
+    case TRACE_HAT:        return "HAT";
+    case TRACE_MELODY:     return "MELODY";
+    case TRACE_FM:         return "FM";
+    case TRACE_SIMPLE:     return "SIMPLE";
+    case TRACE_STEP_EVENT: return "EVENT";
+    case TRACE_STEP_END:   return "STEP_END";
+    case TRACE_BLOCK:      return "BLOCK";
+    default:               return "?";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : "trace.bin";
+    FILE *f = fopen(path, "rb");
+    if (!f) { perror(path); return 1; }
+
+    trace_file_header_t h;
+    if (fread(&h, sizeof(h), 1, f) != 1 || memcmp(h.magic, TRACE_MAGIC, sizeof(h.magic)) != 0 ||
+        h.version != TRACE_VERSION || h.record_size != sizeof(trace_record_t)) {
+        fprintf(stderr, "%s: not a version %u trace file\n", path, TRACE_VERSION);
+        fclose(f);
+        return 1;
+    }
+
+    trace_record_t r;
+    uint64_t n = 0;
+    while (fread(&r, sizeof(r), 1, f) == 1) {
+        printf("%8u step=%-3u sample=%-7u %-8s aux=%-3u %g %g %g %g\n",
+               r.seq, r.step, r.sample, type_name(r.type), r.aux,
+               r.p[0], r.p[1], r.p[2], r.p[3]);
+        n++;
+    }
+    fclose(f);
+    fprintf(stderr, "%llu records (%llu in header), %llu dropped\n",
+            (unsigned long long)n, (unsigned long long)h.count, (unsigned long long)h.dropped);
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "voice_pool.h"
+#include <math.h>
+#include <string.h>
+
+#define VOICE_POOL_FLOOR 1e-30f  /* level/coef floor, keeps the logs finite */
+
+void voice_pool_init(voice_pool_t *p, uint32_t cap, voice_steal_t steal)
+{
+    memset(p, 0, sizeof(*p));
+    p->cap = (uint8_t)(cap < 1 ? 1 : cap > VOICE_POOL_MAX ? VOICE_POOL_MAX : cap);
+    p->steal = (uint8_t)steal;
+}
+
+void voice_pool_reset(voice_pool_t *p)
+{
+    voice_pool_init(p, p->cap, (voice_steal_t)p->steal);
+}
+
+/* Drop live[i], keeping the rest in trigger order. */
+static void pool_remove(voice_pool_t *p, uint32_t i)
+{
+    p->used &= ~(1u << p->live[i]);
+    p->count--;
+    memmove(&p->live[i], &p->live[i + 1], p->count - i);
+}
+
+static uint32_t pool_victim(const voice_pool_t *p)
+{
+    if(p->steal != VOICE_STEAL_QUIETEST) return 0;
+    uint32_t best = 0;
+    float32_t best_level = INFINITY;
+    for(uint32_t i = 0; i < p->count; i++){
+        const uint8_t s = p->live[i];
+        float32_t level = p->log_amp[s] + p->log_coef[s] * (float32_t)(p->clock - p->start[s]);
+        if(level < best_level){
+            best_level = level;
+            best = i;
+        }
+    }
+    return best;
+}
+
+int voice_pool_alloc(voice_pool_t *p)
+{
+    if(p->count == p->cap){
+        pool_remove(p, pool_victim(p));
+        p->steals++;
+    }
+    const int slot = __builtin_ctz(~p->used);
+    p->used |= 1u << slot;
+    p->live[p->count++] = (uint8_t)slot;
+    /* Placeholder until voice_pool_start: silent, ends now */
+    p->start[slot] = p->end[slot] = p->clock;
+    p->log_amp[slot] = logf(VOICE_POOL_FLOOR);
+    p->log_coef[slot] = 0.0f;
+    return slot;
+}
+
+void voice_pool_start(voice_pool_t *p, int slot, uint32_t len,
+                      float32_t amp, float32_t coef)
+{
+    p->start[slot] = p->clock;
+    p->end[slot] = p->clock + len;
+    p->log_amp[slot] = logf(amp > VOICE_POOL_FLOOR ? amp : VOICE_POOL_FLOOR);
+    p->log_coef[slot] = logf(coef > VOICE_POOL_FLOOR ? coef : VOICE_POOL_FLOOR);
+    if(len == 0) voice_pool_advance(p, 0);
+}
+
+void voice_pool_advance(voice_pool_t *p, uint32_t n)
+{
+    p->clock += n;
+    uint32_t j = 0;
+    for(uint32_t i = 0; i < p->count; i++){
+        const uint8_t s = p->live[i];
+        if((int32_t)(p->end[s] - p->clock) > 0) p->live[j++] = s;
+        else p->used &= ~(1u << s);
+    }
+    p->count = (uint8_t)j;
+}
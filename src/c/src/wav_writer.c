@@ -2,46 +2,155 @@
 #include <stdio.h>
 #include <string.h>
 
+#define WAV_STREAM_BUF (1u << 16)   /* stdio buffer for appends */
+
+#define WAV_FORMAT_PCM        1
+#define WAV_FORMAT_FLOAT      3
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE
+
+/* KSDATAFORMAT_SUBTYPE_* after the two-byte format tag */
+static const uint8_t wav_subformat_tail[14] = {
+    0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71
+};
+
 static void write_le32(FILE *f, uint32_t v) { fwrite(&v, 4, 1, f); }
 static void write_le16(FILE *f, uint16_t v) { fwrite(&v, 2, 1, f); }
 
-void write_wav(const char *path,
-               const int16_t *samples,
-               uint32_t frames,
-               uint16_t num_channels,
-               uint32_t sample_rate)
+/* Speaker positions for the extensible header: front centre for mono,
+ * then the first num_channels positions in WAVE order */
+static uint32_t channel_mask(uint16_t num_channels)
 {
-    FILE *f = fopen(path, "wb");
-    if (!f) {
-        perror("write_wav: fopen");
-        return;
-    }
+    if (num_channels == 1) return 0x4;
+    return num_channels < 18 ? (1u << num_channels) - 1 : 0;
+}
 
-    uint16_t bits_per_sample = 16;
+/* Write the header for `frames` frames and record in `s` where the sizes
+ * that wav_stream_close patches live.  16-bit mono/stereo PCM gets the
+ * plain 16-byte fmt chunk; more bits or channels need
+ * WAVE_FORMAT_EXTENSIBLE, and float (not PCM) a fact chunk. */
+static void write_header(wav_stream_t *s, pcm_format_t format, uint16_t num_channels,
+                         uint32_t sample_rate, uint32_t frames)
+{
+    FILE *f = s->f;
+    uint16_t bits_per_sample = (uint16_t)(pcm_sample_bytes(format) * 8);
     uint32_t byte_rate = sample_rate * num_channels * bits_per_sample / 8;
     uint16_t block_align = num_channels * bits_per_sample / 8;
     uint32_t data_chunk_size = frames * block_align;
-    uint32_t riff_size = 4 + 8 + 16 + 8 + data_chunk_size; // WAVE + fmt + data
+    uint16_t tag = format == PCM_F32 ? WAV_FORMAT_FLOAT : WAV_FORMAT_PCM;
+    int extensible = bits_per_sample > 16 || num_channels > 2;
+    int fact = format == PCM_F32;
+    uint32_t fmt_size = extensible ? 40 : 16;
+
+    s->header_bytes = 12 + 8 + fmt_size + (fact ? 12 : 0) + 8;
+    s->fact_offset = fact ? 12 + 8 + fmt_size + 8 : 0;
 
     /* RIFF header */
     fwrite("RIFF", 1, 4, f);
-    write_le32(f, riff_size);
+    write_le32(f, s->header_bytes - 8 + data_chunk_size);
     fwrite("WAVE", 1, 4, f);
 
     /* fmt  sub-chunk */
     fwrite("fmt ", 1, 4, f);
-    write_le32(f, 16);                 // PCM header size
-    write_le16(f, 1);                  // AudioFormat = PCM
+    write_le32(f, fmt_size);
+    write_le16(f, extensible ? WAV_FORMAT_EXTENSIBLE : tag);
     write_le16(f, num_channels);
     write_le32(f, sample_rate);
     write_le32(f, byte_rate);
     write_le16(f, block_align);
     write_le16(f, bits_per_sample);
+    if (extensible) {
+        write_le16(f, 22);                 // cbSize
+        write_le16(f, bits_per_sample);    // valid bits
+        write_le32(f, channel_mask(num_channels));
+        write_le16(f, tag);                // SubFormat GUID
+        fwrite(wav_subformat_tail, 1, sizeof wav_subformat_tail, f);
+    }
+
+    /* fact sub-chunk: frames per channel */
+    if (fact) {
+        fwrite("fact", 1, 4, f);
+        write_le32(f, 4);
+        write_le32(f, frames);
+    }
 
     /* data sub-chunk */
     fwrite("data", 1, 4, f);
     write_le32(f, data_chunk_size);
-    fwrite(samples, block_align, frames, f);
+}
+
+void write_wav(const char *path,
+               const int16_t *samples,
+               uint32_t frames,
+               uint16_t num_channels,
+               uint32_t sample_rate)
+{
+    wav_stream_t s;
+    if (wav_stream_open(&s, path, num_channels, sample_rate) != 0) return;
+    wav_stream_append(&s, samples, frames);
+    wav_stream_close(&s);
+}
 
-    fclose(f);
-} 
\ No newline at end of file
+int wav_stream_open(wav_stream_t *s, const char *path, uint16_t num_channels, uint32_t sample_rate)
+{
+    return wav_stream_open_format(s, path, num_channels, sample_rate, PCM_S16);
+}
+
+int wav_stream_open_format(wav_stream_t *s, const char *path, uint16_t num_channels, uint32_t sample_rate,
+                           pcm_format_t format)
+{
+    memset(s, 0, sizeof(*s));
+    s->f = fopen(path, "wb");
+    if (!s->f) {
+        perror("wav_stream_open: fopen");
+        return -1;
+    }
+    setvbuf(s->f, NULL, _IOFBF, WAV_STREAM_BUF);
+    s->num_channels = num_channels;
+    s->block_align = (uint16_t)(num_channels * pcm_sample_bytes(format));
+    write_header(s, format, num_channels, sample_rate, 0);  /* sizes patched on close */
+    if (ferror(s->f)) {
+        perror("wav_stream_open: write");
+        fclose(s->f);
+        s->f = NULL;
+        s->error = 1;
+        return -1;
+    }
+    return 0;
+}
+
+int wav_stream_append(wav_stream_t *s, const void *samples, uint32_t frames)
+{
+    if (s->error) return -1;
+    const uint32_t max_frames = (UINT32_MAX - (s->header_bytes - 8)) / s->block_align;
+    if (frames > max_frames - s->frames) {
+        fprintf(stderr, "wav_stream_append: past the 4 GiB RIFF limit\n");
+        s->error = 1;
+        return -1;
+    }
+    if (fwrite(samples, s->block_align, frames, s->f) != frames) {
+        perror("wav_stream_append: fwrite");
+        s->error = 1;
+        return -1;
+    }
+    s->frames += frames;
+    return 0;
+}
+
+int wav_stream_close(wav_stream_t *s)
+{
+    if (!s->f) return -1;
+    const uint32_t data_chunk_size = s->frames * s->block_align;
+    if (fseek(s->f, 4, SEEK_SET) == 0) write_le32(s->f, s->header_bytes - 8 + data_chunk_size);
+    if (s->fact_offset && fseek(s->f, s->fact_offset, SEEK_SET) == 0) write_le32(s->f, s->frames);
+    if (fseek(s->f, s->header_bytes - 4, SEEK_SET) == 0) write_le32(s->f, data_chunk_size);
+    if (ferror(s->f)) {
+        perror("wav_stream_close: write");
+        s->error = 1;
+    }
+    if (fclose(s->f) != 0) {
+        perror("wav_stream_close: fclose");
+        s->error = 1;
+    }
+    s->f = NULL;
+    return s->error ? -1 : 0;
+}
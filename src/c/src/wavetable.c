@@ -0,0 +1,74 @@
+#include "wavetable.h"
+#include <math.h>
+#include <pthread.h>
+
+#define WT_PI 3.14159265358979323846
+
+static _Alignas(64) float32_t s_tables[WT_SHAPE_COUNT - 1][WT_LEVELS][WT_STRIDE];
+static _Alignas(64) float32_t s_sine[WT_STRIDE];
+static pthread_once_t s_once = PTHREAD_ONCE_INIT;
+
+/* Amplitude of harmonic h (sine phase; the triangle's are cosines). */
+static double wt_harmonic(wt_shape_t shape, uint32_t h)
+{
+    switch(shape){
+        case WT_SAW:      return -2.0 / (WT_PI * h);
+        case WT_SQUARE:   return (h & 1) ? 4.0 / (WT_PI * h) : 0.0;
+        case WT_TRIANGLE: return (h & 1) ? 8.0 / (WT_PI * WT_PI * h * h) : 0.0;
+        default:          return h == 1 ? 1.0 : 0.0;
+    }
+}
+
+static void wt_store(float32_t *dst, const double *acc)
+{
+    for(uint32_t i = 0; i < WT_LEN; i++) dst[i] = (float32_t)acc[i];
+    dst[WT_LEN] = dst[0];
+}
+
+/* Sum the series harmonic by harmonic, snapshotting each level as its
+   harmonic count is reached (level WT_LEVELS-1 first, at one harmonic). */
+static void wt_build(void)
+{
+    static double sintab[WT_LEN], acc[WT_LEN];
+    for(uint32_t i = 0; i < WT_LEN; i++) sintab[i] = sin(2.0 * WT_PI * i / WT_LEN);
+    for(uint32_t i = 0; i < WT_LEN; i++) acc[i] = sintab[i];
+    wt_store(s_sine, acc);
+
+    for(int shape = WT_SAW; shape < WT_SHAPE_COUNT; shape++){
+        const uint32_t quarter = shape == WT_TRIANGLE ? WT_LEN / 4 : 0;  /* sin -> cos */
+        int level = WT_LEVELS - 1;
+        for(uint32_t i = 0; i < WT_LEN; i++) acc[i] = 0.0;
+        for(uint32_t h = 1; h <= WT_MAX_HARMONICS; h++){
+            const double a = wt_harmonic((wt_shape_t)shape, h);
+            if(a != 0.0)
+                for(uint32_t i = 0; i < WT_LEN; i++)
+                    acc[i] += a * sintab[(h * i + quarter) & (WT_LEN - 1)];
+            if(h == WT_MAX_HARMONICS >> level)
+                wt_store(s_tables[shape - 1][level--], acc);
+        }
+    }
+}
+
+void wavetable_init(void)
+{
+    pthread_once(&s_once, wt_build);
+}
+
+const float32_t *wavetable_for(wt_shape_t shape, uint32_t inc)
+{
+    wavetable_init();
+    if(shape == WT_SINE || shape >= WT_SHAPE_COUNT) return s_sine;
+    /* Lowest level whose top harmonic, (WT_MAX_HARMONICS >> level)·inc,
+       stays at or below Nyquist (2^31) */
+    uint32_t level = 0;
+    while(level < WT_LEVELS - 1 && (uint64_t)(WT_MAX_HARMONICS >> level) * inc > (1ull << 31))
+        level++;
+    return s_tables[shape - 1][level];
+}
+
+#ifndef DSP_DISPATCH /* x86: SIMD kernels in src/wavetable_x86.c */
+void wavetable_block(const float32_t *tab, uint32_t *phase, uint32_t inc, float32_t *out, uint32_t n)
+{
+    wavetable_block_ref(tab, phase, inc, out, n);
+}
+#endif
@@ -0,0 +1,29 @@
+#include "wavetable.h"
+#include "fast_math_x86.h"
+
+/* x86-64 wavetable_block (same contract as wavetable.c).  The Q32 phase of
+ * lane j is phase + j·inc, exact in integer arithmetic, so the vector body
+ * and the scalar tail interpolate the same points the same way and the
+ * output does not depend on where a block starts. */
+void X86_KFN(wavetable_block)(const float32_t *tab, uint32_t *phase, uint32_t inc, float32_t *out, uint32_t n)
+{
+    uint32_t ph = *phase;
+    uint32_t i = 0;
+#if X86_SIMD_WIDTH > 1
+    enum { W = X86_SIMD_WIDTH };
+    uint32_t lane[W];
+    for (uint32_t j = 0; j < W; ++j) lane[j] = j * inc;
+    const vi_t lanev = VI_LOAD(lane);
+    const vi_t fmask = VI_SET1((1u << WT_FRAC_BITS) - 1);
+    const vf_t scalev = VF_SET1(1.0f / (float32_t)(1u << WT_FRAC_BITS));
+    for (; i + W <= n; i += W, ph += W * inc) {
+        vi_t p = VI_ADD(VI_SET1(ph), lanev);
+        vi_t j = VI_SRL(p, WT_FRAC_BITS);
+        vf_t f = VF_MUL(VI_TO_F(VI_AND(p, fmask)), scalev);
+        vf_t a = vf_gather(tab, j), b = vf_gather(tab + 1, j);
+        VF_STORE(out + i, VF_ADD(a, VF_MUL(f, VF_SUB(b, a))));
+    }
+#endif
+    wavetable_block_ref(tab, &ph, inc, out + i, n - i);
+    *phase = ph;
+}
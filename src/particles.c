@@ -3,6 +3,8 @@
 #include <string.h>
 #include <math.h>
 #include "../include/visual_types.h"
+#include "../include/wav_reader.h"
+#include "event_queue.h"
 
 #define MAX_PARTICLES 256
 #define PARTICLE_SPAWN_COUNT 20
@@ -44,8 +46,12 @@ void init_particles(void) {
     particles_initialized = true;
 }
 
-// Check if step is a saw step (particle explosion trigger)
+// Check if step is a saw step (particle explosion trigger): a melody note
+// in the renderer's sidecar, else the fixed pattern
 static bool is_saw_step(int step) {
+    int events = get_audio_step_events(step, EVT_MELODY);
+    if (events >= 0) return events > 0;
+    
     int step32 = step % 32;  // 2-bar cycle (32 sixteenth-notes)
     for (int i = 0; i < SAW_STEPS_COUNT; i++) {
         if (step32 == SAW_STEPS[i]) {
@@ -100,8 +106,10 @@ static void spawn_explosion(float cx, float cy, float base_hue) {
 void update_particles(float elapsed_ms, float step_sec, float base_hue) {
     if (!particles_initialized) return;
     
-    // Calculate current step for explosion timing
-    int current_step = (int)(elapsed_ms / 1000.0f / step_sec) % 32;
+    // Calculate current step for explosion timing: from the playback
+    // position when the sidecar gives the step length, else from the clock
+    int current_step = get_audio_step();
+    if (current_step < 0) current_step = (int)(elapsed_ms / 1000.0f / step_sec) % 32;
     
     // Spawn explosion if we hit a saw step and it's different from last step
     if (is_saw_step(current_step) && current_step != last_step) {
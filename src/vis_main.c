@@ -6,6 +6,7 @@
 #include <math.h>
 #include "../include/audio_bridge.h"
 #include "../include/visual_types.h"
+#include "../include/wav_reader.h"
 
 // Forward declarations
 void clear_frame(uint32_t *pixels, uint32_t color);
@@ -22,15 +23,6 @@ void update_glitch_intensity(float new_intensity);
 void init_bass_hits(void);
 void update_bass_hits(float elapsed_ms, float step_sec, float base_hue, uint32_t seed);
 void draw_bass_hits(uint32_t *pixels, int frame);
-bool load_wav_file(const char *filename);
-float get_audio_rms_for_frame(int frame);
-float get_audio_bpm(void);
-float get_max_rms(void);
-bool is_audio_finished(int frame);
-void print_audio_info(void);
-void cleanup_audio_data(void);
-void start_audio_playback(void);
-void stop_audio_playback(void);
 
 #define FRAME_TIME_MS (1000 / VIS_FPS)
 
@@ -101,7 +93,7 @@ static bool init_sdl(void) {
     }
     
     // Initialize visual system with real audio parameters
-    ctx.visual.seed = 0xcafebabe;  // Match the WAV file seed
+    ctx.visual.seed = get_audio_seed(0xcafebabe);  // Match the WAV file seed (from its sidecar)
     ctx.visual.frame = 0;
     ctx.visual.time = 0.0f;
     ctx.visual.step_sec = 60.0f / ctx.visual.bpm / 4.0f;  // 16th note duration
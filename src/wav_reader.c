@@ -3,35 +3,41 @@
 #include <stdint.h>
 #include <string.h>
 #include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <SDL2/SDL.h>
 #include "../include/visual_types.h"
+#include "../include/wav_reader.h"
+#include "resampler.h"
+#include "seg_sidecar.h"
 
-// WAV file header structure
-typedef struct {
-    char riff[4];           // "RIFF"
-    uint32_t chunk_size;    // File size - 8
-    char wave[4];           // "WAVE"
-    char fmt[4];            // "fmt "
-    uint32_t fmt_size;      // Format chunk size
-    uint16_t audio_format;  // Audio format (1 = PCM)
-    uint16_t num_channels;  // Number of channels
-    uint32_t sample_rate;   // Sample rate
-    uint32_t byte_rate;     // Byte rate
-    uint16_t block_align;   // Block align
-    uint16_t bits_per_sample; // Bits per sample
-    char data[4];           // "data"
-    uint32_t data_size;     // Data size
-} wav_header_t;
+// WAV format tags (fmt chunk)
+#define WAV_FORMAT_PCM        1
+#define WAV_FORMAT_FLOAT      3
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE
+
+// Sample encodings the player reads straight from the mapped file
+typedef enum {
+    WAV_S16,
+    WAV_S24,
+    WAV_F32
+} wav_encoding_t;
 
 // Audio analysis data
 typedef struct {
-    int16_t *samples;       // Raw audio samples (stereo interleaved)
+    void *map;              // Whole file, mapped read-only
+    size_t map_size;
+    const uint8_t *data;    // Sample data inside the map (stereo interleaved)
+    wav_encoding_t encoding;
+    uint16_t bytes_per_sample;
     uint32_t sample_count;  // Total samples (left + right)
-    uint32_t sample_rate;   // Sample rate (44100)
+    uint32_t sample_rate;   // File sample rate
     uint16_t channels;      // Number of channels (2 for stereo)
-    uint16_t bits_per_sample; // Bits per sample (16)
+    uint16_t bits_per_sample;
     
-    // Analysis data
+    // Analysis data, filled by the analysis thread (see rms_thread_main)
     float *rms_levels;      // RMS levels per video frame
     uint32_t num_frames;    // Number of video frames
     float duration_sec;     // Total duration in seconds
@@ -41,151 +47,311 @@ typedef struct {
 static audio_data_t audio_data = {0};
 static bool audio_loaded = false;
 static SDL_AudioDeviceID audio_device = 0;
-static uint32_t audio_position = 0; // Current playback position in samples
+static uint32_t audio_position = 0; // Current playback position in file samples
 static uint32_t loop_point_samples = 0; // Where to loop back to (before delay tail)
 static uint32_t musical_content_samples = 0; // Length of actual musical content
 
+// The renderer's analysis sidecar (seg_sidecar.h), when one sits next to the
+// WAV: RMS per video frame, the segment's events, BPM, seed and loop length
+// come from it and nothing is analysed here.
+static seg_sidecar_t sidecar;
+static bool have_sidecar = false;
+
+// Without a sidecar, per-frame RMS is computed in the background, front to back, so the file
+// is playable as soon as it is mapped.  rms_ready counts the finished
+// frames (SDL_AtomicSet is a full barrier: rms_levels[0 .. rms_ready) are
+// visible once the count is); frames past it are computed on the spot.
+static SDL_Thread *rms_thread = NULL;
+static SDL_atomic_t rms_ready;
+static SDL_atomic_t rms_stop;
+static uint32_t max_rms_scanned = 0;   // rms_levels[0 .. this) folded into max_rms_seen
+static float max_rms_seen = 0.0f;
+
+// Device-rate conversion, streamed in the callback when the device
+// does not run at the file's rate
+#define PLAYBACK_RS_BLOCK 512
+static resampler_t playback_rs;
+static bool playback_rs_active = false;
+static float *rs_in = NULL;        // PLAYBACK_RS_BLOCK frames, L then R
+static float *rs_out = NULL;       // rs_out_cap frames, L then R
+static uint32_t rs_out_cap = 0;
+static uint32_t rs_out_count = 0;  // converted frames waiting in rs_out
+static uint32_t rs_out_pos = 0;
+
+// Sample i (interleaved) of the mapped data, in -1..1
+static inline float sample_at(uint32_t i) {
+    const uint8_t *p = audio_data.data + (size_t)i * audio_data.bytes_per_sample;
+    switch (audio_data.encoding) {
+    case WAV_S16: {
+        int16_t v;
+        memcpy(&v, p, 2);
+        return v / 32768.0f;
+    }
+    case WAV_S24: {
+        int32_t v = (int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) >> 8;
+        return v / 8388608.0f;
+    }
+    default: {
+        float v;
+        memcpy(&v, p, 4);
+        return v;
+    }
+    }
+}
+
+static inline int16_t to_s16(float x) {
+    return (int16_t)(fminf(fmaxf(x, -1.0f), 32767.0f / 32768.0f) * 32768.0f);
+}
+
+// Next `samples` interleaved samples of the loop as 16-bit, from audio_position
+static void next_source_s16(int16_t *out, uint32_t samples) {
+    while (samples > 0) {
+        if (audio_position >= musical_content_samples) {
+            // Loop back to the beginning when musical content ends
+            audio_position = loop_point_samples;
+        }
+        uint32_t run = musical_content_samples - audio_position;
+        if (run > samples) run = samples;
+        if (audio_data.encoding == WAV_S16) {
+            memcpy(out, audio_data.data + (size_t)audio_position * 2, (size_t)run * 2);
+        } else {
+            for (uint32_t i = 0; i < run; i++) out[i] = to_s16(sample_at(audio_position + i));
+        }
+        out += run;
+        samples -= run;
+        audio_position += run;
+    }
+}
+
+// Next `frames` stereo frames of the loop as planar float, from audio_position
+static void next_source_float(float *L, float *R, uint32_t frames) {
+    for (uint32_t i = 0; i < frames; i++) {
+        if (audio_position >= musical_content_samples) audio_position = loop_point_samples;
+        L[i] = sample_at(audio_position);
+        R[i] = sample_at(audio_position + 1);
+        audio_position += 2;
+    }
+}
+
 // Audio callback function for SDL2 with seamless looping
 static void audio_callback(void *userdata, Uint8 *stream, int len) {
     (void)userdata; // Unused
     
-    if (!audio_loaded) {
+    if (!audio_loaded || musical_content_samples < 2) {
         memset(stream, 0, len);
         return;
     }
     
-    int samples_needed = len / sizeof(int16_t);
     int16_t *output = (int16_t *)stream;
+    uint32_t frames = (uint32_t)len / (2 * sizeof(int16_t));
+    if (!playback_rs_active) {
+        next_source_s16(output, frames * 2);
+        return;
+    }
     
-    for (int i = 0; i < samples_needed; i++) {
-        if (audio_position < musical_content_samples) {
-            // Normal playback of musical content
-            output[i] = audio_data.samples[audio_position];
-            audio_position++;
-        } else {
-            // Loop back to the beginning when musical content ends
-            audio_position = loop_point_samples;
-            output[i] = audio_data.samples[audio_position];
-            audio_position++;
+    while (frames > 0) {
+        if (rs_out_pos == rs_out_count) {
+            next_source_float(rs_in, rs_in + PLAYBACK_RS_BLOCK, PLAYBACK_RS_BLOCK);
+            rs_out_count = resampler_process(&playback_rs, rs_in, rs_in + PLAYBACK_RS_BLOCK, PLAYBACK_RS_BLOCK,
+                                             rs_out, rs_out + rs_out_cap);
+            rs_out_pos = 0;
+            continue;
+        }
+        uint32_t run = rs_out_count - rs_out_pos;
+        if (run > frames) run = frames;
+        for (uint32_t i = 0; i < run; i++) {
+            output[2*i]   = to_s16(rs_out[rs_out_pos + i]);
+            output[2*i+1] = to_s16(rs_out[rs_out_cap + rs_out_pos + i]);
         }
+        output += 2 * run;
+        frames -= run;
+        rs_out_pos += run;
     }
 }
 
-// Load WAV file and extract audio data
-bool load_wav_file(const char *filename) {
-    FILE *file = fopen(filename, "rb");
-    if (!file) {
-        printf("Error: Could not open WAV file: %s\n", filename);
+// Set up streaming conversion to the device rate (buffers are per block,
+// not per file)
+static bool start_playback_resampler(uint32_t to_rate) {
+    if (resampler_init(&playback_rs, audio_data.sample_rate, to_rate) != 0) {
+        printf("Warning: No converter from %u Hz to %u Hz\n", audio_data.sample_rate, to_rate);
         return false;
     }
-    
-    wav_header_t header;
-    size_t read_bytes = fread(&header, sizeof(header), 1, file);
-    if (read_bytes != 1) {
-        printf("Error: Could not read WAV header\n");
-        fclose(file);
+    rs_out_cap = resampler_max_out(&playback_rs, PLAYBACK_RS_BLOCK);
+    rs_in = malloc(sizeof(float) * PLAYBACK_RS_BLOCK * 2);
+    rs_out = malloc(sizeof(float) * rs_out_cap * 2);
+    if (!rs_in || !rs_out) {
+        free(rs_in); free(rs_out);
+        rs_in = rs_out = NULL;
+        resampler_free(&playback_rs);
         return false;
     }
+    rs_out_count = rs_out_pos = 0;
+    playback_rs_active = true;
+    return true;
+}
+
+// RMS of video frame `frame` from the mapped samples
+static float compute_frame_rms(uint32_t frame) {
+    uint32_t samples_per_frame = audio_data.sample_rate / VIS_FPS;
+    uint64_t start_sample = (uint64_t)frame * samples_per_frame * audio_data.channels;
+    uint64_t end_sample = start_sample + (uint64_t)samples_per_frame * audio_data.channels;
     
-    // Validate WAV header
-    if (strncmp(header.riff, "RIFF", 4) != 0 || 
-        strncmp(header.wave, "WAVE", 4) != 0 ||
-        strncmp(header.fmt, "fmt ", 4) != 0 ||
-        strncmp(header.data, "data", 4) != 0) {
-        printf("Error: Invalid WAV file format\n");
-        fclose(file);
-        return false;
+    if (end_sample > audio_data.sample_count) {
+        end_sample = audio_data.sample_count;
     }
+    if (start_sample >= end_sample) return 0.0f;
     
-    // Store audio parameters
-    audio_data.sample_rate = header.sample_rate;
-    audio_data.channels = header.num_channels;
-    audio_data.bits_per_sample = header.bits_per_sample;
-    audio_data.sample_count = header.data_size / (header.bits_per_sample / 8);
-    audio_data.duration_sec = (float)audio_data.sample_count / header.num_channels / header.sample_rate;
-    
-    printf("WAV Info: %d Hz, %d channels, %d bits, %.2f seconds\n", 
-           audio_data.sample_rate, audio_data.channels, 
-           audio_data.bits_per_sample, audio_data.duration_sec);
-    
-    // Only support 16-bit stereo for now
-    if (header.bits_per_sample != 16 || header.num_channels != 2) {
-        printf("Error: Only 16-bit stereo WAV files supported\n");
-        fclose(file);
+    float sum_squares = 0.0f;
+    for (uint64_t i = start_sample; i < end_sample; i++) {
+        float sample = sample_at((uint32_t)i);
+        sum_squares += sample * sample;
+    }
+    return sqrtf(sum_squares / (float)(end_sample - start_sample));
+}
+
+// Analysis thread: every frame's RMS, front to back (the playhead starts at
+// frame 0 too, so this runs ahead of it)
+static int rms_thread_main(void *arg) {
+    (void)arg;
+    for (uint32_t frame = 0; frame < audio_data.num_frames; frame++) {
+        if (SDL_AtomicGet(&rms_stop)) break;
+        audio_data.rms_levels[frame] = compute_frame_rms(frame);
+        SDL_AtomicSet(&rms_ready, (int)(frame + 1));
+    }
+    return 0;
+}
+
+// RMS of one video frame: the analysis thread's value once it has got that
+// far, else computed now
+static float frame_rms(uint32_t frame) {
+    if (have_sidecar) {
+        uint64_t i = (uint64_t)frame * sidecar.hdr->fps / VIS_FPS;
+        if (i < sidecar.hdr->rms_count) return sidecar.rms[i];
+    } else if (frame < (uint32_t)SDL_AtomicGet(&rms_ready)) {
+        return audio_data.rms_levels[frame];
+    }
+    float rms = compute_frame_rms(frame);
+    if (rms > max_rms_seen) max_rms_seen = rms;
+    return rms;
+}
+
+// Map a WAV file and walk its RIFF chunks: fmt and data are found wherever
+// they sit, with unknown chunks (LIST, fact, ...) skipped.  Fills the format
+// fields and audio_data.data; false (with a message) if the file cannot be
+// played.
+static bool map_wav_file(const char *filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        printf("Error: Could not open WAV file: %s\n", filename);
         return false;
     }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 12) {
+        printf("Error: Could not read WAV header\n");
+        close(fd);
+        return false;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // the mapping keeps the file
+    if (map == MAP_FAILED) {
+        printf("Error: Could not map WAV file: %s\n", filename);
+        return false;
+    }
+    audio_data.map = map;
+    audio_data.map_size = (size_t)st.st_size;
     
-    // Allocate memory for samples
-    audio_data.samples = malloc(header.data_size);
-    if (!audio_data.samples) {
-        printf("Error: Could not allocate memory for audio samples\n");
-        fclose(file);
+    const uint8_t *file = map;
+    const size_t size = audio_data.map_size;
+    if (memcmp(file, "RIFF", 4) != 0 || memcmp(file + 8, "WAVE", 4) != 0) {
+        printf("Error: Invalid WAV file format\n");
         return false;
     }
     
-    // Read audio data
-    read_bytes = fread(audio_data.samples, header.data_size, 1, file);
-    if (read_bytes != 1) {
-        printf("Error: Could not read audio data\n");
-        free(audio_data.samples);
-        fclose(file);
+    uint16_t format = 0, channels = 0, block_align = 0, bits = 0;
+    uint32_t rate = 0;
+    bool have_fmt = false;
+    const uint8_t *data = NULL;
+    size_t data_size = 0;
+    for (size_t pos = 12; pos + 8 <= size; ) {
+        const uint8_t *chunk = file + pos;
+        uint32_t chunk_size;
+        memcpy(&chunk_size, chunk + 4, 4);
+        size_t body = size - (pos + 8);
+        if (memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 16 && body >= 16) {
+            memcpy(&format, chunk + 8, 2);
+            memcpy(&channels, chunk + 10, 2);
+            memcpy(&rate, chunk + 12, 4);
+            memcpy(&block_align, chunk + 20, 2);
+            memcpy(&bits, chunk + 22, 2);
+            // WAVE_FORMAT_EXTENSIBLE: the real tag opens the SubFormat GUID
+            if (format == WAV_FORMAT_EXTENSIBLE && chunk_size >= 40 && body >= 40) memcpy(&format, chunk + 32, 2);
+            have_fmt = true;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            data = chunk + 8;
+            // A writer that never patched its sizes leaves 0 (or ~0): take the rest of the file
+            data_size = (chunk_size == 0 || chunk_size > body) ? body : chunk_size;
+            if (have_fmt) break;
+        }
+        pos += 8 + (size_t)chunk_size + (chunk_size & 1);  // chunks are word-aligned
+    }
+    if (!have_fmt || !data) {
+        printf("Error: Invalid WAV file format\n");
         return false;
     }
     
-    fclose(file);
+    // Store audio parameters
+    audio_data.sample_rate = rate;
+    audio_data.channels = channels;
+    audio_data.bits_per_sample = bits;
     
-    // Calculate RMS levels per video frame
-    audio_data.num_frames = (uint32_t)(audio_data.duration_sec * VIS_FPS);
-    audio_data.rms_levels = malloc(audio_data.num_frames * sizeof(float));
-    if (!audio_data.rms_levels) {
-        printf("Error: Could not allocate memory for RMS levels\n");
-        free(audio_data.samples);
+    // 16- and 24-bit PCM or 32-bit float, stereo
+    if (format == WAV_FORMAT_PCM && bits == 16) audio_data.encoding = WAV_S16;
+    else if (format == WAV_FORMAT_PCM && bits == 24) audio_data.encoding = WAV_S24;
+    else if (format == WAV_FORMAT_FLOAT && bits == 32) audio_data.encoding = WAV_F32;
+    else {
+        printf("Error: Only 16/24-bit PCM or 32-bit float stereo WAV files supported\n");
         return false;
     }
-    
-    // Calculate RMS for each video frame
-    uint32_t samples_per_frame = audio_data.sample_rate / VIS_FPS;
-    for (uint32_t frame = 0; frame < audio_data.num_frames; frame++) {
-        uint32_t start_sample = frame * samples_per_frame * audio_data.channels;
-        uint32_t end_sample = start_sample + samples_per_frame * audio_data.channels;
-        
-        if (end_sample > audio_data.sample_count) {
-            end_sample = audio_data.sample_count;
-        }
-        
-        // Calculate RMS for this frame
-        float sum_squares = 0.0f;
-        uint32_t sample_count = 0;
-        
-        for (uint32_t i = start_sample; i < end_sample; i++) {
-            float sample = audio_data.samples[i] / 32768.0f; // Normalize to -1.0 to 1.0
-            sum_squares += sample * sample;
-            sample_count++;
-        }
-        
-        if (sample_count > 0) {
-            audio_data.rms_levels[frame] = sqrtf(sum_squares / sample_count);
-        } else {
-            audio_data.rms_levels[frame] = 0.0f;
-        }
+    audio_data.bytes_per_sample = bits / 8;
+    if (channels != 2 || block_align != 2 * audio_data.bytes_per_sample || rate == 0) {
+        printf("Error: Only 16/24-bit PCM or 32-bit float stereo WAV files supported\n");
+        return false;
     }
     
-    // Try to extract BPM from filename (our audio system outputs BPM info)
-    audio_data.bpm = 120.0f; // Default fallback
+    size_t frames = data_size / block_align;
+    if (frames > UINT32_MAX / 2) frames = UINT32_MAX / 2;
+    audio_data.data = data;
+    audio_data.sample_count = (uint32_t)frames * 2;
+    audio_data.duration_sec = (float)frames / rate;
     
-    printf("Audio analysis complete: %d frames, %.3f avg RMS\n", 
-           audio_data.num_frames, audio_data.rms_levels[0]);
+    // Playback and analysis both read front to back
+    madvise(map, size, MADV_SEQUENTIAL);
+    return true;
+}
+
+// Loop the first `samples` samples (clamped to the file)
+static void set_loop(uint64_t samples, const char *how) {
+    musical_content_samples = samples < audio_data.sample_count ? (uint32_t)samples : audio_data.sample_count;
+    loop_point_samples = 0; // Loop back to the very beginning
     
+    float musical_duration = (float)musical_content_samples / audio_data.channels / audio_data.sample_rate;
+    printf("Musical content: %.2f seconds (%d samples, %s), Full audio: %.2f seconds\n", 
+           musical_duration, musical_content_samples, how, audio_data.duration_sec);
+}
+
+// Open the audio device for the loaded file; playback problems are
+// warnings (the visuals run without sound)
+static bool open_playback(void) {
     // Initialize SDL audio for playback
     if (SDL_WasInit(SDL_INIT_AUDIO) == 0) {
         if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
             printf("Warning: Could not initialize SDL audio: %s\n", SDL_GetError());
-            audio_loaded = true;
             return true; // Continue without audio playback
         }
     }
     
     SDL_AudioSpec want, have;
+    SDL_zero(want);
     want.freq = audio_data.sample_rate;
     want.format = AUDIO_S16SYS;
     want.channels = audio_data.channels;
@@ -193,35 +359,92 @@ bool load_wav_file(const char *filename) {
     want.callback = audio_callback;
     want.userdata = NULL;
     
-    audio_device = SDL_OpenAudioDevice(NULL, 0, &want, &have, 0);
+    // Let the device pick its own rate and convert the file to it as it plays
+    audio_device = SDL_OpenAudioDevice(NULL, 0, &want, &have, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
     if (audio_device == 0) {
         printf("Warning: Could not open audio device: %s\n", SDL_GetError());
-        audio_loaded = true;
+        return true; // Continue without audio playback
+    }
+    if ((uint32_t)have.freq != audio_data.sample_rate && !start_playback_resampler((uint32_t)have.freq)) {
+        printf("Warning: Could not convert audio to %d Hz\n", have.freq);
+        SDL_CloseAudioDevice(audio_device);
+        audio_device = 0;
         return true; // Continue without audio playback
     }
     
     printf("Audio playback initialized: %d Hz, %d channels\n", have.freq, have.channels);
+    return true;
+}
+
+// Map the sidecar next to the WAV if there is one for this file
+static bool map_sidecar(const char *filename) {
+    char path[1024];
+    seg_sidecar_path(filename, path, sizeof(path));
+    if (seg_sidecar_map(&sidecar, path) != 0) return false;
+    // A sidecar from another render of this name is stale: it must match
+    // the WAV's rate and length
+    const uint32_t wav_frames = audio_data.sample_count / audio_data.channels;
+    if (sidecar.hdr->sample_rate != audio_data.sample_rate || sidecar.hdr->wav_frames != wav_frames) {
+        printf("Warning: Ignoring stale %s (%u frames at %u Hz, the WAV is %u at %u Hz)\n", path,
+               sidecar.hdr->wav_frames, sidecar.hdr->sample_rate, wav_frames, audio_data.sample_rate);
+        seg_sidecar_unmap(&sidecar);
+        return false;
+    }
+    printf("Analysis sidecar: %s (seed 0x%llx, %.2f bpm, %u events, RMS at %u fps)\n", path,
+           (unsigned long long)sidecar.hdr->seed, sidecar.hdr->bpm, sidecar.hdr->event_count, sidecar.hdr->fps);
+    return true;
+}
+
+// Load WAV file: map it and its analysis sidecar, or start the analysis
+// thread if there is none.  Nothing here reads or copies the sample data,
+// so startup does not grow with the file.
+bool load_wav_file(const char *filename) {
+    if (!map_wav_file(filename)) {
+        if (audio_data.map) munmap(audio_data.map, audio_data.map_size);
+        memset(&audio_data, 0, sizeof(audio_data));
+        return false;
+    }
     
-    // Calculate musical content length based on BPM and structure  
-    // Our audio system generates 8 bars of music, but let's use a more conservative estimate
-    // The delay tail is probably the last 1.5-2 seconds, so loop the first ~7.5 seconds
-    float musical_duration = audio_data.duration_sec * 0.8f; // Use 80% of total duration
+    printf("WAV Info: %d Hz, %d channels, %d bits, %.2f seconds\n", 
+           audio_data.sample_rate, audio_data.channels, 
+           audio_data.bits_per_sample, audio_data.duration_sec);
     
-    musical_content_samples = (uint32_t)(musical_duration * audio_data.sample_rate * audio_data.channels);
+    audio_data.num_frames = (uint32_t)(audio_data.duration_sec * VIS_FPS);
+    audio_data.bpm = 120.0f; // Default fallback
+    max_rms_scanned = 0;
+    max_rms_seen = 0.0f;
+    have_sidecar = map_sidecar(filename);
+    if (have_sidecar) {
+        audio_data.bpm = sidecar.hdr->bpm;
+        audio_loaded = true;
+        set_loop(sidecar.hdr->loop_frames * 2ull, "one segment, from the sidecar");
+        return open_playback();
+    }
     
-    // Make sure we don't exceed the actual audio length
-    if (musical_content_samples > audio_data.sample_count) {
-        musical_content_samples = audio_data.sample_count;
+    // RMS levels per video frame, computed off the main thread
+    audio_data.rms_levels = calloc(audio_data.num_frames ? audio_data.num_frames : 1, sizeof(float));
+    if (!audio_data.rms_levels) {
+        printf("Error: Could not allocate memory for RMS levels\n");
+        munmap(audio_data.map, audio_data.map_size);
+        memset(&audio_data, 0, sizeof(audio_data));
+        return false;
+    }
+    SDL_AtomicSet(&rms_ready, 0);
+    SDL_AtomicSet(&rms_stop, 0);
+    rms_thread = SDL_CreateThread(rms_thread_main, "wav_rms", NULL);
+    if (!rms_thread) {
+        printf("Warning: No analysis thread (%s), computing RMS per frame\n", SDL_GetError());
     }
     
-    loop_point_samples = 0; // Loop back to the very beginning
+    printf("Audio mapped: %d frames, RMS analysis running ahead of playback\n", audio_data.num_frames);
+    audio_loaded = true;
     
-    printf("Musical content: %.2f seconds (%d samples), Full audio: %.2f seconds\n", 
-           musical_duration, musical_content_samples, audio_data.duration_sec);
+    // Without a sidecar the segment length is unknown: the delay tail is
+    // probably the last 1.5-2 seconds, so loop the first 80%
+    set_loop((uint64_t)(audio_data.duration_sec * 0.8f * audio_data.sample_rate) * audio_data.channels,
+             "estimated");
     printf("Will loop musical content, letting delay tail ring through naturally\n");
-    
-    audio_loaded = true;
-    return true;
+    return open_playback();
 }
 
 // Get RMS level for a specific frame (with looping)
@@ -237,11 +460,11 @@ float get_audio_rms_for_frame(int frame) {
     if (musical_frames > 0 && musical_frames < (int)audio_data.num_frames) {
         // Loop only the musical content frames
         int looped_frame = frame % musical_frames;
-        return audio_data.rms_levels[looped_frame];
+        return frame_rms((uint32_t)looped_frame);
     } else {
         // Fallback to full audio loop
         int looped_frame = frame % audio_data.num_frames;
-        return audio_data.rms_levels[looped_frame];
+        return frame_rms((uint32_t)looped_frame);
     }
 }
 
@@ -267,17 +490,46 @@ bool is_audio_finished(int frame) {
     return frame >= (int)audio_data.num_frames;
 }
 
-// Get max RMS for normalization
+// Get max RMS for normalization: over the frames analysed so far (the
+// whole file once the analysis thread finishes), folded in incrementally
 float get_max_rms(void) {
     if (!audio_loaded) return 1.0f;
+    if (have_sidecar) return sidecar.hdr->rms_max > 0.0f ? sidecar.hdr->rms_max : 1.0f;
     
-    float max_rms = 0.0f;
-    for (uint32_t i = 0; i < audio_data.num_frames; i++) {
-        if (audio_data.rms_levels[i] > max_rms) {
-            max_rms = audio_data.rms_levels[i];
+    uint32_t ready = (uint32_t)SDL_AtomicGet(&rms_ready);
+    for (; max_rms_scanned < ready; max_rms_scanned++) {
+        if (audio_data.rms_levels[max_rms_scanned] > max_rms_seen) {
+            max_rms_seen = audio_data.rms_levels[max_rms_scanned];
         }
     }
-    return max_rms > 0.0f ? max_rms : 1.0f;
+    return max_rms_seen > 0.0f ? max_rms_seen : 1.0f;
+}
+
+// Get the seed the file was rendered from (the sidecar's), or `fallback`
+uint32_t get_audio_seed(uint32_t fallback) {
+    return (audio_loaded && have_sidecar) ? (uint32_t)sidecar.hdr->seed : fallback;
+}
+
+// Get the step of the segment being played, from the playback position; -1
+// without a sidecar or without playback (callers then count steps by time)
+int get_audio_step(void) {
+    if (!audio_loaded || !have_sidecar || audio_device == 0 || sidecar.hdr->step_frames <= 0.0f) return -1;
+    uint32_t frame = audio_position / audio_data.channels;
+    if (sidecar.hdr->loop_frames) frame %= sidecar.hdr->loop_frames;
+    uint32_t step = (uint32_t)(frame / sidecar.hdr->step_frames);
+    return (int)(step < sidecar.hdr->steps ? step : sidecar.hdr->steps - 1);
+}
+
+// Count the events of `type` (event_type_t) that fire on `step` of the
+// segment; -1 without a sidecar
+int get_audio_step_events(int step, int type) {
+    if (!audio_loaded || !have_sidecar) return -1;
+    uint32_t s = (uint32_t)step % sidecar.hdr->steps;
+    int count = 0;
+    for (uint32_t i = sidecar.step_start[s]; i < sidecar.step_start[s + 1]; i++) {
+        if (sidecar.events[i].type == type) count++;
+    }
+    return count;
 }
 
 // Start audio playback
@@ -310,9 +562,25 @@ void cleanup_audio_data(void) {
         audio_device = 0;
     }
     
+    if (playback_rs_active) {
+        resampler_free(&playback_rs);
+        free(rs_in); free(rs_out);
+        rs_in = rs_out = NULL;
+        playback_rs_active = false;
+    }
+    
     if (audio_loaded) {
-        free(audio_data.samples);
+        if (rms_thread) {
+            SDL_AtomicSet(&rms_stop, 1);
+            SDL_WaitThread(rms_thread, NULL);
+            rms_thread = NULL;
+        }
+        munmap(audio_data.map, audio_data.map_size);
         free(audio_data.rms_levels);
+        if (have_sidecar) {
+            seg_sidecar_unmap(&sidecar);
+            have_sidecar = false;
+        }
         memset(&audio_data, 0, sizeof(audio_data));
         audio_loaded = false;
     }
@@ -330,7 +598,7 @@ void print_audio_info(void) {
     printf("Sample Rate: %d Hz\n", audio_data.sample_rate);
     printf("Channels: %d\n", audio_data.channels);
     printf("Video Frames: %d\n", audio_data.num_frames);
-    printf("Max RMS: %.3f\n", get_max_rms());
+    printf("Max RMS: %.3f%s\n", get_max_rms(), have_sidecar ? "" : " (analysed so far)");
     printf("BPM: %.1f\n", audio_data.bpm);
     printf("=====================\n");
 }